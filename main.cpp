@@ -1,16 +1,31 @@
 #include "Prelude.hpp"
+#include "SFML/System/Angle.hpp"
 #include "prefabs/Bullet.hpp"
 #include "prefabs/DialogBox.hpp"
 #include "prefabs/Banner.hpp"
 #include "prefabs/Mob.hpp"
 #include "prefabs/Player.hpp"
 #include "prefabs/Root.hpp"
+#include "systems/LightingControl.hpp"
 #include "systems/MusicControl.hpp"
 #include "utils/DialogGenerator.hpp"
+#include "utils/TileMapConverter.hpp"
 #include "prefabs/SimpleMapLayer.hpp"
 #include "components/SceneTree.hpp"
+#include "components/Pool.hpp"
 #include "prefabs/SplashScreen.hpp"
 
+#ifdef GAME_BUILD_TESTS
+#include "MovementBenchmarks.hpp"
+#include "SceneTreeBenchmarks.hpp"
+#include "SystemBenchmarks.hpp"
+#include "SceneTreeTests.hpp"
+#include "TileMapTests.hpp"
+#include "TimelineTests.hpp"
+#include "TimerWheelTests.hpp"
+#include "TweenTests.hpp"
+#endif
+
 void onPlayerDeath(game::prefab::EOnPlayerDeathEvent e) {
     game::prefab::DialogBox dialogBox = game::prefab::DialogBox::create();
     auto dialogs = game::DialogGenerator()
@@ -21,16 +36,21 @@ void onPlayerDeath(game::prefab::EOnPlayerDeathEvent e) {
 }
 
 void cleanMobBullets() {
-    for (auto entity : game::getRegistry().view<game::prefab::GBulletComponent>()) {
+    // queued together, SSceneUnmountSystem takes them down in a single batch.
+    for (auto entity : game::getRegistry().view<game::prefab::GBulletComponent>(entt::exclude<game::CPooled>)) {
         game::UnmountUtils::queueUnmount(entity);
     }
 }
 
 void makeMobs() {
     auto& root = game::getRegistry().ctx().get<game::prefab::Root>();
-    for (int i = 0; i < static_cast<int>(game::random(12, 16)); i++) {
-        game::prefab::Mob mob = game::prefab::Mob::create(game::random({-512.f, -512.f}, { 512.f, 512.f }));
-        root.mountChild(mob.getEntity());
+
+    std::vector<sf::Vector2f> positions(static_cast<size_t>(game::random(12, 16)));
+    for (auto& position : positions) {
+        position = game::random({-512.f, -512.f}, { 512.f, 512.f });
+    }
+    for (const auto mob : game::prefab::Mob::createBatch(positions)) {
+        root.mountChild(mob);
     }
 }
 
@@ -38,7 +58,7 @@ void onDialogCompleted(game::prefab::EOnDialogBoxCompletedEvent e) {
     static bool shouldClose = false;
 
     if (shouldClose) {
-        game::getGame().getWindow().getRawWindow()->close();
+        game::getGame().getWindow().close();
     } else {
         shouldClose = true;
     }
@@ -105,7 +125,167 @@ void onSplashScreenCompleted(game::prefab::EOnSplashScreenCompletedEvent e) {
     dialogBox.setVisibility(true);
 }
 
-int main() {
+/**
+ * the scene rendered by --capture: the map, the player, a ring of mobs and a burst of bullets.
+ * there is no splash screen or dialog to wait for, and nothing is placed at random,
+ * so every capture starts from the same frame.
+ */
+void makeCaptureScene() {
+    constexpr size_t mobCount = 16;
+    constexpr float mobRingRadius = 384.f;
+    constexpr size_t bulletCount = 256;
+    constexpr float bulletRingRadius = 128.f;
+    constexpr float bulletSpeed = 96.f;
+
+    auto& root = game::getRegistry().ctx().get<game::prefab::Root>();
+
+    game::prefab::SimpleMapLayer::create(0);
+    game::prefab::SimpleMapLayer::create(96);
+
+    game::prefab::Player player = game::prefab::Player::create();
+    root.mountChild(player.getEntity());
+
+    std::vector<sf::Vector2f> positions(mobCount);
+    for (size_t i = 0; i < mobCount; i++) {
+        positions[i] = sf::Vector2f(mobRingRadius, sf::degrees(360.f * static_cast<float>(i) / mobCount));
+    }
+    for (const auto mob : game::prefab::Mob::createBatch(positions)) {
+        root.mountChild(mob);
+    }
+
+    // every bullet carries a light, they head outwards from around the player.
+    for (size_t i = 0; i < bulletCount; i++) {
+        const sf::Vector2f direction(1.f, sf::degrees(360.f * static_cast<float>(i) / bulletCount));
+        game::prefab::Bullet bullet = game::prefab::Bullet::create(direction * bulletRingRadius, direction, bulletSpeed);
+        root.mountChild(bullet.getEntity());
+    }
+}
+
+/**
+ * --capture <frames> <image.png> [timings.csv]
+ * renders the given number of frames offscreen instead of opening a window.
+ */
+std::optional<game::OffscreenCapture> parseCaptureArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) != "--capture") {
+            continue;
+        }
+        if (i + 2 >= argc) {
+            throw std::runtime_error("Usage: --capture <frames> <image.png> [timings.csv]");
+        }
+
+        game::OffscreenCapture capture;
+        capture.frameCount = static_cast<uint32_t>(std::stoul(argv[i + 1]));
+        capture.imagePath = argv[i + 2];
+        if (i + 3 < argc && std::string(argv[i + 3]).rfind("--", 0) != 0) {
+            capture.timingsPath = argv[i + 3];
+        }
+        return capture;
+    }
+    return std::nullopt;
+}
+
+/**
+ * --lighting <forward|tiled>
+ * selects the lighting backend, forward when not given.
+ */
+std::optional<game::LightingBackend> parseLightingArgument(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) != "--lighting") {
+            continue;
+        }
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Usage: --lighting <forward|tiled>");
+        }
+
+        const std::string backend = argv[i + 1];
+        if (backend == "forward") {
+            return game::LightingBackend::Forward;
+        }
+        if (backend == "tiled") {
+            return game::LightingBackend::Tiled;
+        }
+        throw std::runtime_error("Unknown lighting backend: " + backend);
+    }
+    return std::nullopt;
+}
+
+/**
+ * --convert-map <image.png> <tile size> <map.gtmp>
+ * cuts a map image into square tiles and writes it as a tile map, see TileMapConverter.
+ * @return false if the argument is not given
+ */
+bool convertMap(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) != "--convert-map") {
+            continue;
+        }
+        if (i + 3 >= argc) {
+            throw std::runtime_error("Usage: --convert-map <image.png> <tile size> <map.gtmp>");
+        }
+
+        game::Game::createGame();
+        const auto tileSize = static_cast<uint32_t>(std::stoul(argv[i + 2]));
+        const auto tileCount = game::TileMapConverter::convert(argv[i + 1], { tileSize, tileSize }, argv[i + 3]);
+        game::getLogger().logInfo("Converted " + std::string(argv[i + 1]) + " into " + std::string(argv[i + 3])
+            + ", " + std::to_string(tileCount) + " distinct tiles");
+        return true;
+    }
+    return false;
+}
+
+#ifdef GAME_BUILD_TESTS
+/**
+ * --run-tests
+ * @return the exit code, stops at the first failed check
+ */
+int runTests() {
+    try {
+        testSceneTree();
+        testTileMap();
+        testTimerWheel();
+        testTweens();
+        testTimelines();
+    } catch (const std::exception& e) {
+        game::getLogger().logError("Test failed: " + std::string(e.what()));
+        return 1;
+    }
+    game::getLogger().logInfo("All tests passed");
+    return 0;
+}
+#endif
+
+int main(int argc, char** argv) {
+#ifdef GAME_BUILD_TESTS
+    for (int i = 1; i < argc; i++) {
+        if (std::string(argv[i]) == "--run-tests") {
+            game::Game::createGame();
+            return runTests();
+        }
+        if (std::string(argv[i]) == "--benchmark-scene") {
+            game::Game::createGame();
+            benchmarkSceneTree();
+            benchmarkMovement();
+            benchmarkSystems();
+            return 0;
+        }
+    }
+#endif
+
+    if (convertMap(argc, argv)) {
+        return 0;
+    }
+
+    const auto capture = parseCaptureArguments(argc, argv);
+    if (capture.has_value()) {
+        // the same scene on every capture.
+        game::setRandomSeed(25);
+    }
+
+    if (const auto lighting = parseLightingArgument(argc, argv); lighting.has_value()) {
+        game::SLightingSystem::setBackend(lighting.value());
+    }
+
     game::Game& game = game::Game::createGame();
     game.setConfig({.windowTitle = "Game - C++ 25sp", .fps = 60, .vsync = false});
 
@@ -114,6 +294,11 @@ int main() {
 
     game.getWindow().setZoomFactor(0.5f);
 
+    if (capture.has_value()) {
+        makeCaptureScene();
+        return game.runOffscreen(capture.value()) ? 0 : 1;
+    }
+
     game::prefab::SplashScreen splashScreen = game::prefab::SplashScreen::create();
 
     auto& eventDispatcher = game::getEventDispatcher();
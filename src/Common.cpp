@@ -4,6 +4,7 @@
 
 #include "Common.hpp"
 
+#include <mutex>
 #include <random>
 #include <cmath>
 
@@ -34,11 +35,35 @@ namespace game {
         return getGame().getEventDispatcher();
     }
 
+    TimerWheel& getTimerWheel() {
+        return getGame().getTimerWheel();
+    }
+
+    TweenEngine& getTweenEngine() {
+        return getGame().getTweenEngine();
+    }
+
+    namespace {
+        std::mt19937& getRandomEngine() {
+            static std::mt19937 engine { std::random_device {}() };
+            return engine;
+        }
+
+        std::mutex& getRandomMutex() {
+            static std::mutex mutex;
+            return mutex;
+        }
+    }
+
+    void setRandomSeed(uint32_t seed) {
+        std::scoped_lock lock(getRandomMutex());
+        getRandomEngine().seed(seed);
+    }
+
     float random(float min, float max) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
         std::uniform_real_distribution dis(min, max);
-        return dis(gen);
+        std::scoped_lock lock(getRandomMutex());
+        return dis(getRandomEngine());
     }
 
     sf::Vector2f random(sf::Vector2f min, sf::Vector2f max) {
@@ -4,6 +4,7 @@
 
 #ifndef COMMON_HPP
 #define COMMON_HPP
+#include <cstdint>
 #include <optional>
 #include <entt/entity/registry.hpp>
 
@@ -15,6 +16,8 @@ namespace game {
     class Game;
     class Logger;
     class ThreadPool;
+    class TimerWheel;
+    class TweenEngine;
     struct ResourceManager;
 
     Game& getGame();
@@ -26,8 +29,17 @@ namespace game {
 
     entt::dispatcher& getEventDispatcher();
 
+    TimerWheel& getTimerWheel();
+
+    TweenEngine& getTweenEngine();
+
     sf::String cropString(const sf::String& str, size_t beginOffset, size_t endOffset);
 
+    /**
+     * Makes the random functions below reproducible, e.g. for offscreen captures.
+     * They are seeded from std::random_device until this is called.
+     */
+    void setRandomSeed(uint32_t seed);
     float random(float min, float max);
     sf::Vector2f random(sf::Vector2f min, sf::Vector2f max);
     sf::Vector2f random(sf::Vector2f max);
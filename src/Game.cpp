@@ -7,7 +7,12 @@
 #include "Common.hpp"
 #include "Logger.hpp"
 #include "ThreadPool.hpp"
+#include "utils/TimerWheel.hpp"
+#include "utils/TweenEngine.hpp"
 #include "Window.hpp"
+#include "systems/CollisionControl.hpp"
+#include "systems/MovementControl.hpp"
+#include "systems/RenderControl.hpp"
 
 game::Game::Game() {
     m_hardwareConcurrency = std::thread::hardware_concurrency();
@@ -42,11 +47,29 @@ void game::Game::init() {
 
     logger.logInfo("Initializing keyboard utilities");
     ctx.emplace<KeyBoard>();
+
+    logger.logInfo("Initializing timers");
+    ctx.emplace<TimerWheel>();
+
+    logger.logInfo("Initializing tweens");
+    ctx.emplace<TweenEngine>();
+
+    logger.logInfo("Initializing render dispatch");
+    SRenderSystem::init();
+
+    // the groups own their storages from the start, so nothing has to be packed later on.
+    logger.logInfo("Initializing movement");
+    SMovementSystem::init();
+
+    logger.logInfo("Initializing collision");
+    SCollisionSystem::init();
 }
 
 void game::Game::cleanup() {
     auto& ctx = m_registry.ctx();
 
+    ctx.erase<TweenEngine>();
+    ctx.erase<TimerWheel>();
     ctx.erase<KeyBoard>();
     ctx.erase<Window>();
     ctx.erase<ResourceManager>();
@@ -125,6 +148,16 @@ void game::Game::run() {
     });
 }
 
+bool game::Game::runOffscreen(const OffscreenCapture& capture) {
+    getLogger().logInfo("Starting game offscreen");
+    auto& window = getWindow();
+
+    window.setWindowSize(m_config.windowSize);
+    window.setWindowTitle(m_config.windowTitle);
+
+    return window.runOffscreen(capture);
+}
+
 entt::registry& game::Game::getRegistry() {
     return m_registry;
 }
@@ -145,6 +178,14 @@ entt::dispatcher& game::Game::getEventDispatcher() {
     return m_dispatcher;
 }
 
+game::TimerWheel& game::Game::getTimerWheel() {
+    return m_registry.ctx().get<TimerWheel>();
+}
+
+game::TweenEngine& game::Game::getTweenEngine() {
+    return m_registry.ctx().get<TweenEngine>();
+}
+
 game::Game::KeyBoard& game::Game::getKeyboard() {
     return m_registry.ctx().get<KeyBoard>();
 }
@@ -15,7 +15,10 @@
 namespace game {
     class Logger;
     class ThreadPool;
+    class TimerWheel;
+    class TweenEngine;
     class Window;
+    struct OffscreenCapture;
 
     class Game {
         friend class Window;
@@ -50,6 +53,12 @@ namespace game {
 
         void run();
 
+        /**
+         * Same as run(), but renders into an image instead of a window, see Window::runOffscreen().
+         * @return false if the capture could not be written
+         */
+        bool runOffscreen(const OffscreenCapture& capture);
+
         entt::registry& getRegistry();
 
         Logger& getLogger();
@@ -60,6 +69,10 @@ namespace game {
 
         entt::dispatcher& getEventDispatcher();
 
+        TimerWheel& getTimerWheel();
+
+        TweenEngine& getTweenEngine();
+
         KeyBoard& getKeyboard();
 
         static Game& getInstance();
@@ -4,6 +4,8 @@
 
 #include "ThreadPool.hpp"
 
+#include <algorithm>
+
 #include "Common.hpp"
 #include "Logger.hpp"
 
@@ -13,8 +15,12 @@ game::ThreadPool::~ThreadPool() {
 
 void game::ThreadPool::close() {
     getLogger().logDebug("ThreadPool::close()");
-    if (!m_cancellationToken.exchange(false, std::memory_order_acq_rel)) {
-        return;
+    {
+        // flipped under the lock, so that no executor can miss it between its check and its wait.
+        std::scoped_lock lock(m_tasksMutex);
+        if (!m_cancellationToken.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
     }
 
     m_cv.notify_all();
@@ -26,41 +32,93 @@ void game::ThreadPool::close() {
 void game::ThreadPool::syncWait(Task&& task) {
     std::mutex waitMutex;
     std::condition_variable waitCond;
-    std::atomic<bool> waitFlag = false;
+    bool isDone = false;
 
     schedule([&]() {
         task.run();
-        waitFlag.store(true, std::memory_order_release);
+        // set and notify under the lock, as in waitForAll().
+        std::scoped_lock lock(waitMutex);
+        isDone = true;
         waitCond.notify_one();
     });
 
     std::unique_lock waitLock(waitMutex);
-    waitCond.wait(waitLock, [&]() { return waitFlag.load(std::memory_order_acquire); });
+    waitCond.wait(waitLock, [&isDone]() { return isDone; });
 }
 
 void game::ThreadPool::waitForAll(const std::vector<Task>& tasks) {
     std::mutex waitMutex;
     std::condition_variable waitCond;
-    std::atomic<int> waitCount = 0;
+    size_t waitCount = 0;
     size_t taskCount = tasks.size();
 
     for (auto& task : tasks) {
         // explicit better than implicit
         schedule([&waitMutex, &waitCond, &waitCount, task, taskCount]() {
             task.run();
-            if (waitCount.fetch_add(1, std::memory_order_acq_rel) == taskCount - 1) {
+            // count and notify under the lock, otherwise the waiting side may return
+            // and destroy the condition variable before we touch it.
+            std::scoped_lock lock(waitMutex);
+            if (++waitCount == taskCount) {
                 waitCond.notify_one();
             }
         });
     }
     std::unique_lock<std::mutex> waitLock(waitMutex);
-    waitCond.wait(waitLock, [&waitCount, taskCount]() { return waitCount.load(std::memory_order_acquire) == taskCount; });
+    waitCond.wait(waitLock, [&waitCount, taskCount]() { return waitCount == taskCount; });
 }
 
-void game::ThreadPool::schedule(const Task& task) {
-    std::unique_lock lock(m_tasksMutex);
-    m_tasks.push_back(task);
+void game::ThreadPool::parallelFor(size_t begin, size_t end, size_t minBatchSize,
+                                   const std::function<void(size_t, size_t)>& fn) {
+    if (begin >= end) {
+        return;
+    }
+
+    const size_t count = end - begin;
+    const size_t batchSize = std::max<size_t>(minBatchSize, 1);
+    // the calling thread works as well, hence the plus one.
+    const size_t batchCount = std::min<size_t>((count + batchSize - 1) / batchSize, static_cast<size_t>(m_threadCount) + 1);
+
+    if (batchCount <= 1 || m_threads.empty()) {
+        fn(begin, end);
+        return;
+    }
+
+    const size_t step = (count + batchCount - 1) / batchCount;
 
+    std::mutex waitMutex;
+    std::condition_variable waitCond;
+    size_t pending = 0;
+
+    size_t batchBegin = begin;
+    for (; batchBegin + step < end; batchBegin += step) {
+        {
+            std::scoped_lock lock(waitMutex);
+            pending++;
+        }
+        const size_t batchEnd = batchBegin + step;
+        schedule([&waitMutex, &waitCond, &pending, &fn, batchBegin, batchEnd]() {
+            fn(batchBegin, batchEnd);
+            std::scoped_lock lock(waitMutex);
+            if (--pending == 0) {
+                waitCond.notify_one();
+            }
+        });
+    }
+
+    fn(batchBegin, end);
+
+    std::unique_lock waitLock(waitMutex);
+    waitCond.wait(waitLock, [&pending]() { return pending == 0; });
+}
+
+void game::ThreadPool::schedule(const Task& task) {
+    {
+        // the executors check for tasks under the same lock,
+        // so the notification can't slip in between their check and their wait.
+        std::scoped_lock lock(m_tasksMutex);
+        m_tasks.push_back(task);
+    }
     m_cv.notify_one();
 }
 
@@ -69,6 +127,7 @@ void game::ThreadPool::schedule(std::function<void()> task) {
 }
 
 bool game::ThreadPool::isBusy() const {
+    std::scoped_lock lock(m_tasksMutex);
     return !m_tasks.empty();
 }
 
@@ -83,39 +142,20 @@ void game::ThreadPool::run() {
 }
 
 void game::ThreadPool::executor() {
-    while (m_cancellationToken.load(std::memory_order_acquire)) {
+    while (true) {
+        Task task;
         {
-            std::unique_lock<std::mutex> lock(m_waitMutex);
+            // every access to m_tasks goes through m_tasksMutex.
+            std::unique_lock lock(m_tasksMutex);
             m_cv.wait(lock, [this] { return !m_tasks.empty() || !m_cancellationToken.load(std::memory_order_relaxed); });
-        }
-
-        if (!m_cancellationToken.load(std::memory_order_acquire)) {
-            while (!m_tasks.empty()) {
-                Task task;
-                {
-                    std::scoped_lock scopedLock(m_tasksMutex);
-
-                    // in case that fake waking up occurred.
-                    if (!m_tasks.empty()) {
-                        task = m_tasks.front();
-                        m_tasks.pop_front();
-                    }
-                }
-                task.run();
-            }
-            return;
-        }
 
-        while (!m_tasks.empty()) {
-            Task task;
-            {
-                std::scoped_lock scopedLock(m_tasksMutex);
-                if (!m_tasks.empty()) {
-                    task = m_tasks.front();
-                    m_tasks.pop_front();
-                }
+            // once closed, the queued tasks are still run before leaving.
+            if (m_tasks.empty()) {
+                return;
             }
-            task.run();
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
         }
+        task.run();
     }
 }
@@ -67,6 +67,16 @@ namespace game {
 
         [[nodiscard]] bool isBusy() const;
 
+        [[nodiscard]] uint32_t getThreadCount() const { return m_threadCount; }
+
+        /**
+         * Splits [begin, end) into batches of at least minBatchSize and runs fn(batchBegin, batchEnd)
+         * on the pool, the calling thread takes the last batch itself.
+         * Blocks until every batch is done. Falls back to a plain call when there is nothing to split.
+         * Do not call this from inside a pool task.
+         */
+        void parallelFor(size_t begin, size_t end, size_t minBatchSize, const std::function<void(size_t, size_t)>& fn);
+
         template <typename Fn, std::enable_if_t<std::is_invocable_v<Fn>>>
         void schedule(Fn&& task) {
             schedule(std::function<void()>(std::forward<Fn>(task)));
@@ -76,11 +86,11 @@ namespace game {
 
     private:
         uint32_t m_threadCount { 4 };
-        std::mutex m_waitMutex;
         std::condition_variable m_cv;
         std::vector<std::thread> m_threads;
 
-        std::mutex m_tasksMutex;
+        // guards m_tasks, and is the lock m_cv waits on.
+        mutable std::mutex m_tasksMutex;
         std::deque<Task> m_tasks;
         std::atomic<bool> m_cancellationToken { false };
 
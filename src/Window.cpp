@@ -4,6 +4,9 @@
 
 #include "Window.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include "Common.hpp"
 #include "Game.hpp"
 #include "Logger.hpp"
@@ -14,12 +17,15 @@
 #include "systems/RenderControl.hpp"
 #include "systems/SceneControl.hpp"
 #include "systems/ScriptsControl.hpp"
+#include "systems/TileStreamingControl.hpp"
 #include "systems/TweeningControl.hpp"
 #include "systems/LightingControl.hpp"
+#include "utils/PassProfiler.hpp"
+#include "utils/TimerWheel.hpp"
 
 namespace game {
     void Window::setVideoPreferences(const int fps, const bool vsync) {
-        m_videoPreference = { fps, vsync, m_videoPreference.zoomFactor };
+        m_videoPreference = { fps, vsync, m_videoPreference.zoomFactor, m_videoPreference.lightmapDownscale };
         if (m_window != nullptr) {
             m_window->setFramerateLimit(fps);
             m_window->setVerticalSyncEnabled(vsync);
@@ -30,6 +36,14 @@ namespace game {
         getLogger().logInfo("Video preferences set to: " + std::to_string(fps) + " fps, " + (vsync ? "using" : "not using") + " vsync");
     }
 
+    void Window::setSmallMapRefreshRate(float refreshRate) {
+        if (refreshRate <= 0.f) {
+            getLogger().logWarn("Small map refresh rate must be positive, falling back to 10.");
+            refreshRate = 10.f;
+        }
+        m_misc.smallMapRefreshRate = refreshRate;
+    }
+
     void Window::setWindowTitle(sf::String title) {
         m_windowTitle = std::move(title);
     }
@@ -38,9 +52,97 @@ namespace game {
         m_windowSize = windowSize;
     }
 
+    struct Window::RenderPipeline {
+        RenderPipeline(const sf::Vector2u windowSize, const uint32_t lightmapDownscale)
+            : windowSize(windowSize),
+            lightmapSize {
+                std::max(1u, windowSize.x / lightmapDownscale),
+                std::max(1u, windowSize.y / lightmapDownscale)
+            },
+            gameComponents(windowSize),
+            ui(windowSize),
+            illumination(lightmapSize),
+            ambientIllumination(windowSize),
+            primaryOutput(windowSize),
+            pixelated(windowSize),
+            uiPixelated(windowSize),
+            postProcessingCrt(windowSize),
+            uiPostProcessingCrt(windowSize),
+            postProcessingBloomBrightness(windowSize),
+            postProcessingBloomBlurV(windowSize),
+            postProcessingBloomBlurH(windowSize),
+            smallMapOutput(smallMapSize),
+            smallMapStatic(smallMapSize * SMALL_MAP_CACHE_SCALE),
+            smallMapShape(sf::Vector2f(smallMapSize)),
+            finalOutput(windowSize) {
+            // bilinear upsampling when the lightmap is composited
+            illumination.setSmooth(true);
+
+            smallMapShape.setTexture(&smallMapOutput.getTexture());
+            smallMapShape.setOutlineColor(sf::Color{32, 32, 96});
+            smallMapShape.setOutlineThickness(2.f);
+            smallMapShape.setPosition(sf::Vector2f{static_cast<float>(windowSize.x) * 0.05f,
+                                                   static_cast<float>(windowSize.y) * 0.05f});
+
+            pixelShader = ResourceManager::getShaderCache()
+                    .load(entt::hashed_string { "pixelShader" }, "assets/shader/common.vert", "assets/shader/pixel.frag").first->second;
+            crtShader = ResourceManager::getShaderCache()
+                    .load(entt::hashed_string { "crtShader" }, "assets/shader/common.vert", "assets/shader/crt.frag").first->second;
+            bloomShader = ResourceManager::getShaderCache()
+                    .load(entt::hashed_string { "bloomBrightness" }, "assets/shader/common.vert", "assets/shader/bloom/brightness.frag").first->second;
+            bloomBlurShader = ResourceManager::getShaderCache()
+                    .load(entt::hashed_string { "bloomBlur" }, "assets/shader/common.vert", "assets/shader/bloom/gaussian.frag").first->second;
+        }
+
+        sf::Vector2u windowSize;
+        sf::Vector2u lightmapSize;
+
+        sf::RenderTexture gameComponents;
+        sf::RenderTexture ui;
+        sf::RenderTexture illumination;
+        sf::RenderTexture ambientIllumination;
+        sf::RenderTexture primaryOutput;
+
+        sf::RenderTexture pixelated;
+        sf::RenderTexture uiPixelated;
+
+        sf::RenderTexture postProcessingCrt;
+        sf::RenderTexture uiPostProcessingCrt;
+
+        sf::RenderTexture postProcessingBloomBrightness;
+        sf::RenderTexture postProcessingBloomBlurV;
+        sf::RenderTexture postProcessingBloomBlurH;
+
+        // the small map is rendered at its on-screen size.
+        static constexpr sf::Vector2u smallMapSize { SMALL_MAP_RESOLUTION, SMALL_MAP_RESOLUTION };
+        static constexpr float smallMapCacheExtent = SMALL_MAP_VIEW_EXTENT * static_cast<float>(SMALL_MAP_CACHE_SCALE);
+        sf::RenderTexture smallMapOutput;
+        sf::RenderTexture smallMapStatic;
+        sf::Vector2f smallMapCacheCenter;
+        sf::Time smallMapSinceRefresh;
+        sf::Time smallMapPendingDeltaTime;
+        bool smallMapWasVisible = false;
+        sf::RectangleShape smallMapShape;
+
+        sf::RenderTexture finalOutput;
+
+        entt::resource<sf::Shader> pixelShader;
+        entt::resource<sf::Shader> crtShader;
+        entt::resource<sf::Shader> bloomShader;
+        entt::resource<sf::Shader> bloomBlurShader;
+
+        sf::Clock crtScanlineClock;
+        // fixed time steps in offscreen runs make the scanlines reproducible too.
+        sf::Time crtScanlineTime;
+        bool useFixedScanlineTime = false;
+
+        PassProfiler profiler;
+    };
+
     void Window::run() {
         m_window = std::make_unique<sf::RenderWindow>(sf::VideoMode(m_windowSize), m_windowTitle);
         setVideoPreferences(m_videoPreference.fps, m_videoPreference.vsync);
+        m_misc.closeRequested = false;
 
         m_logicalView = m_window->getView();
         m_logicalView.setCenter({0, 0}); // place the view at the center of the window
@@ -63,38 +165,7 @@ namespace game {
         sf::Clock internalClock;
         internalClock.start();
 
-        sf::Clock crtScanlineClock;
-        crtScanlineClock.start();
-
-        sf::RenderTexture gameComponents(m_windowSize);
-        sf::RenderTexture ui(m_windowSize);
-        sf::RenderTexture illumination(m_windowSize);
-        sf::RenderTexture ambientIllumination(m_windowSize);
-        sf::RenderTexture primaryOutput(m_windowSize);
-
-        sf::RenderTexture pixelated(m_windowSize);
-        sf::RenderTexture uiPixelated(m_windowSize);
-
-        sf::RenderTexture postProcessingCrt(m_windowSize);
-        sf::RenderTexture uiPostProcessingCrt(m_windowSize);
-
-        sf::RenderTexture postProcessingBloomBrightness(m_windowSize);
-        sf::RenderTexture postProcessingBloomBlurV(m_windowSize);
-        sf::RenderTexture postProcessingBloomBlurH(m_windowSize);
-
-        sf::RenderTexture smallMapOutput(m_windowSize);
-        sf::RenderTexture finalOutput(m_windowSize);
-
-        entt::resource<sf::Shader> pixelShader = ResourceManager::getShaderCache()
-                .load(entt::hashed_string { "pixelShader" }, "assets/shader/common.vert", "assets/shader/pixel.frag").first->second;
-        entt::resource<sf::Shader> crtShader = ResourceManager::getShaderCache()
-                .load(entt::hashed_string { "crtShader" }, "assets/shader/common.vert", "assets/shader/crt.frag").first->second;
-        entt::resource<sf::Shader> bloomShader = ResourceManager::getShaderCache()
-                .load(entt::hashed_string { "bloomBrightness" }, "assets/shader/common.vert", "assets/shader/bloom/brightness.frag").first->second;
-        entt::resource<sf::Shader> bloomBlurShader = ResourceManager::getShaderCache()
-                .load(entt::hashed_string { "bloomBlur" }, "assets/shader/common.vert", "assets/shader/bloom/gaussian.frag").first->second;
-
-        constexpr sf::Color ambientIlluminationColor(255, 255, 255, 160);
+        RenderPipeline pipeline(m_windowSize, m_videoPreference.lightmapDownscale);
 
         while (m_window->isOpen()) {
             while (auto event = m_window->pollEvent()) {
@@ -122,153 +193,10 @@ namespace game {
             deltaTime *= timeScale;
 
             // DO NOT write the logic in event polling loop!!
-            SScriptsSystem::update(deltaTime);
-
-            SMovementSystem::update(deltaTime);
-            SScenePositionUpdateSystem::update();
-            SCollisionSystem::update(deltaTime);
-            STweenSystem::update(deltaTime);
-
-            SMusicSystem::update();
+            updateLogic(deltaTime);
 
-            // --- render pipeline --- //
-
-            auto zoomedView = m_logicalView;
-            zoomedView.zoom(m_videoPreference.zoomFactor);
-
-            auto smallMapView = sf::View(m_logicalView.getCenter(), sf::Vector2f { 400.f, 400.f });
-            smallMapView.zoom(3.0f);
-
-            sf::RectangleShape smallMapShape({ 180.f, 180.f });
-            sf::Texture texture;
-            if (m_misc.showSmallMap) {
-                smallMapOutput.setView(smallMapView);
-                smallMapOutput.clear(sf::Color{96, 96, 128, 196});
-                SRenderSystem::update(smallMapOutput, game::CRenderTargetComponent::SmallMap, deltaTime);
-                smallMapOutput.display();
-
-                texture = smallMapOutput.getTexture();
-                smallMapShape.setTexture(&texture);
-                smallMapShape.setOutlineColor(sf::Color{32, 32, 96});
-                smallMapShape.setOutlineThickness(2.f);
-                smallMapShape.setPosition(sf::Vector2f{static_cast<float>(m_windowSize.x) * 0.05f,
-                                                       static_cast<float>(m_windowSize.y) * 0.05f});
-            }
-
-            // phase: game components
-            gameComponents.setView(zoomedView);
-            gameComponents.clear(sf::Color::Black);
-            SRenderSystem::update(gameComponents, game::CRenderTargetComponent::GameComponent, deltaTime);
-            gameComponents.display();
-            sf::Sprite gameComponentsSprite(gameComponents.getTexture());
-
-            ui.clear(sf::Color::Transparent);
-            SRenderSystem::update(ui, game::CRenderTargetComponent::UI, deltaTime);
-            ui.display();
-
-            sf::Sprite uiSprite(ui.getTexture());
-            uiSprite.setPosition({0.f, 0.f});
-
-            // phase: illumination with light source
-            illumination.setView(zoomedView);
-            illumination.clear(sf::Color::Transparent);
-            SLightingSystem::update(illumination);
-            illumination.display();
-
-            sf::Sprite illuminationSprite(illumination.getTexture());
-            //illuminationSprite.setPosition(positioningOffset); // it just works.
-
-            // phase: ambient illumination
-            ambientIllumination.setView(zoomedView);
-            ambientIllumination.clear(ambientIlluminationColor);
-            ambientIllumination.display();
-
-            sf::Sprite ambientIlluminationSprite(ambientIllumination.getTexture());
-
-            // phase: primary output - mix game components, ambient illumination and normal illumination
-            primaryOutput.clear(sf::Color::Transparent);
-            primaryOutput.draw(gameComponentsSprite);
-            primaryOutput.draw(ambientIlluminationSprite, sf::RenderStates(sf::BlendMultiply));
-            primaryOutput.draw(illuminationSprite, sf::RenderStates(sf::BlendAdd));
-            //primaryOutput.draw(uiSprite);
-            primaryOutput.display();
-            sf::Sprite primaryOutputSprite(primaryOutput.getTexture());
-            primaryOutputSprite.setPosition({0.f, 0.f});
-
-            // phase: pixelation
-            pixelated.clear(sf::Color::Transparent);
-            pixelShader->setUniform("u_texture", sf::Shader::CurrentTexture);
-            pixelShader->setUniform("u_resolution", sf::Vector2f(m_windowSize));
-            pixelShader->setUniform("u_pixel_size", sf::Vector2f { 1.5f, 1.5f });
-            pixelated.draw(primaryOutputSprite, &*pixelShader);
-            pixelated.display();
-            sf::Sprite pixelatedSprite(pixelated.getTexture());
-            pixelatedSprite.setPosition({0.f, 0.f});
-
-            // phase(ui): pixelation
-            uiPixelated.clear(sf::Color::Transparent);
-            pixelShader->setUniform("u_pixel_size", sf::Vector2f { 1.0f, 1.0f });
-            uiPixelated.draw(uiSprite, &*pixelShader);
-            uiPixelated.display();
-            sf::Sprite uiPixelatedSprite(uiPixelated.getTexture());
-            uiPixelatedSprite.setPosition({0.f, 0.f});
-
-            // phase: post-processing - add crt effects
-            postProcessingCrt.clear(sf::Color::Transparent);
-            crtShader->setUniform("u_texture", sf::Shader::CurrentTexture);
-            crtShader->setUniform("u_time", static_cast<float>(crtScanlineClock.getElapsedTime().asMilliseconds()));
-            crtShader->setUniform("u_chromatic_strength", 0.015f);
-            postProcessingCrt.draw(pixelatedSprite, &*crtShader);
-            postProcessingCrt.display();
-            sf::Sprite postProcessingCrtSprite(postProcessingCrt.getTexture());
-            postProcessingCrtSprite.setPosition({0.f, 0.f});
-
-            // phase(ui): post-processing - add crt effects
-            uiPostProcessingCrt.clear(sf::Color::Transparent);
-            crtShader->setUniform("u_chromatic_strength", 0.005f);
-            uiPostProcessingCrt.draw(uiPixelatedSprite, &*crtShader);
-            if (m_misc.showSmallMap) {
-                uiPostProcessingCrt.draw(smallMapShape, &*crtShader);
-            }
-            uiPostProcessingCrt.display();
-            sf::Sprite uiPostProcessingCrtSprite(uiPostProcessingCrt.getTexture());
-            uiPostProcessingCrtSprite.setPosition({0.f, 0.f});
-
-            // phase: post-processing - add bloom - brightness calculation
-            postProcessingBloomBrightness.clear(sf::Color::Transparent);
-            bloomShader->setUniform("u_texture", sf::Shader::CurrentTexture);
-            bloomShader->setUniform("u_brightness_threshold", 0.55f);
-            postProcessingBloomBrightness.draw(postProcessingCrtSprite, &*bloomShader);
-            postProcessingBloomBrightness.display();
-            sf::Sprite postProcessingBloomBrightnessSprite(postProcessingBloomBrightness.getTexture());
-            postProcessingBloomBrightnessSprite.setPosition({0.f, 0.f});
-
-            // phase: post-processing - add bloom - gaussian blurring
-            postProcessingBloomBlurH.clear(sf::Color::Transparent);
-            bloomBlurShader->setUniform("u_texture", sf::Shader::CurrentTexture);
-            bloomBlurShader->setUniform("u_resolution", sf::Vector2f(m_windowSize));
-            bloomBlurShader->setUniform("u_direction", sf::Vector2f(1.f, 0.f));
-            postProcessingBloomBlurH.draw(postProcessingBloomBrightnessSprite, &*bloomBlurShader);
-            postProcessingBloomBlurH.display();
-            sf::Sprite postProcessingBloomBlurHSprite(postProcessingBloomBlurH.getTexture());
-            postProcessingBloomBlurHSprite.setPosition({0.f, 0.f});
-
-            postProcessingBloomBlurV.clear(sf::Color::Transparent);
-            bloomBlurShader->setUniform("u_texture", sf::Shader::CurrentTexture);
-            bloomBlurShader->setUniform("u_resolution", sf::Vector2f(m_windowSize));
-            bloomBlurShader->setUniform("u_direction", sf::Vector2f(0.f, 1.f));
-            postProcessingBloomBlurV.draw(postProcessingBloomBlurHSprite, &*bloomBlurShader);
-            postProcessingBloomBlurV.display();
-            sf::Sprite postProcessingBloomBlurVSprite(postProcessingBloomBlurV.getTexture());
-            postProcessingBloomBlurVSprite.setPosition({0.f, 0.f});
-
-            // phase: final output - from crt post-processing, add bloom, ui
-            finalOutput.clear(sf::Color::Transparent);
-            finalOutput.draw(postProcessingCrtSprite);
-            finalOutput.draw(postProcessingBloomBlurVSprite, sf::RenderStates(sf::BlendAdd));
-            finalOutput.draw(uiPostProcessingCrtSprite);
-            finalOutput.display();
-            sf::Sprite finalOutputSprite(finalOutput.getTexture());
+            renderFrame(pipeline, deltaTime, originalDeltaTime);
+            sf::Sprite finalOutputSprite(pipeline.finalOutput.getTexture());
             finalOutputSprite.setPosition({0.f, 0.f});
 
             if (fpsSampleClock.getElapsedTime() > sf::seconds(FPS_SAMPLE_INTERVAL)) {
@@ -290,12 +218,311 @@ namespace game {
             m_window->draw(fpsText);
 
             m_window->display();
-            // --- end of render pipeline --- //
 
             SSceneUnmountSystem::update();
         }
     }
 
+    bool Window::runOffscreen(const OffscreenCapture& capture) {
+        getLogger().logInfo("Rendering " + std::to_string(capture.frameCount) + " frames offscreen");
+        m_misc.closeRequested = false;
+
+        // same as the default view of a window with this size.
+        m_logicalView = sf::View(sf::FloatRect({0.f, 0.f}, sf::Vector2f(m_windowSize)));
+        m_logicalView.setCenter({0, 0});
+
+        auto& game = getGame();
+
+        RenderPipeline pipeline(m_windowSize, m_videoPreference.lightmapDownscale);
+        pipeline.useFixedScanlineTime = true;
+        pipeline.profiler.setEnabled(!capture.timingsPath.empty());
+
+        uint32_t frame = 0;
+        for (; frame < capture.frameCount && !m_misc.closeRequested; frame++) {
+            const auto originalDeltaTime = capture.timeStep;
+            const auto deltaTime = originalDeltaTime * game.getTimeScale();
+
+            updateLogic(deltaTime);
+            renderFrame(pipeline, deltaTime, originalDeltaTime);
+
+            SSceneUnmountSystem::update();
+        }
+        getLogger().logInfo("Rendered " + std::to_string(frame) + " frames offscreen");
+        getLogger().logInfo("Scripts deferred by the frame budget: "
+            + std::to_string(SScriptsSystem::getDeferredTotal()));
+
+        bool succeeded = true;
+        const auto image = pipeline.finalOutput.getTexture().copyToImage();
+        if (image.saveToFile(capture.imagePath)) {
+            getLogger().logInfo("Final output saved to " + capture.imagePath);
+        } else {
+            getLogger().logError("Failed to save the final output to " + capture.imagePath);
+            succeeded = false;
+        }
+
+        if (pipeline.profiler.isEnabled()) {
+            pipeline.profiler.logSummary();
+            if (pipeline.profiler.writeCsv(capture.timingsPath)) {
+                getLogger().logInfo("Pass timings saved to " + capture.timingsPath);
+            } else {
+                getLogger().logError("Failed to save the pass timings to " + capture.timingsPath);
+                succeeded = false;
+            }
+        }
+        return succeeded;
+    }
+
+    void Window::close() {
+        m_misc.closeRequested = true;
+        if (m_window != nullptr) {
+            m_window->close();
+        }
+    }
+
+    void Window::updateLogic(const sf::Time deltaTime) {
+        // scaled time, the timers stop along with the game.
+        getTimerWheel().advance(deltaTime);
+        SScriptsSystem::update(deltaTime);
+
+        SMovementSystem::update(deltaTime);
+        SScenePositionUpdateSystem::update();
+        STileStreamingSystem::update();
+        SCollisionSystem::update(deltaTime);
+        STweenSystem::update(deltaTime);
+
+        SMusicSystem::update();
+    }
+
+    void Window::renderFrame(RenderPipeline& pipeline, const sf::Time deltaTime, const sf::Time originalDeltaTime) {
+        constexpr sf::Color ambientIlluminationColor(255, 255, 255, 160);
+
+        const auto windowSize = pipeline.windowSize;
+        auto& profiler = pipeline.profiler;
+        profiler.beginFrame();
+
+        // --- render pipeline --- //
+
+        auto zoomedView = m_logicalView;
+        zoomedView.zoom(m_videoPreference.zoomFactor);
+
+        // phase: small map
+        if (m_misc.showSmallMap) {
+            profiler.beginPass("smallMap");
+            pipeline.smallMapSinceRefresh += originalDeltaTime;
+            pipeline.smallMapPendingDeltaTime += deltaTime;
+
+            const auto smallMapCenter = m_logicalView.getCenter();
+            const float smallMapCacheExtent = RenderPipeline::smallMapCacheExtent;
+
+            // static layers: baked around the current center, over a larger area than shown,
+            // and only redone when invalidated or when the shown area would leave the cached one.
+            const float cacheMargin = (smallMapCacheExtent - SMALL_MAP_VIEW_EXTENT) * 0.5f;
+            const auto drift = smallMapCenter - pipeline.smallMapCacheCenter;
+            const bool rebake = m_misc.smallMapCacheDirty
+                    || std::abs(drift.x) > cacheMargin || std::abs(drift.y) > cacheMargin;
+            if (rebake) {
+                pipeline.smallMapCacheCenter = smallMapCenter;
+                pipeline.smallMapStatic.setView(sf::View(pipeline.smallMapCacheCenter, { smallMapCacheExtent, smallMapCacheExtent }));
+                pipeline.smallMapStatic.clear(sf::Color::Transparent);
+                SRenderSystem::update(pipeline.smallMapStatic, game::CRenderTargetComponent::SmallMapStatic, sf::Time::Zero);
+                pipeline.smallMapStatic.display();
+                m_misc.smallMapCacheDirty = false;
+            }
+
+            // dynamic content: redrawn at the refresh rate, on top of the cached layers.
+            const auto refreshInterval = sf::seconds(1.f / m_misc.smallMapRefreshRate);
+            if (rebake || !pipeline.smallMapWasVisible || pipeline.smallMapSinceRefresh >= refreshInterval) {
+                pipeline.smallMapOutput.setView(sf::View(smallMapCenter, { SMALL_MAP_VIEW_EXTENT, SMALL_MAP_VIEW_EXTENT }));
+                pipeline.smallMapOutput.clear(sf::Color{96, 96, 128, 196});
+
+                sf::Sprite smallMapStaticSprite(pipeline.smallMapStatic.getTexture());
+                smallMapStaticSprite.setPosition(pipeline.smallMapCacheCenter - sf::Vector2f { smallMapCacheExtent, smallMapCacheExtent } * 0.5f);
+                smallMapStaticSprite.setScale({
+                    smallMapCacheExtent / static_cast<float>(pipeline.smallMapStatic.getSize().x),
+                    smallMapCacheExtent / static_cast<float>(pipeline.smallMapStatic.getSize().y)
+                });
+                pipeline.smallMapOutput.draw(smallMapStaticSprite);
+
+                SRenderSystem::update(pipeline.smallMapOutput, game::CRenderTargetComponent::SmallMap, pipeline.smallMapPendingDeltaTime);
+                pipeline.smallMapOutput.display();
+
+                pipeline.smallMapSinceRefresh = sf::Time::Zero;
+                pipeline.smallMapPendingDeltaTime = sf::Time::Zero;
+            }
+            profiler.endPass();
+        }
+        pipeline.smallMapWasVisible = m_misc.showSmallMap;
+
+        // phase: game components
+        profiler.beginPass("gameComponents");
+        auto& gameComponents = pipeline.gameComponents;
+        gameComponents.setView(zoomedView);
+        gameComponents.clear(sf::Color::Black);
+        SRenderSystem::update(gameComponents, game::CRenderTargetComponent::GameComponent, deltaTime);
+        gameComponents.display();
+        sf::Sprite gameComponentsSprite(gameComponents.getTexture());
+        profiler.endPass();
+
+        profiler.beginPass("ui");
+        auto& ui = pipeline.ui;
+        ui.clear(sf::Color::Transparent);
+        SRenderSystem::update(ui, game::CRenderTargetComponent::UI, deltaTime);
+        ui.display();
+
+        sf::Sprite uiSprite(ui.getTexture());
+        uiSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase: illumination with light source
+        profiler.beginPass("illumination");
+        auto& illumination = pipeline.illumination;
+        illumination.setView(zoomedView);
+        illumination.clear(sf::Color::Transparent);
+        SLightingSystem::update(illumination);
+        illumination.display();
+
+        sf::Sprite illuminationSprite(illumination.getTexture());
+        illuminationSprite.setScale({
+            static_cast<float>(windowSize.x) / static_cast<float>(pipeline.lightmapSize.x),
+            static_cast<float>(windowSize.y) / static_cast<float>(pipeline.lightmapSize.y)
+        });
+        //illuminationSprite.setPosition(positioningOffset); // it just works.
+        profiler.endPass();
+
+        // phase: ambient illumination
+        profiler.beginPass("ambientIllumination");
+        auto& ambientIllumination = pipeline.ambientIllumination;
+        ambientIllumination.setView(zoomedView);
+        ambientIllumination.clear(ambientIlluminationColor);
+        ambientIllumination.display();
+
+        sf::Sprite ambientIlluminationSprite(ambientIllumination.getTexture());
+        profiler.endPass();
+
+        // phase: primary output - mix game components, ambient illumination and normal illumination
+        profiler.beginPass("primaryOutput");
+        auto& primaryOutput = pipeline.primaryOutput;
+        primaryOutput.clear(sf::Color::Transparent);
+        primaryOutput.draw(gameComponentsSprite);
+        primaryOutput.draw(ambientIlluminationSprite, sf::RenderStates(sf::BlendMultiply));
+        primaryOutput.draw(illuminationSprite, sf::RenderStates(sf::BlendAdd));
+        //primaryOutput.draw(uiSprite);
+        primaryOutput.display();
+        sf::Sprite primaryOutputSprite(primaryOutput.getTexture());
+        primaryOutputSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        auto& pixelShader = pipeline.pixelShader;
+        auto& crtShader = pipeline.crtShader;
+        auto& bloomShader = pipeline.bloomShader;
+        auto& bloomBlurShader = pipeline.bloomBlurShader;
+
+        // phase: pixelation
+        profiler.beginPass("pixelation");
+        auto& pixelated = pipeline.pixelated;
+        pixelated.clear(sf::Color::Transparent);
+        pixelShader->setUniform("u_texture", sf::Shader::CurrentTexture);
+        pixelShader->setUniform("u_resolution", sf::Vector2f(windowSize));
+        pixelShader->setUniform("u_pixel_size", sf::Vector2f { 1.5f, 1.5f });
+        pixelated.draw(primaryOutputSprite, &*pixelShader);
+        pixelated.display();
+        sf::Sprite pixelatedSprite(pixelated.getTexture());
+        pixelatedSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase(ui): pixelation
+        profiler.beginPass("uiPixelation");
+        auto& uiPixelated = pipeline.uiPixelated;
+        uiPixelated.clear(sf::Color::Transparent);
+        pixelShader->setUniform("u_pixel_size", sf::Vector2f { 1.0f, 1.0f });
+        uiPixelated.draw(uiSprite, &*pixelShader);
+        uiPixelated.display();
+        sf::Sprite uiPixelatedSprite(uiPixelated.getTexture());
+        uiPixelatedSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        if (pipeline.useFixedScanlineTime) {
+            pipeline.crtScanlineTime += originalDeltaTime;
+        } else {
+            pipeline.crtScanlineTime = pipeline.crtScanlineClock.getElapsedTime();
+        }
+
+        // phase: post-processing - add crt effects
+        profiler.beginPass("crt");
+        auto& postProcessingCrt = pipeline.postProcessingCrt;
+        postProcessingCrt.clear(sf::Color::Transparent);
+        crtShader->setUniform("u_texture", sf::Shader::CurrentTexture);
+        crtShader->setUniform("u_time", static_cast<float>(pipeline.crtScanlineTime.asMilliseconds()));
+        crtShader->setUniform("u_chromatic_strength", 0.015f);
+        postProcessingCrt.draw(pixelatedSprite, &*crtShader);
+        postProcessingCrt.display();
+        sf::Sprite postProcessingCrtSprite(postProcessingCrt.getTexture());
+        postProcessingCrtSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase(ui): post-processing - add crt effects
+        profiler.beginPass("uiCrt");
+        auto& uiPostProcessingCrt = pipeline.uiPostProcessingCrt;
+        uiPostProcessingCrt.clear(sf::Color::Transparent);
+        crtShader->setUniform("u_chromatic_strength", 0.005f);
+        uiPostProcessingCrt.draw(uiPixelatedSprite, &*crtShader);
+        if (m_misc.showSmallMap) {
+            uiPostProcessingCrt.draw(pipeline.smallMapShape, &*crtShader);
+        }
+        uiPostProcessingCrt.display();
+        sf::Sprite uiPostProcessingCrtSprite(uiPostProcessingCrt.getTexture());
+        uiPostProcessingCrtSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase: post-processing - add bloom - brightness calculation
+        profiler.beginPass("bloomBrightness");
+        auto& postProcessingBloomBrightness = pipeline.postProcessingBloomBrightness;
+        postProcessingBloomBrightness.clear(sf::Color::Transparent);
+        bloomShader->setUniform("u_texture", sf::Shader::CurrentTexture);
+        bloomShader->setUniform("u_brightness_threshold", 0.55f);
+        postProcessingBloomBrightness.draw(postProcessingCrtSprite, &*bloomShader);
+        postProcessingBloomBrightness.display();
+        sf::Sprite postProcessingBloomBrightnessSprite(postProcessingBloomBrightness.getTexture());
+        postProcessingBloomBrightnessSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase: post-processing - add bloom - gaussian blurring
+        profiler.beginPass("bloomBlur");
+        auto& postProcessingBloomBlurH = pipeline.postProcessingBloomBlurH;
+        postProcessingBloomBlurH.clear(sf::Color::Transparent);
+        bloomBlurShader->setUniform("u_texture", sf::Shader::CurrentTexture);
+        bloomBlurShader->setUniform("u_resolution", sf::Vector2f(windowSize));
+        bloomBlurShader->setUniform("u_direction", sf::Vector2f(1.f, 0.f));
+        postProcessingBloomBlurH.draw(postProcessingBloomBrightnessSprite, &*bloomBlurShader);
+        postProcessingBloomBlurH.display();
+        sf::Sprite postProcessingBloomBlurHSprite(postProcessingBloomBlurH.getTexture());
+        postProcessingBloomBlurHSprite.setPosition({0.f, 0.f});
+
+        auto& postProcessingBloomBlurV = pipeline.postProcessingBloomBlurV;
+        postProcessingBloomBlurV.clear(sf::Color::Transparent);
+        bloomBlurShader->setUniform("u_texture", sf::Shader::CurrentTexture);
+        bloomBlurShader->setUniform("u_resolution", sf::Vector2f(windowSize));
+        bloomBlurShader->setUniform("u_direction", sf::Vector2f(0.f, 1.f));
+        postProcessingBloomBlurV.draw(postProcessingBloomBlurHSprite, &*bloomBlurShader);
+        postProcessingBloomBlurV.display();
+        sf::Sprite postProcessingBloomBlurVSprite(postProcessingBloomBlurV.getTexture());
+        postProcessingBloomBlurVSprite.setPosition({0.f, 0.f});
+        profiler.endPass();
+
+        // phase: final output - from crt post-processing, add bloom, ui
+        profiler.beginPass("finalOutput");
+        auto& finalOutput = pipeline.finalOutput;
+        finalOutput.clear(sf::Color::Transparent);
+        finalOutput.draw(postProcessingCrtSprite);
+        finalOutput.draw(postProcessingBloomBlurVSprite, sf::RenderStates(sf::BlendAdd));
+        finalOutput.draw(uiPostProcessingCrtSprite);
+        finalOutput.display();
+        profiler.endPass();
+
+        // --- end of render pipeline --- //
+        profiler.endFrame();
+    }
+
     // letterboxing code from:
     // https://github.com/SFML/SFML/wiki/Source%3A-Letterbox-effect-using-a-view
     sf::View Window::getLetterboxView(sf::View view, sf::Vector2u windowSize) {
@@ -350,4 +577,13 @@ namespace game {
         getLogger().logInfo("Setting zoom factor to: " + std::to_string(zoomFactor));
         m_videoPreference.zoomFactor = zoomFactor;
     }
+
+    void Window::setLightmapDownscale(uint32_t downscale) {
+        if (downscale == 0) {
+            getLogger().logWarn("Lightmap downscale must be at least 1, falling back to full resolution.");
+            downscale = 1;
+        }
+        getLogger().logInfo("Setting lightmap downscale to: 1/" + std::to_string(downscale));
+        m_videoPreference.lightmapDownscale = downscale;
+    }
 } // game
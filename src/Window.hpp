@@ -5,11 +5,28 @@
 #ifndef WINDOW_H
 #define WINDOW_H
 
+#include <string>
 #include <utility>
 
 #include "SFML/Graphics.hpp"
 
 namespace game {
+    /**
+     * Parameters of Window::runOffscreen().
+     */
+    struct OffscreenCapture {
+        uint32_t frameCount { 120 };
+        /**
+         * every frame advances the game by exactly this much, so that captures are reproducible.
+         */
+        sf::Time timeStep { sf::seconds(1.f / 60.f) };
+        std::string imagePath { "capture.png" };
+        /**
+         * per-pass timings are written here as csv, leave empty to skip profiling.
+         */
+        std::string timingsPath;
+    };
+
     class Window {
     public:
         Window() : m_windowSize(1280.f, 720.f), m_aspectRatio(1280.f / 720.f) {};
@@ -31,6 +48,13 @@ namespace game {
 
         void setZoomFactor(float zoomFactor);
 
+        /**
+         * The lightmap is rendered at (window size / downscale) and bilinearly upsampled.
+         * The light falloff is soft enough that 2 (half) or 4 (quarter) are hardly noticeable.
+         * @param downscale 1 for full resolution, 2 for half, 4 for quarter
+         */
+        void setLightmapDownscale(uint32_t downscale);
+
         void setWindowTitle(sf::String title);
 
         void setWindowSize(const sf::Vector2u& windowSize);
@@ -39,6 +63,19 @@ namespace game {
 
         void run();
 
+        /**
+         * Runs the game for a number of frames without opening a window and saves the final output as an image.
+         * Only a gl context is needed, so this also works on a headless machine with a software
+         * implementation like mesa's llvmpipe, e.g. under xvfb-run.
+         * @return false if the image or the timings could not be written
+         */
+        bool runOffscreen(const OffscreenCapture& capture);
+
+        /**
+         * Closes the window, or ends an offscreen run after the current frame.
+         */
+        void close();
+
         void setViewCenter(sf::Vector2f center) {
             /*auto view = m_window->getView();
             view.setCenter(center);
@@ -55,17 +92,47 @@ namespace game {
         void setSmallMapVisibility(bool isVisible) { m_misc.showSmallMap = isVisible; }
         bool isSmallMapVisible() const { return m_misc.showSmallMap; }
 
+        /**
+         * The dynamic part of the small map (indicators) is redrawn at this rate,
+         * the static layers are baked once and cached.
+         * @param refreshRate refreshes per second
+         */
+        void setSmallMapRefreshRate(float refreshRate);
+
+        /**
+         * Makes the small map bake its static layers again, call this when the map has changed.
+         */
+        void invalidateSmallMapCache() { m_misc.smallMapCacheDirty = true; }
+
     private:
         struct VideoPreference {
             int fps = 60;
             bool vsync = false;
             float zoomFactor = 1.f;
+            uint32_t lightmapDownscale = 2;
         };
 
         struct Misc {
             bool showSmallMap { false };
+            float smallMapRefreshRate { 10.f };
+            bool smallMapCacheDirty { true };
+            bool closeRequested { false };
         };
 
+        // render targets and shaders of the pipeline, see Window.cpp.
+        struct RenderPipeline;
+
+        static constexpr uint32_t SMALL_MAP_RESOLUTION = 180;
+        /**
+         * world units covered by the small map, on both axes.
+         */
+        static constexpr float SMALL_MAP_VIEW_EXTENT = 1200.f;
+        /**
+         * the static cache covers this many times the small map extent,
+         * so that it only needs to be baked again after the view has moved far enough.
+         */
+        static constexpr uint32_t SMALL_MAP_CACHE_SCALE = 2;
+
         std::unique_ptr<sf::RenderWindow> m_window { nullptr };
         sf::Vector2u m_windowSize;
         sf::String m_windowTitle = u8"Game";
@@ -74,6 +141,12 @@ namespace game {
         Misc m_misc;
         sf::View m_logicalView;
 
+        void updateLogic(sf::Time deltaTime);
+        /**
+         * Renders every pass into the pipeline, the result ends up in its final output.
+         */
+        void renderFrame(RenderPipeline& pipeline, sf::Time deltaTime, sf::Time originalDeltaTime);
+
         void keepViewportScale() const;
         static sf::View getLetterboxView(sf::View view, sf::Vector2u windowSize);
     };
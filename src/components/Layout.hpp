@@ -5,6 +5,9 @@
 #ifndef LAYOUT_HPP
 #define LAYOUT_HPP
 
+#include <atomic>
+#include <cmath>
+#include <cstdint>
 #include <entt/entity/entity.hpp>
 
 #include "Common.hpp"
@@ -34,33 +37,160 @@ namespace game {
         void setScale(const sf::Vector2f scale) { m_scale = scale; }
         [[nodiscard]] sf::Vector2f getScale() const { return m_scale; }
 
+        /**
+         * Rotates around the origin (the anchor), clockwise. Children rotate along with their parent.
+         */
+        void setRotation(const sf::Angle rotation) { m_rotation = rotation; }
+        [[nodiscard]] sf::Angle getRotation() const { return m_rotation; }
+        void rotate(const sf::Angle angle) { m_rotation += angle; }
+
     private:
+        friend class SMovementSystem;
+
         sf::Vector2f m_position {0.f, 0.f};
         sf::Vector2f m_size {0.f, 0.f};
         sf::Vector2f m_scale {1.f, 1.f};
+        sf::Angle m_rotation { sf::Angle::Zero };
     };
 
     struct CGlobalTransform {
-        CGlobalTransform() = default;
-        explicit CGlobalTransform(const sf::Vector2f position) : m_position(position) {}
+        /**
+         * The affine matrix, maps a point of the entity (in pixels, origin at the top left) to the world.
+         * x' = a * x + c * y + tx
+         * y' = b * x + d * y + ty
+         */
+        struct Affine {
+            float a { 1.f };
+            float b { 0.f };
+            float c { 0.f };
+            float d { 1.f };
+            float tx { 0.f };
+            float ty { 0.f };
+
+            bool operator==(const Affine& other) const {
+                return a == other.a && b == other.b && c == other.c && d == other.d && tx == other.tx && ty == other.ty;
+            }
+            bool operator!=(const Affine& other) const { return !(*this == other); }
+        };
 
-        void setPosition(const sf::Vector2f position) { m_position = position; }
+        CGlobalTransform() = default;
+        explicit CGlobalTransform(const sf::Vector2f position) : m_position(position) { rebuildAffine(); }
+
+        void setPosition(const sf::Vector2f position) {
+            if (m_position != position) {
+                m_position = position;
+                rebuildAffine();
+                touch();
+            }
+        }
         [[nodiscard]] sf::Vector2f getPosition() const { return m_position; }
 
-        void setSize(const sf::Vector2f size) { m_size = size; }
+        void setSize(const sf::Vector2f size) {
+            if (m_size != size) {
+                m_size = size;
+                touch();
+            }
+        }
         [[nodiscard]] sf::Vector2f getSize() const { return m_size; }
 
-        void setScale(const sf::Vector2f scale) { m_scale = scale; }
+        void setScale(const sf::Vector2f scale) {
+            if (m_scale != scale) {
+                m_scale = scale;
+                rebuildAffine();
+                touch();
+            }
+        }
         [[nodiscard]] sf::Vector2f getScale() const { return m_scale; }
 
-        void setOrigin(const sf::Vector2f origin) { m_origin = origin; }
+        void setOrigin(const sf::Vector2f origin) {
+            if (m_origin != origin) {
+                m_origin = origin;
+                rebuildAffine();
+                touch();
+            }
+        }
         [[nodiscard]] sf::Vector2f getOrigin() const { return m_origin; }
 
+        void setRotation(const sf::Angle rotation) {
+            if (m_rotation != rotation) {
+                m_rotation = rotation;
+                rebuildAffine();
+                touch();
+            }
+        }
+        [[nodiscard]] sf::Angle getRotation() const { return m_rotation; }
+
+        /**
+         * Sets everything at once, with the matrix already composed from the other values.
+         * This is what the scene tree propagation uses, see SScenePositionUpdateSystem.
+         */
+        void setComposed(const sf::Vector2f position, const sf::Vector2f size, const sf::Vector2f scale,
+                         const sf::Vector2f origin, const sf::Angle rotation, const Affine& affine) {
+            if (m_position == position && m_size == size && m_scale == scale &&
+                m_origin == origin && m_rotation == rotation && m_affine == affine) {
+                return;
+            }
+            m_position = position;
+            m_size = size;
+            m_scale = scale;
+            m_origin = origin;
+            m_rotation = rotation;
+            m_affine = affine;
+            touch();
+        }
+
+        [[nodiscard]] const Affine& getAffine() const { return m_affine; }
+
+        /**
+         * The same as position, rotation, scale and origin applied to a sf::Transformable,
+         * draw with this instead of setting them one by one.
+         */
+        [[nodiscard]] sf::Transform getTransform() const {
+            return {
+                m_affine.a, m_affine.c, m_affine.tx,
+                m_affine.b, m_affine.d, m_affine.ty,
+                0.f, 0.f, 1.f
+            };
+        }
+
+        /**
+         * Changes whenever the transform actually changes, setting the same value again keeps it.
+         * Generations are unique across all transforms, so a cached value can never match by accident.
+         * Render components compare it to skip rebuilding their state.
+         */
+        [[nodiscard]] uint64_t getGeneration() const { return m_generation; }
+
     private:
         sf::Vector2f m_position {0.f, 0.f};
         sf::Vector2f m_size {0.f, 0.f};
         sf::Vector2f m_scale {1.f, 1.f};
         sf::Vector2f m_origin {0.f, 0.f};
+        sf::Angle m_rotation { sf::Angle::Zero };
+        Affine m_affine {};
+        uint64_t m_generation { nextGeneration() };
+
+        void touch() { m_generation = nextGeneration(); }
+
+        void rebuildAffine() {
+            float cos = 1.f;
+            float sin = 0.f;
+            if (m_rotation != sf::Angle::Zero) {
+                cos = std::cos(m_rotation.asRadians());
+                sin = std::sin(m_rotation.asRadians());
+            }
+
+            m_affine.a = cos * m_scale.x;
+            m_affine.b = sin * m_scale.x;
+            m_affine.c = -sin * m_scale.y;
+            m_affine.d = cos * m_scale.y;
+            m_affine.tx = m_position.x - (m_affine.a * m_origin.x + m_affine.c * m_origin.y);
+            m_affine.ty = m_position.y - (m_affine.b * m_origin.x + m_affine.d * m_origin.y);
+        }
+
+        static uint64_t nextGeneration() {
+            static std::atomic<uint64_t> s_generation { 0 };
+            return s_generation.fetch_add(1, std::memory_order_relaxed) + 1;
+        }
     };
 
     struct CLayout {
@@ -0,0 +1,27 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef POOL_HPP
+#define POOL_HPP
+
+namespace game {
+    class PrefabPool;
+
+    // the root of a subtree which belongs to a pool.
+    // unmounting it hands it back to the pool instead of destroying it.
+    struct CPoolable {
+        CPoolable() = default;
+        explicit CPoolable(PrefabPool* pool) : m_pool(pool) {}
+
+        [[nodiscard]] PrefabPool* getPool() const { return m_pool; }
+    private:
+        PrefabPool* m_pool { nullptr };
+    };
+
+    // on every entity of a subtree that is parked in a pool.
+    // rendering, collision, lighting, movement and scripts skip these entities.
+    struct CPooled {};
+}
+
+#endif //POOL_HPP
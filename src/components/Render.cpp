@@ -4,6 +4,9 @@
 
 #include "Render.hpp"
 
+#include <algorithm>
+#include <limits>
+
 #include "Common.hpp"
 #include "Layout.hpp"
 #include "Logger.hpp"
@@ -28,20 +31,30 @@ void game::CSpriteRenderComponent::update(sf::RenderTarget& target, const CGloba
         return;
     }
 
-    m_sprite->setPosition(globalTransform.getPosition());
-    m_sprite->setScale(globalTransform.getScale());
-    m_sprite->setOrigin(globalTransform.getOrigin());
+    // the sprite keeps an identity transform, the global one is handed over as it is when drawing.
+    // the texture rect depends on the size though, so it is only redone when the transform or the frame has changed.
+    const bool transformChanged = globalTransform.getGeneration() != m_transformGeneration;
+    const auto* frame = m_frame.handle().get();
+    const bool frameChanged = frame != m_appliedFrame;
+    m_transformGeneration = globalTransform.getGeneration();
+
+    if (transformChanged || frameChanged) {
+        if (frameChanged) {
+            m_sprite->setTexture(m_frame->texture->rawTextureRef->texture);
+            m_appliedFrame = frame;
+        }
 
-    auto size = globalTransform.getSize();
+        auto size = globalTransform.getSize();
 
-    auto textureRect = m_frame->texture->textureRect;
-    if (textureRect.has_value() &&
-        (textureRect.value().size.x >= static_cast<int>(size.x) && textureRect.value().size.y >= static_cast<int>(size.y))) {
-        m_sprite->setTextureRect(textureRect.value());
-    } else {
-        m_sprite->setTextureRect({textureRect->position, {static_cast<int>(size.x), static_cast<int>(size.y)}});
+        auto textureRect = m_frame->texture->textureRect;
+        if (textureRect.has_value() &&
+            (textureRect.value().size.x >= static_cast<int>(size.x) && textureRect.value().size.y >= static_cast<int>(size.y))) {
+            m_sprite->setTextureRect(textureRect.value());
+        } else {
+            m_sprite->setTextureRect({textureRect->position, {static_cast<int>(size.x), static_cast<int>(size.y)}});
+        }
     }
-    target.draw(*m_sprite);
+    target.draw(*m_sprite, sf::RenderStates(globalTransform.getTransform()));
 }
 
 game::CTextRenderComponent::CTextRenderComponent(const std::string& resourceName, sf::Font&& font) {
@@ -51,38 +64,113 @@ game::CTextRenderComponent::CTextRenderComponent(const std::string& resourceName
 }
 
 void game::CTextRenderComponent::update(sf::RenderTarget& target, const CGlobalTransform& globalTransform) {
-    if (!m_textSprite.has_value()) {
-        m_textSprite = sf::Text(m_font);
-        return;
+    // wrapping and the geometry only need to be redone when one of their inputs has changed.
+    const float regionWidth = globalTransform.getSize().x;
+    if (m_layoutDirty || regionWidth != m_layoutWidth) {
+        rebuildGeometry(regionWidth);
+        m_layoutWidth = regionWidth;
+        m_layoutDirty = false;
+        m_colorDirty = true;
+    }
+    if (m_colorDirty) {
+        applyColor();
+        m_colorDirty = false;
     }
-    m_textSprite->setPosition(globalTransform.getPosition());
-    m_textSprite->setScale(globalTransform.getScale());
-    m_textSprite->setOrigin(globalTransform.getOrigin());
 
-    m_textSprite->setString(processText(m_text, globalTransform.getSize()));
+    const size_t characterCount = m_characterVertexOffsets.size() - 1;
+    const size_t vertexCount = m_characterVertexOffsets[std::min(m_revealCount, characterCount)];
+    if (vertexCount == 0) {
+        return;
+    }
 
-    m_textSprite->setFont(*m_font);
-    m_textSprite->setFillColor(m_color);
-    m_textSprite->setStyle(m_style);
-    m_textSprite->setCharacterSize(m_textSize);
+    sf::RenderStates states(globalTransform.getTransform());
+    states.texture = &m_font->getTexture(static_cast<unsigned int>(m_textSize));
 
-    target.draw(*m_textSprite);
+    target.draw(m_vertices.data(), vertexCount, sf::PrimitiveType::Triangles, states);
 }
 
-sf::String game::CTextRenderComponent::processText(const sf::String& text, const sf::Vector2f& regionSize) const {
-    sf::String result;
-    float aggregateWidth = 0;
-    for (size_t i = 0; i < text.getSize(); i++) {
-        auto character = text[i];
-        auto characterWidth = m_font->getGlyph(character, m_textSize, false).advance;
-        if (aggregateWidth + characterWidth >= regionSize.x) {
-            result += '\n';
-            aggregateWidth = 0;
+void game::CTextRenderComponent::rebuildGeometry(float regionWidth) {
+    // this mirrors the layout of sf::Text, with the word wrapping of the region folded in,
+    // and with the vertex offset of every character recorded for the reveal.
+    m_vertices.clear();
+    m_characterVertexOffsets.clear();
+    m_vertices.reserve(m_text.getSize() * 6);
+    m_characterVertexOffsets.reserve(m_text.getSize() + 1);
+
+    const auto& font = *m_font;
+    const auto characterSize = static_cast<unsigned int>(m_textSize);
+    const bool isBold = (m_style & sf::Text::Style::Bold) != 0;
+    const float italicShear = (m_style & sf::Text::Style::Italic) != 0 ? 0.2094395102393195f : 0.f; // 12 degrees
+
+    const float whitespaceWidth = font.getGlyph(U' ', characterSize, isBold).advance;
+    const float lineSpacing = font.getLineSpacing(characterSize);
+
+    // sf::Font pads the glyphs in its atlas, this keeps the anti-aliased edges.
+    constexpr float padding = 1.f;
+
+    float x = 0.f;
+    auto y = static_cast<float>(characterSize);
+    char32_t previousCharacter = 0;
+
+    for (size_t i = 0; i < m_text.getSize(); i++) {
+        m_characterVertexOffsets.push_back(m_vertices.size());
+
+        const char32_t character = m_text[i];
+        if (character == U'\r') {
+            continue;
         }
-        result += character;
-        aggregateWidth += characterWidth;
+
+        x += font.getKerning(previousCharacter, character, characterSize, isBold);
+        previousCharacter = character;
+
+        if (character == U'\n') {
+            x = 0.f;
+            y += lineSpacing;
+            continue;
+        }
+        if (character == U' ' || character == U'\t') {
+            x += character == U' ' ? whitespaceWidth : whitespaceWidth * 4.f;
+            continue;
+        }
+
+        const auto& glyph = font.getGlyph(character, characterSize, isBold);
+        if (x > 0.f && x + glyph.advance >= regionWidth) {
+            x = 0.f;
+            y += lineSpacing;
+        }
+
+        const float left = glyph.bounds.position.x - padding;
+        const float top = glyph.bounds.position.y - padding;
+        const float right = glyph.bounds.position.x + glyph.bounds.size.x + padding;
+        const float bottom = glyph.bounds.position.y + glyph.bounds.size.y + padding;
+
+        const float u1 = static_cast<float>(glyph.textureRect.position.x) - padding;
+        const float v1 = static_cast<float>(glyph.textureRect.position.y) - padding;
+        const float u2 = static_cast<float>(glyph.textureRect.position.x + glyph.textureRect.size.x) + padding;
+        const float v2 = static_cast<float>(glyph.textureRect.position.y + glyph.textureRect.size.y) + padding;
+
+        const sf::Vertex topLeft { { x + left - italicShear * top, y + top }, m_color, { u1, v1 } };
+        const sf::Vertex topRight { { x + right - italicShear * top, y + top }, m_color, { u2, v1 } };
+        const sf::Vertex bottomLeft { { x + left - italicShear * bottom, y + bottom }, m_color, { u1, v2 } };
+        const sf::Vertex bottomRight { { x + right - italicShear * bottom, y + bottom }, m_color, { u2, v2 } };
+
+        m_vertices.push_back(topLeft);
+        m_vertices.push_back(topRight);
+        m_vertices.push_back(bottomLeft);
+        m_vertices.push_back(bottomLeft);
+        m_vertices.push_back(topRight);
+        m_vertices.push_back(bottomRight);
+
+        x += glyph.advance;
+    }
+
+    m_characterVertexOffsets.push_back(m_vertices.size());
+}
+
+void game::CTextRenderComponent::applyColor() {
+    for (auto& vertex : m_vertices) {
+        vertex.color = m_color;
     }
-    return result;
 }
 
 game::CAnimatedSpriteRenderComponent::CAnimatedSpriteRenderComponent(const std::string& resourceName,
@@ -104,24 +192,35 @@ void game::CAnimatedSpriteRenderComponent::update(sf::RenderTarget& target, sf::
         return;
     }
 
-    m_sprite->setPosition(globalTransform.getPosition());
-    m_sprite->setScale(globalTransform.getScale());
-    m_sprite->setOrigin(globalTransform.getOrigin());
-
-    auto size = globalTransform.getSize();
+    // see CSpriteRenderComponent::update().
+    const bool transformChanged = globalTransform.getGeneration() != m_transformGeneration;
+    m_transformGeneration = globalTransform.getGeneration();
 
     m_frameControl.update(deltaTime);
     const auto currentFrame = m_frameControl.getCurrentFrame();
-    m_sprite->setTexture(currentFrame->rawTextureRef->texture);
+    const auto* frame = currentFrame.handle().get();
+    const bool frameChanged = frame != m_appliedFrame;
+
+    if (transformChanged || frameChanged) {
+        if (frameChanged) {
+            // frames of one animation usually share a sheet, sfml would reset the texture anyway.
+            if (&m_sprite->getTexture() != &currentFrame->rawTextureRef->texture) {
+                m_sprite->setTexture(currentFrame->rawTextureRef->texture);
+            }
+            m_appliedFrame = frame;
+        }
 
-    auto textureRect = m_frameControl.getCurrentFrame()->textureRect;
-    if (textureRect.has_value() &&
-        (textureRect.value().size.x >= static_cast<int>(size.x) && textureRect.value().size.y >= static_cast<int>(size.y))) {
-        m_sprite->setTextureRect(textureRect.value());
-    } else {
-        m_sprite->setTextureRect({{0, 0}, {static_cast<int>(size.x), static_cast<int>(size.y)}});
+        auto size = globalTransform.getSize();
+
+        auto textureRect = currentFrame->textureRect;
+        if (textureRect.has_value() &&
+            (textureRect.value().size.x >= static_cast<int>(size.x) && textureRect.value().size.y >= static_cast<int>(size.y))) {
+            m_sprite->setTextureRect(textureRect.value());
+        } else {
+            m_sprite->setTextureRect({{0, 0}, {static_cast<int>(size.x), static_cast<int>(size.y)}});
+        }
     }
-    target.draw(*m_sprite);
+    target.draw(*m_sprite, sf::RenderStates(globalTransform.getTransform()));
 }
 
 void game::CAnimatedSpriteRenderComponent::FrameControl::update(const sf::Time deltaTime) {
@@ -150,78 +249,319 @@ void game::CAnimatedSpriteRenderComponent::FrameControl::reset() {
 }
 
 void game::CTiledRenderComponent::addTile(TileIdType id, const SpriteFrame& frame) {
-    m_tileControl.m_tiles.insert({id, Tile {frame, id}});
+    addTile(Tile {frame, id});
 }
 
 void game::CTiledRenderComponent::addTile(Tile tile) {
+    const auto frameSize = TileControl::getFrameRect(tile.frame).size;
+    for (const auto& frame : tile.animationFrames) {
+        if (&frame.texture->rawTextureRef->texture != &tile.frame.texture->rawTextureRef->texture) {
+            throw std::runtime_error("CTiledRenderComponent: all frames of an animated tile must share the texture");
+        }
+        // a frame change only rewrites the texture coordinates, the quad keeps the size of the first frame.
+        if (TileControl::getFrameRect(frame).size != frameSize) {
+            throw std::runtime_error("CTiledRenderComponent: all frames of an animated tile must have the same size");
+        }
+    }
+    if (tile.isAnimated()) {
+        m_tileControl.m_animationStates.try_emplace(tile.id);
+    }
     m_tileControl.m_tiles.insert({tile.id, std::move(tile)});
 }
 
 void game::CTiledRenderComponent::addTile(TileIdType id, sf::Vector2i tilePlacement, sf::Vector2i tileSize) {
-    m_tileControl.m_tileItemList.emplace_back(id, tilePlacement, tileSize);
+    addTile(SingleTileItem {id, tilePlacement, tileSize});
 }
 
 void game::CTiledRenderComponent::addTile(const SingleTileItem& tileItem) {
-    m_tileControl.m_tileItemList.push_back(tileItem);
+    auto& chunk = m_tileControl.getChunk(getChunkCoord(tileItem.tilePlacement));
+    chunk.tileItems.push_back(tileItem);
+    chunk.dirty = true;
+}
+
+void game::CTiledRenderComponent::loadChunk(sf::Vector2i chunkCoord, std::vector<SingleTileItem> tileItems) {
+    auto& chunk = m_tileControl.getChunk(chunkCoord);
+    chunk.tileItems = std::move(tileItems);
+    chunk.dirty = true;
+}
+
+void game::CTiledRenderComponent::unloadChunk(sf::Vector2i chunkCoord) {
+    m_tileControl.removeChunk(chunkCoord);
+}
+
+bool game::CTiledRenderComponent::hasChunk(sf::Vector2i chunkCoord) const {
+    return m_tileControl.m_chunkLookup.find(getChunkKey(chunkCoord)) != m_tileControl.m_chunkLookup.end();
 }
 
-void game::CTiledRenderComponent::update(sf::RenderTarget& target, sf::Time deltaTime, sf::Vector2f position,
-    sf::Vector2f size, sf::Vector2f scale) {
-    // size will be ignored
+sf::Vector2i game::CTiledRenderComponent::getChunkCoord(sf::Vector2i tilePlacement) {
+    // floor division, so that negative placements end up in their own chunks.
+    auto floorDiv = [](int32_t value) {
+        return value >= 0 ? value / CHUNK_SIZE : (value - CHUNK_SIZE + 1) / CHUNK_SIZE;
+    };
+    return { floorDiv(tilePlacement.x), floorDiv(tilePlacement.y) };
+}
+
+uint64_t game::CTiledRenderComponent::getChunkKey(sf::Vector2i chunkCoord) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkCoord.x)) << 32) | static_cast<uint32_t>(chunkCoord.y);
+}
+
+void game::CTiledRenderComponent::update(sf::RenderTarget& target, sf::Time deltaTime, const CGlobalTransform& globalTransform) {
     m_tileControl.update(deltaTime);
 
-    for (auto& tileItem : m_tileControl.m_tileItemList) {
-        auto tile = m_tileControl.getTileById(tileItem.tileId);
-        if (!tileItem.sprite.has_value()) {
-            tileItem.sprite = sf::Sprite(tile.frame.texture->rawTextureRef->texture);
-            tileItem.sprite->setTextureRect(tile.frame.texture->textureRect.value());
-            // todo: implement tile animation
-            tileItem.sprite->setOrigin(m_tileControl.m_baseTilePixelSize * 0.5f);
+    // size will be ignored, the map is as large as its tiles.
+    sf::RenderStates states(globalTransform.getTransform());
 
-            auto placement = sf::Vector2f{
-                static_cast<float>(tileItem.tilePlacement.x) * m_tileControl.m_baseTilePixelSize.x,
-                static_cast<float>(tileItem.tilePlacement.y) * m_tileControl.m_baseTilePixelSize.y};
-            tileItem.sprite->setPosition(position + placement);
-            tileItem.sprite->setScale(scale);
+    const auto& view = target.getView();
+    const sf::FloatRect viewBounds { view.getCenter() - view.getSize() * 0.5f, view.getSize() };
+
+    for (auto& chunk : m_tileControl.m_chunks) {
+        if (chunk.dirty) {
+            m_tileControl.rebuildChunk(chunk);
+        }
+        if (chunk.batches.empty()) {
+            continue;
+        }
+        if (!states.transform.transformRect(chunk.localBounds).findIntersection(viewBounds).has_value()) {
+            continue;
+        }
+
+        for (const auto& batch : chunk.batches) {
+            states.texture = batch.texture;
+            target.draw(batch.vertices.data(), batch.vertices.size(), sf::PrimitiveType::Triangles, states);
         }
-        target.draw(*tileItem.sprite);
     }
 }
 
 void game::CTiledRenderComponent::TileControl::update(sf::Time deltaTime) {
-    // todo : implement tile animation
+    if (m_animationStates.empty()) {
+        return;
+    }
+
+    m_changedTiles.clear();
+    for (auto& [id, state] : m_animationStates) {
+        const auto& frames = getTileById(id).animationFrames;
+        state.elapsed += deltaTime;
+
+        bool changed = false;
+        while (frames[state.frameIndex].duration > sf::Time::Zero && state.elapsed >= frames[state.frameIndex].duration) {
+            state.elapsed -= frames[state.frameIndex].duration;
+            state.frameIndex = (state.frameIndex + 1) % frames.size();
+            changed = true;
+        }
+        if (changed) {
+            m_changedTiles.push_back(id);
+        }
+    }
+
+    if (m_changedTiles.empty()) {
+        return;
+    }
+
+    // only the quads of the tiles that moved on to another frame are touched,
+    // and only their texture coordinates.
+    for (auto& chunk : m_chunks) {
+        if (chunk.dirty) {
+            // picks up the current frames when it gets rebuilt anyway.
+            continue;
+        }
+        for (const auto& quad : chunk.animatedQuads) {
+            if (std::find(m_changedTiles.begin(), m_changedTiles.end(), quad.tileId) == m_changedTiles.end()) {
+                continue;
+            }
+            auto& vertices = chunk.batches[quad.batchIndex].vertices;
+            writeQuadTexCoords(&vertices[quad.vertexOffset], getCurrentFrame(getTileById(quad.tileId)));
+        }
+    }
 }
 
 void game::CTiledRenderComponent::TileControl::reset() {
-    // todo : implement tile animation
+    for (auto& [id, state] : m_animationStates) {
+        state = TileAnimationState {};
+    }
+    for (auto& chunk : m_chunks) {
+        chunk.dirty = true;
+    }
 }
 
 game::Tile& game::CTiledRenderComponent::TileControl::getTileById(TileIdType id) {
     return m_tiles.at(id);
 }
 
-void game::CShapeRenderComponent::update(sf::RenderTarget& target, const CGlobalTransform& globalTransform) const {
+const game::SpriteFrame& game::CTiledRenderComponent::TileControl::getCurrentFrame(const Tile& tile) const {
+    if (!tile.isAnimated()) {
+        return tile.frame;
+    }
+    return tile.animationFrames[m_animationStates.at(tile.id).frameIndex];
+}
+
+game::CTiledRenderComponent::TileChunk& game::CTiledRenderComponent::TileControl::getChunk(sf::Vector2i chunkCoord) {
+    auto [it, inserted] = m_chunkLookup.try_emplace(getChunkKey(chunkCoord), m_chunks.size());
+    if (inserted) {
+        m_chunks.emplace_back().chunkCoord = chunkCoord;
+    }
+    return m_chunks[it->second];
+}
+
+void game::CTiledRenderComponent::TileControl::removeChunk(sf::Vector2i chunkCoord) {
+    auto it = m_chunkLookup.find(getChunkKey(chunkCoord));
+    if (it == m_chunkLookup.end()) {
+        return;
+    }
+
+    // swap with the last one, so that only a single lookup entry has to be fixed.
+    const size_t index = it->second;
+    m_chunkLookup.erase(it);
+    if (index != m_chunks.size() - 1) {
+        m_chunks[index] = std::move(m_chunks.back());
+        m_chunkLookup[getChunkKey(m_chunks[index].chunkCoord)] = index;
+    }
+    m_chunks.pop_back();
+}
+
+void game::CTiledRenderComponent::TileControl::rebuildChunk(TileChunk& chunk) {
+    for (auto& batch : chunk.batches) {
+        batch.vertices.clear();
+    }
+    chunk.animatedQuads.clear();
+
+    sf::Vector2f min { std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    sf::Vector2f max { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+    for (const auto& tileItem : chunk.tileItems) {
+        const auto& tile = getTileById(tileItem.tileId);
+        const auto& frame = getCurrentFrame(tile);
+        const auto* texture = &frame.texture->rawTextureRef->texture;
+
+        // a chunk rarely uses more than a couple of textures, a linear search is fine.
+        auto batchIt = std::find_if(chunk.batches.begin(), chunk.batches.end(),
+            [texture](const TileBatch& batch) { return batch.texture == texture; });
+        if (batchIt == chunk.batches.end()) {
+            chunk.batches.push_back(TileBatch { texture, {} });
+            batchIt = chunk.batches.end() - 1;
+        }
+        const auto batchIndex = static_cast<size_t>(batchIt - chunk.batches.begin());
+
+        auto& vertices = batchIt->vertices;
+        const size_t vertexOffset = vertices.size();
+        vertices.resize(vertexOffset + 6);
+        writeQuad(&vertices[vertexOffset], tileItem, frame);
+
+        if (tile.isAnimated()) {
+            chunk.animatedQuads.push_back({ tile.id, batchIndex, vertexOffset });
+        }
+
+        // vertex 0 is the top-left corner, vertex 5 the bottom-right one.
+        const auto topLeft = vertices[vertexOffset].position;
+        const auto bottomRight = vertices[vertexOffset + 5].position;
+        min = { std::min(min.x, topLeft.x), std::min(min.y, topLeft.y) };
+        max = { std::max(max.x, bottomRight.x), std::max(max.y, bottomRight.y) };
+    }
+
+    // drop the batches whose texture is no longer used in this chunk.
+    chunk.batches.erase(
+        std::remove_if(chunk.batches.begin(), chunk.batches.end(),
+            [](const TileBatch& batch) { return batch.vertices.empty(); }),
+        chunk.batches.end());
+    if (!chunk.batches.empty()) {
+        chunk.localBounds = { min, max - min };
+    }
+    // the batch indices may have shifted.
+    if (!chunk.animatedQuads.empty()) {
+        for (auto& quad : chunk.animatedQuads) {
+            const auto* texture = &getCurrentFrame(getTileById(quad.tileId)).texture->rawTextureRef->texture;
+            quad.batchIndex = static_cast<size_t>(std::find_if(chunk.batches.begin(), chunk.batches.end(),
+                [texture](const TileBatch& batch) { return batch.texture == texture; }) - chunk.batches.begin());
+        }
+    }
+    chunk.dirty = false;
+}
+
+void game::CTiledRenderComponent::TileControl::writeQuad(sf::Vertex* quad, const SingleTileItem& tileItem, const SpriteFrame& frame) const {
+    // same placement as a sprite with its origin at the center of a base tile.
+    const sf::Vector2f topLeft {
+        static_cast<float>(tileItem.tilePlacement.x) * m_baseTilePixelSize.x - m_baseTilePixelSize.x * 0.5f,
+        static_cast<float>(tileItem.tilePlacement.y) * m_baseTilePixelSize.y - m_baseTilePixelSize.y * 0.5f
+    };
+    const sf::Vector2f size(getFrameRect(frame).size);
+
+    quad[0].position = topLeft;
+    quad[1].position = { topLeft.x + size.x, topLeft.y };
+    quad[2].position = { topLeft.x, topLeft.y + size.y };
+    quad[3].position = quad[2].position;
+    quad[4].position = quad[1].position;
+    quad[5].position = topLeft + size;
+
+    for (size_t i = 0; i < 6; i++) {
+        quad[i].color = sf::Color::White;
+    }
+    writeQuadTexCoords(quad, frame);
+}
+
+void game::CTiledRenderComponent::TileControl::writeQuadTexCoords(sf::Vertex* quad, const SpriteFrame& frame) {
+    const sf::FloatRect rect(getFrameRect(frame));
+    const auto topLeft = rect.position;
+    const auto bottomRight = rect.position + rect.size;
+
+    quad[0].texCoords = topLeft;
+    quad[1].texCoords = { bottomRight.x, topLeft.y };
+    quad[2].texCoords = { topLeft.x, bottomRight.y };
+    quad[3].texCoords = quad[2].texCoords;
+    quad[4].texCoords = quad[1].texCoords;
+    quad[5].texCoords = bottomRight;
+}
+
+sf::IntRect game::CTiledRenderComponent::TileControl::getFrameRect(const SpriteFrame& frame) {
+    if (frame.texture->textureRect.has_value()) {
+        return frame.texture->textureRect.value();
+    }
+    return { { 0, 0 }, sf::Vector2i(frame.texture->rawTextureRef->texture.getSize()) };
+}
+
+void game::CShapeRenderComponent::update(sf::RenderTarget& target, const CGlobalTransform& globalTransform) {
     if (!m_shape) {
         return;
     }
 
-    m_shape->setPosition(globalTransform.getPosition());
-    setShapeSize(m_shape.get(), globalTransform.getSize());
-    m_shape->setScale(globalTransform.getScale());
-    m_shape->setOrigin(globalTransform.getOrigin());
+    // resizing a shape rebuilds its outline, so it is skipped while the transform stays the same.
+    // the rest of the transform is handed over as it is when drawing.
+    if (globalTransform.getGeneration() != m_transformGeneration) {
+        setShapeSize(globalTransform.getSize());
+        m_transformGeneration = globalTransform.getGeneration();
+    }
 
-    target.draw(*m_shape);
+    target.draw(*m_shape, sf::RenderStates(globalTransform.getTransform()));
 }
 
-void game::CShapeRenderComponent::setShapeSize(sf::Shape* rawPtr, const sf::Vector2f& size) {
+game::CShapeRenderComponent::ShapeKind game::CShapeRenderComponent::resolveShapeKind(sf::Shape* rawPtr) {
+    // resolved once here, so that resizing on draw does not need any rtti.
+    if (rawPtr == nullptr) {
+        return ShapeKind::None;
+    }
+
+    // the global transform is applied when drawing, the shape's own has to stay the identity.
+    rawPtr->setPosition({ 0.f, 0.f });
+    rawPtr->setScale({ 1.f, 1.f });
+    rawPtr->setOrigin({ 0.f, 0.f });
+    rawPtr->setRotation(sf::Angle::Zero);
     if (dynamic_cast<sf::RectangleShape*>(rawPtr) != nullptr) {
-        dynamic_cast<sf::RectangleShape*>(rawPtr)->setSize(size);
-        return;
+        return ShapeKind::Rectangle;
     }
     if (dynamic_cast<sf::CircleShape*>(rawPtr) != nullptr) {
-        dynamic_cast<sf::CircleShape*>(rawPtr)->setRadius(size.x * 0.5f);
-        return;
+        return ShapeKind::Circle;
     }
-    throw std::runtime_error("CShapeRenderComponent::setShapeSize: unsupported shape type");
+    throw std::runtime_error("CShapeRenderComponent::resolveShapeKind: unsupported shape type");
     // todo: add other shapes
 }
+
+void game::CShapeRenderComponent::setShapeSize(const sf::Vector2f& size) const {
+    switch (m_shapeKind) {
+        case ShapeKind::Rectangle:
+            static_cast<sf::RectangleShape*>(m_shape.get())->setSize(size);
+            break;
+        case ShapeKind::Circle:
+            static_cast<sf::CircleShape*>(m_shape.get())->setRadius(size.x * 0.5f);
+            break;
+        case ShapeKind::None:
+            break;
+    }
+}
@@ -4,8 +4,11 @@
 
 #ifndef RENDER_HPP
 #define RENDER_HPP
+#include <cstdint>
 #include <entt/resource/resource.hpp>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common.hpp"
 #include "Logger.hpp"
@@ -13,6 +16,7 @@
 #include "SFML/Graphics/Shape.hpp"
 #include "SFML/Graphics/Sprite.hpp"
 #include "SFML/Graphics/Text.hpp"
+#include "SFML/Graphics/Vertex.hpp"
 #include "SFML/System/String.hpp"
 #include "SFML/System/Time.hpp"
 
@@ -20,7 +24,21 @@ namespace game {
     struct Texture;
     struct CGlobalTransform;
 
-    struct CRenderComponent {};
+    enum class RenderKind : uint8_t {
+        None,
+        Sprite,
+        AnimatedSprite,
+        Text,
+        Shape,
+        Tiled,
+    };
+
+    // the kind is resolved by SRenderSystem whenever this or a renderable component is constructed or destroyed,
+    // so that the render loop can dispatch without probing every renderable storage with any_of.
+    // the data of the renderable itself is still looked up in its storage, once per draw.
+    struct CRenderComponent {
+        RenderKind kind { RenderKind::None };
+    };
 
     // specify the layer for the component to be rendered
     struct CRenderLayerComponent {
@@ -44,6 +62,11 @@ namespace game {
         static constexpr size_t GameComponent = (1 << 0);
         static constexpr size_t UI = (1 << 1);
         static constexpr size_t SmallMap = (1 << 2);
+        /**
+         * content of the small map that never moves, e.g. the map layers.
+         * it is baked into a cached texture instead of being redrawn with every small map refresh.
+         */
+        static constexpr size_t SmallMapStatic = (1 << 3);
 
         void setTargetId(size_t targetId) { m_targetId = targetId; }
         [[nodiscard]] size_t getTargetId() const { return m_targetId; }
@@ -74,37 +97,91 @@ namespace game {
     private:
         entt::resource<SpriteFrame> m_frame;
         std::optional<sf::Sprite> m_sprite;
+
+        // what the sprite was last built from, the setters are skipped while these match.
+        uint64_t m_transformGeneration { 0 };
+        const SpriteFrame* m_appliedFrame { nullptr };
     };
 
     struct CTextRenderComponent {
         CTextRenderComponent(const std::string& resourceName, sf::Font&& font);
         explicit CTextRenderComponent(entt::resource<sf::Font> font) : m_font(std::move(font)) {}
 
-        void setFont(entt::resource<sf::Font> font) { m_font = std::move(font); }
+        // the setters only invalidate the cached layout when the value actually changes,
+        // so it is fine to call them every frame.
+
+        void setFont(entt::resource<sf::Font> font) {
+            if (m_font.handle() != font.handle()) {
+                m_font = std::move(font);
+                m_layoutDirty = true;
+            }
+        }
         [[nodiscard]] entt::resource<sf::Font> getFont() const { return m_font; }
 
-        void setColor(sf::Color color) { m_color = color; }
+        void setColor(sf::Color color) {
+            if (m_color != color) {
+                m_color = color;
+                m_colorDirty = true;
+            }
+        }
         [[nodiscard]] sf::Color getColor() const { return m_color; }
 
-        void setStyle(sf::Text::Style style) { m_style = style; }
+        void setStyle(sf::Text::Style style) {
+            if (m_style != style) {
+                m_style = style;
+                m_layoutDirty = true;
+            }
+        }
         [[nodiscard]] sf::Text::Style getStyle() const { return m_style; }
 
-        void setText(const sf::String& text) { m_text = text; }
+        void setText(const sf::String& text) {
+            if (m_text != text) {
+                m_text = text;
+                m_layoutDirty = true;
+            }
+        }
         [[nodiscard]] const sf::String& getText() const { return m_text; }
 
-        void setTextSize(size_t textSize) { m_textSize = textSize; }
+        void setTextSize(size_t textSize) {
+            if (m_textSize != textSize) {
+                m_textSize = textSize;
+                m_layoutDirty = true;
+            }
+        }
         [[nodiscard]] size_t getTextSize() const { return m_textSize; }
 
+        /**
+         * Only the first revealCount characters of the text are drawn, e.g. for a typewriter effect.
+         * This doesn't touch the layout, it only changes how many vertices are submitted.
+         * @param revealCount number of characters to draw, ALL_CHARACTERS to draw everything
+         */
+        void setRevealCount(size_t revealCount) { m_revealCount = revealCount; }
+        [[nodiscard]] size_t getRevealCount() const { return m_revealCount; }
+
+        static constexpr size_t ALL_CHARACTERS = static_cast<size_t>(-1);
+
         void update(sf::RenderTarget& target, const CGlobalTransform& globalTransform);
     private:
         entt::resource<sf::Font> m_font;
-        std::optional<sf::Text> m_textSprite { std::nullopt };
         sf::String m_text;
         sf::Color m_color { sf::Color::White };
         sf::Text::Style m_style { sf::Text::Style::Regular };
         size_t m_textSize { 16 };
+        size_t m_revealCount { ALL_CHARACTERS };
 
-        sf::String processText(const sf::String& text, const sf::Vector2f& regionSize) const;
+        // the layout is keyed by (text, font, size, style) through m_layoutDirty,
+        // and by the region width, which comes from the transform.
+        bool m_layoutDirty { true };
+        bool m_colorDirty { true };
+        float m_layoutWidth { -1.f };
+
+        // glyph quads in local space, textured from the font's glyph atlas of m_textSize.
+        std::vector<sf::Vertex> m_vertices;
+        // vertex offset of every character, plus one for the end, so that a reveal is a lookup.
+        std::vector<size_t> m_characterVertexOffsets;
+
+        void rebuildGeometry(float regionWidth);
+        void applyColor();
     };
 
     struct AnimatedFrames {
@@ -163,27 +240,46 @@ namespace game {
 
         FrameControl m_frameControl { entt::resource<AnimatedFrames>(nullptr), false};
         std::optional<sf::Sprite> m_sprite;
+
+        // what the sprite was last built from, the setters are skipped while these match.
+        uint64_t m_transformGeneration { 0 };
+        const Texture* m_appliedFrame { nullptr };
     };
 
     using TileIdType = uint32_t;
     struct Tile {
         SpriteFrame frame;
         TileIdType id {};
+        /**
+         * Frames of an animated tile, played in a loop with the duration of each frame.
+         * All of them must come from the same texture, as the tiles are batched by texture,
+         * and have the same size, as a frame change only swaps the texture coordinates.
+         */
+        std::vector<SpriteFrame> animationFrames {};
 
         Tile(const SpriteFrame& frame, TileIdType id) : frame(frame), id(id) {}
+        Tile(std::vector<SpriteFrame> frames, TileIdType id)
+            : frame(frames.front()), id(id), animationFrames(std::move(frames)) {}
+
+        [[nodiscard]] bool isAnimated() const { return animationFrames.size() > 1; }
     };
 
     struct SingleTileItem {
         TileIdType tileId;
         sf::Vector2i tilePlacement;
         sf::Vector2i tileSize;
-        std::optional<sf::Sprite> sprite;
 
         SingleTileItem(TileIdType tileId, sf::Vector2i tilePlacement, sf::Vector2i tileSize)
             : tileId(tileId), tilePlacement(tilePlacement), tileSize(tileSize) {}
     };
 
     struct CTiledRenderComponent {
+        /**
+         * Tiles are grouped into square chunks of this many tiles per side.
+         * Every chunk is baked into one vertex array per texture, and is skipped when it is out of view.
+         */
+        static constexpr int32_t CHUNK_SIZE = 32;
+
         explicit CTiledRenderComponent(sf::Vector2f baseTilePixelSize) : m_tileControl(baseTilePixelSize) {}
         void addTile(TileIdType id, const SpriteFrame& frame);
         void addTile(Tile tile);
@@ -191,17 +287,76 @@ namespace game {
         void addTile(TileIdType id, sf::Vector2i tilePlacement, sf::Vector2i tileSize);
         void addTile(const SingleTileItem& tileItem);
 
-        void update(sf::RenderTarget& target, sf::Time deltaTime,
-            sf::Vector2f position, sf::Vector2f size, sf::Vector2f scale);
+        /**
+         * Replaces the content of a whole chunk at once, used when streaming a map in.
+         * @param chunkCoord chunk coordinates, see getChunkCoord()
+         * @param tileItems tiles of the chunk, all of them must be placed inside of it
+         */
+        void loadChunk(sf::Vector2i chunkCoord, std::vector<SingleTileItem> tileItems);
+        void unloadChunk(sf::Vector2i chunkCoord);
+        [[nodiscard]] bool hasChunk(sf::Vector2i chunkCoord) const;
+        [[nodiscard]] size_t getChunkCount() const { return m_tileControl.m_chunks.size(); }
+
+        template <typename Fn>
+        void forEachChunk(Fn&& fn) const {
+            for (const auto& chunk : m_tileControl.m_chunks) {
+                fn(chunk.chunkCoord);
+            }
+        }
+
+        static sf::Vector2i getChunkCoord(sf::Vector2i tilePlacement);
+        static uint64_t getChunkKey(sf::Vector2i chunkCoord);
+
+        void update(sf::RenderTarget& target, sf::Time deltaTime, const CGlobalTransform& globalTransform);
     private:
+        struct TileBatch {
+            const sf::Texture* texture { nullptr };
+            std::vector<sf::Vertex> vertices;
+        };
+
+        /**
+         * where the quad of an animated tile lives, so that a frame change only rewrites these vertices.
+         */
+        struct AnimatedTileQuad {
+            TileIdType tileId;
+            size_t batchIndex;
+            size_t vertexOffset;
+        };
+
+        struct TileChunk {
+            sf::Vector2i chunkCoord;
+            std::vector<SingleTileItem> tileItems;
+            std::vector<TileBatch> batches;
+            std::vector<AnimatedTileQuad> animatedQuads;
+            sf::FloatRect localBounds;
+            bool dirty { true };
+        };
+
+        struct TileAnimationState {
+            size_t frameIndex { 0 };
+            sf::Time elapsed;
+        };
+
         struct TileControl {
             std::unordered_map<TileIdType, Tile> m_tiles {};
-            std::vector<SingleTileItem> m_tileItemList {};
             sf::Vector2f m_baseTilePixelSize;
 
+            std::vector<TileChunk> m_chunks {};
+            std::unordered_map<uint64_t, size_t> m_chunkLookup {};
+            std::unordered_map<TileIdType, TileAnimationState> m_animationStates {};
+            std::vector<TileIdType> m_changedTiles {};
+
             void update(sf::Time deltaTime);
             void reset();
             Tile& getTileById(TileIdType id);
+            [[nodiscard]] const SpriteFrame& getCurrentFrame(const Tile& tile) const;
+
+            TileChunk& getChunk(sf::Vector2i chunkCoord);
+            void removeChunk(sf::Vector2i chunkCoord);
+            void rebuildChunk(TileChunk& chunk);
+            void writeQuad(sf::Vertex* quad, const SingleTileItem& tileItem, const SpriteFrame& frame) const;
+            static void writeQuadTexCoords(sf::Vertex* quad, const SpriteFrame& frame);
+            static sf::IntRect getFrameRect(const SpriteFrame& frame);
 
             explicit TileControl(sf::Vector2f baseTilePixelSize) : m_baseTilePixelSize(baseTilePixelSize) {};
         };
@@ -210,14 +365,30 @@ namespace game {
     };
 
     struct CShapeRenderComponent {
-        explicit CShapeRenderComponent(std::unique_ptr<sf::Shape> shape) : m_shape(std::move(shape)) {}
-        void update(sf::RenderTarget& target, const CGlobalTransform& globalTransform) const;
+        enum class ShapeKind : uint8_t {
+            None,
+            Rectangle,
+            Circle,
+        };
+
+        explicit CShapeRenderComponent(std::unique_ptr<sf::Shape> shape)
+            : m_shapeKind(resolveShapeKind(shape.get())), m_shape(std::move(shape)) {}
+        void update(sf::RenderTarget& target, const CGlobalTransform& globalTransform);
 
-        void setShape(std::unique_ptr<sf::Shape> shape) { m_shape = std::move(shape); }
+        void setShape(std::unique_ptr<sf::Shape> shape) {
+            m_shapeKind = resolveShapeKind(shape.get());
+            m_shape = std::move(shape);
+            m_transformGeneration = 0;
+        }
         [[nodiscard]] sf::Shape* getShape() const { return m_shape.get(); }
+        [[nodiscard]] ShapeKind getShapeKind() const { return m_shapeKind; }
     private:
+        ShapeKind m_shapeKind { ShapeKind::None };
         std::unique_ptr<sf::Shape> m_shape { nullptr };
-        static void setShapeSize(sf::Shape* rawPtr, const sf::Vector2f& size);
+        uint64_t m_transformGeneration { 0 };
+
+        static ShapeKind resolveShapeKind(sf::Shape* rawPtr);
+        void setShapeSize(const sf::Vector2f& size) const;
     };
 } // game
 
@@ -4,43 +4,46 @@
 
 #ifndef SCENETREE_HPP
 #define SCENETREE_HPP
-#include <set>
+#include <cstddef>
 #include <entt/entity/entity.hpp>
 
 namespace game {
     struct CNode {};
     struct CUnmount {};
 
+    class SceneTreeUtils;
+
+    // the hierarchy is an intrusive list: a parent knows its first child,
+    // and every child links to its siblings. nothing is allocated per child.
+    // the links are maintained by SceneTreeUtils, use SceneTreeUtils::forEachChild() to walk them.
+
     struct CParent {
         CParent() = default;
-        explicit CParent(const entt::entity parent) : m_parent(parent) {}
 
-        void setParent(const entt::entity parent) { m_parent = parent; }
         [[nodiscard]] entt::entity getParent() const { return m_parent; }
+        [[nodiscard]] entt::entity getPreviousSibling() const { return m_previousSibling; }
+        [[nodiscard]] entt::entity getNextSibling() const { return m_nextSibling; }
     private:
+        friend class SceneTreeUtils;
+
         entt::entity m_parent { entt::null };
+        entt::entity m_previousSibling { entt::null };
+        entt::entity m_nextSibling { entt::null };
     };
 
     struct CChild {
         CChild() = default;
-        explicit CChild(const entt::entity child) { m_children.insert(child); }
-        explicit CChild(const std::set<entt::entity>& children) { m_children.insert(children.begin(), children.end()); }
-
-        void addChild(const entt::entity child) { m_children.insert(child); }
-        void removeChild(const entt::entity child) { m_children.erase(child); }
 
-        [[nodiscard]] const std::set<entt::entity>& getChildren() const { return m_children; }
-        [[nodiscard]] bool hasChild(const entt::entity child) const { return m_children.find(child) != m_children.end(); }
-
-        void clearChildren() { m_children.clear(); }
-
-        [[nodiscard]] bool hasChildren() const { return !m_children.empty(); }
+        [[nodiscard]] entt::entity getFirstChild() const { return m_firstChild; }
+        [[nodiscard]] size_t getChildCount() const { return m_childCount; }
+        [[nodiscard]] bool hasChildren() const { return m_firstChild != entt::null; }
 
     private:
-        std::set<entt::entity> m_children {};
-    };
+        friend class SceneTreeUtils;
 
-    struct CSceneElementNeedsUpdate {};
+        entt::entity m_firstChild { entt::null };
+        size_t m_childCount { 0 };
+    };
 }
 
 #endif //SCENETREE_HPP
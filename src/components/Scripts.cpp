@@ -15,10 +15,15 @@ game::CScriptsComponent::CScriptsComponent(entt::delegate<void(entt::entity)> in
 }
 
 void game::CScriptsComponent::invokeOnce(entt::entity entity) {
-    if (m_invokeOnce.has_value()) {
-        m_invokeOnce.value()(entity);
+    if (m_onceInvoked) {
+        return;
+    }
+    // the delegate is kept, resetSchedule() arms it again for a reused entity.
+    // marked before the call, as the script may emplace components and move this one.
+    m_onceInvoked = true;
+    if (const auto once = m_invokeOnce; once.has_value()) {
+        once.value()(entity);
     }
-    m_invokeOnce = std::nullopt;
 }
 
 void game::CScriptsComponent::invokeUpdate(entt::entity entity, sf::Time deltaTime) const {
@@ -26,3 +31,9 @@ void game::CScriptsComponent::invokeUpdate(entt::entity entity, sf::Time deltaTi
         m_invokeUpdate.value()(entity, deltaTime);
     }
 }
+
+void game::CScriptsComponent::resetSchedule() {
+    m_onceInvoked = false;
+    m_updateRequested = false;
+    m_pendingTime = sf::Time::Zero;
+}
@@ -4,6 +4,8 @@
 
 #ifndef SCRIPTS_HPP
 #define SCRIPTS_HPP
+#include <algorithm>
+#include <cstdint>
 #include <optional>
 #include <entt/entity/entity.hpp>
 #include <entt/signal/delegate.hpp>
@@ -21,11 +23,46 @@ namespace game {
         void invokeOnce(entt::entity entity);
         void invokeUpdate(entt::entity entity, sf::Time deltaTime) const;
 
-        void setInvokeOnce(entt::delegate<void(entt::entity)> invokeOnce) { m_invokeOnce = invokeOnce; }
+        void setInvokeOnce(entt::delegate<void(entt::entity)> invokeOnce) { m_invokeOnce = invokeOnce; m_onceInvoked = false; }
         void setInvokeUpdate(entt::delegate<void(entt::entity, sf::Time)> invokeUpdate) { m_invokeUpdate = invokeUpdate; };
+
+        /**
+         * Runs the update script only every interval frames, 1 means every frame.
+         * The delta time it gets is the time since it last ran.
+         * Scripts with an interval above 1 are subject to the frame budget of SScriptsSystem.
+         */
+        void setUpdateInterval(uint32_t interval) { m_updateInterval = std::max(interval, 1u); }
+        [[nodiscard]] uint32_t getUpdateInterval() const { return m_updateInterval; }
+
+        /**
+         * Which of the interval frames the script runs on.
+         * Defaults to the entity index, which spreads the scripts of a batch evenly over the frames.
+         */
+        void setPhase(uint32_t phase) { m_phase = phase; }
+        [[nodiscard]] std::optional<uint32_t> getPhase() const { return m_phase; }
+
+        /**
+         * Runs the update script on the next frame, whatever its interval is.
+         */
+        void requestUpdate() { m_updateRequested = true; }
+
+        /**
+         * Puts the scheduling back to how a freshly built component starts:
+         * the once script runs again, no update is requested and no time is pending.
+         * PrefabPool calls this when a parked subtree is reused.
+         */
+        void resetSchedule();
     private:
+        friend class SScriptsSystem;
+
         std::optional<entt::delegate<void(entt::entity)>> m_invokeOnce;
         std::optional<entt::delegate<void(entt::entity, sf::Time)>> m_invokeUpdate;
+
+        uint32_t m_updateInterval { 1 };
+        std::optional<uint32_t> m_phase;
+        bool m_onceInvoked { false };
+        bool m_updateRequested { false };
+        sf::Time m_pendingTime;
     };
 
     using InvokeOnceDelegate = entt::delegate<void(entt::entity)>;
@@ -0,0 +1,69 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TILESTREAMING_HPP
+#define TILESTREAMING_HPP
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+#include "components/Render.hpp"
+#include "utils/TileMapFile.hpp"
+
+namespace game {
+    class STileStreamingSystem;
+
+    /**
+     * Streams the chunks of a TileMapFile into the CTiledRenderComponent of the same entity,
+     * keeping only the chunks around the view resident.
+     */
+    struct CTileMapStreamComponent {
+        explicit CTileMapStreamComponent(std::shared_ptr<const TileMapFile> mapFile)
+            : m_mapFile(std::move(mapFile)), m_queue(std::make_shared<DecodedQueue>()) {}
+
+        [[nodiscard]] const TileMapFile& getMapFile() const { return *m_mapFile; }
+
+        /**
+         * Chunks around the view center, on each side, that should be resident.
+         */
+        void setStreamRadius(int32_t streamRadius) { m_streamRadius = streamRadius; }
+        [[nodiscard]] int32_t getStreamRadius() const { return m_streamRadius; }
+
+        /**
+         * Upper limit of resident chunks, the ones closest to the view center are kept.
+         */
+        void setResidencyBudget(size_t residencyBudget) { m_residencyBudget = residencyBudget; }
+        [[nodiscard]] size_t getResidencyBudget() const { return m_residencyBudget; }
+
+    private:
+        friend class STileStreamingSystem;
+
+        struct DecodedChunk {
+            sf::Vector2i chunkCoord;
+            std::vector<SingleTileItem> tileItems;
+            // false if the chunk is corrupt, it is not installed then.
+            bool isValid { true };
+        };
+
+        // filled by the workers, drained on the main thread.
+        // shared with the decoding tasks, so that it outlives the component if the entity goes away first.
+        struct DecodedQueue {
+            std::mutex mutex;
+            std::vector<DecodedChunk> chunks;
+        };
+
+        std::shared_ptr<const TileMapFile> m_mapFile;
+        std::shared_ptr<DecodedQueue> m_queue;
+        std::unordered_set<uint64_t> m_pendingChunks;
+        // corrupt chunks, not requested again.
+        std::unordered_set<uint64_t> m_failedChunks;
+
+        int32_t m_streamRadius { 2 };
+        size_t m_residencyBudget { 36 };
+    };
+} // game
+
+#endif //TILESTREAMING_HPP
@@ -8,33 +8,33 @@
 #include <algorithm>
 
 namespace game {
-    float CTweenComponent::EasingFunction::quadratic(float progress) {
+    float EasingFunction::quadratic(float progress) {
         if (progress < 0.5f) {
             return 2.0f * progress * progress;
         }
         return 1.0f - std::pow(-2.0f * progress + 2.0f, 2) / 2.0f;
     }
 
-    float CTweenComponent::EasingFunction::cubic(float progress) {
+    float EasingFunction::cubic(float progress) {
         if (progress < 0.5f) {
             return 4.0f * progress * progress * progress;
         }
         return 1.0f - std::pow(-2.0f * progress + 2.0f, 3) / 2.0f;
     }
 
-    float CTweenComponent::EasingFunction::quartic(float progress) {
+    float EasingFunction::quartic(float progress) {
         if (progress < 0.5f) {
             return 8.0f * progress * progress * progress * progress;
         }
         return 1.0f - std::pow(-2.0f * progress + 2.0f, 4) / 2.0f;
     }
 
-    float CTweenComponent::EasingFunction::sine(float progress) {
+    float EasingFunction::sine(float progress) {
         constexpr float pi = 3.14159265358979323846f;
         return -(std::cos(pi * progress) - 1.0f) / 2.0f;
     }
 
-    float CTweenComponent::EasingFunction::exponential(float progress) {
+    float EasingFunction::exponential(float progress) {
         if (progress == 0.0f) return 0.0f;
         if (progress == 1.0f) return 1.0f;
         if (progress < 0.5f) {
@@ -43,46 +43,61 @@ namespace game {
         return (2.0f - std::pow(2.0f, -20.0f * progress + 10.0f)) / 2.0f;
     }
 
-    float CTweenComponent::EasingFunction::circular(float progress) {
+    float EasingFunction::circular(float progress) {
         if (progress < 0.5f) {
             return (1.0f - std::sqrt(1.0f - std::pow(2.0f * progress, 2))) / 2.0f;
         }
         return (std::sqrt(1.0f - std::pow(-2.0f * progress + 2.0f, 2)) + 1.0f) / 2.0f;
     }
 
-    void CTweenComponent::update(entt::entity entity, sf::Time deltaTime) {
-        if (!m_running) {
-            return;
+    float EasingFunction::evaluate(const Easing easing, const float progress) {
+        switch (easing) {
+            case Easing::Quadratic:
+                return quadratic(progress);
+            case Easing::Cubic:
+                return cubic(progress);
+            case Easing::Quartic:
+                return quartic(progress);
+            case Easing::Sine:
+                return sine(progress);
+            case Easing::Exponential:
+                return exponential(progress);
+            case Easing::Circular:
+                return circular(progress);
+            default:
+                return linear(progress);
         }
+    }
 
-        m_elapsed += deltaTime;
-        if (m_elapsed < m_delay) {
-            return;
-        }
-
-        const auto realElapsed = m_elapsed - m_delay;
-
-        if (realElapsed >= m_duration) {
-            //m_elapsed = sf::Time::Zero;
-            m_running = false;
-            if (m_completionCallback) {
-                m_completionCallback(entity);
-            }
-            return;
-        }
+    Timeline& Timeline::then(const entt::entity entity, const TweenSpec& spec) {
+        m_stepStart = m_cursor;
+        add(entity, spec, m_stepStart);
+        return *this;
+    }
 
-        float progress = std::clamp(realElapsed.asSeconds() / m_duration.asSeconds(), 0.f, 1.f);
-        if (m_callback) {
-            m_callback(entity, m_easingFunction(progress) * (m_endValue - m_beginValue) + m_beginValue);
-        }
+    Timeline& Timeline::with(const entt::entity entity, const TweenSpec& spec) {
+        add(entity, spec, m_stepStart);
+        return *this;
     }
 
-    void CTweenComponent::restart() {
-        m_elapsed = sf::Time::Zero;
-        m_running = true;
+    Timeline& Timeline::wait(const sf::Time delay) {
+        m_cursor += delay.asSeconds();
+        m_stepStart = m_cursor;
+        return *this;
     }
 
-    float CTweenComponent::getRatioValue() const {
-        return m_easingFunction(m_elapsed.asSeconds() / m_duration.asSeconds());
+    void Timeline::add(const entt::entity entity, const TweenSpec& spec, const float start) {
+        TimelineSegment segment;
+        segment.entity = entity;
+        segment.target = spec.getTarget();
+        segment.easing = spec.getEasing();
+        segment.writer = spec.getWriter();
+        segment.from = spec.getFrom();
+        segment.to = spec.getTo();
+        segment.start = start + spec.getDelay().asSeconds();
+        segment.end = segment.start + spec.getDuration().asSeconds();
+
+        m_cursor = std::max(m_cursor, segment.end);
+        m_segments.push_back(segment);
     }
 } // game
\ No newline at end of file
@@ -4,84 +4,296 @@
 
 #ifndef TWEENING_HPP
 #define TWEENING_HPP
-#include <functional>
-#include <utility>
-#include <entt/entity/entity.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <entt/entity/registry.hpp>
+#include <entt/signal/delegate.hpp>
 
 #include "SFML/System/Time.hpp"
+#include "SFML/System/Vector2.hpp"
 
 namespace game {
+    /**
+     * The set is closed on purpose, the tween engine keeps one pool per easing
+     * and evaluates each pool in a single batched loop.
+     */
+    enum class Easing : uint8_t {
+        Linear,
+        Quadratic,
+        Cubic,
+        Quartic,
+        Sine,
+        Exponential,
+        Circular,
+        Count
+    };
+
+    struct EasingFunction {
+        static float linear(float progress) { return progress; }
+        static float quadratic(float progress);
+        static float cubic(float progress);
+        static float quartic(float progress);
+        static float sine(float progress);
+        static float exponential(float progress);
+        static float circular(float progress);
+
+        static float evaluate(Easing easing, float progress);
+    };
+
+    /**
+     * What a tween writes its value to. Scalar targets only use x of the range.
+     */
+    enum class TweenTarget : uint8_t {
+        // nothing, only the completion callback.
+        None,
+        Position,
+        Size,
+        Scale,
+        // 0~1, of the sprite, text or shape of the entity.
+        Alpha,
+        // a component field or setter, see TweenSpec::bind().
+        Binding,
+    };
 
-    struct CTweenComponent {
-        struct EasingFunction {
-            static float linear(float progress) { return progress; }
-            static float quadratic(float progress);
-            static float cubic(float progress);
-            static float quartic(float progress);
-            static float sine(float progress);
-            static float exponential(float progress);
-            static float circular(float progress);
+    /**
+     * Writes a tween value to a component of the entity, instantiated by TweenSpec::bind().
+     */
+    using TweenWriter = void (*)(entt::registry& registry, entt::entity entity, sf::Vector2f value);
+
+    namespace detail {
+        template <typename>
+        struct TweenMember;
+
+        template <typename Component, typename Value>
+        struct TweenMember<Value Component::*> {
+            using component_type = Component;
+            using value_type = Value;
         };
 
-        CTweenComponent() = default;
-        CTweenComponent(float beginValue, float endValue)
-            : m_beginValue(beginValue), m_endValue(endValue) {}
+        template <typename Component, typename Return, typename Value>
+        struct TweenMember<Return (Component::*)(Value)> {
+            using component_type = Component;
+            using value_type = std::decay_t<Value>;
+        };
 
-        void setDuration(sf::Time duration) { m_duration = duration; }
-        [[nodiscard]] sf::Time getDuration() const { return m_duration; }
+        template <typename Value>
+        Value convertTweenValue(const sf::Vector2f value) {
+            if constexpr (std::is_same_v<Value, sf::Vector2f>) {
+                return value;
+            } else if constexpr (std::is_unsigned_v<Value>) {
+                // counts round up, so that the first step shows up as soon as the tween starts.
+                return static_cast<Value>(std::ceil(std::max(value.x, 0.f)));
+            } else if constexpr (std::is_integral_v<Value>) {
+                return static_cast<Value>(std::ceil(value.x));
+            } else {
+                return static_cast<Value>(value.x);
+            }
+        }
 
-        void setDelay(sf::Time delay) { m_delay = delay; }
-        [[nodiscard]] sf::Time getDelay() const { return m_delay; }
+        template <auto Member>
+        void writeTweenMember(entt::registry& registry, const entt::entity entity, const sf::Vector2f value) {
+            using Traits = TweenMember<decltype(Member)>;
+            using Value = typename Traits::value_type;
+            static_assert(std::is_arithmetic_v<Value> || std::is_same_v<Value, sf::Vector2f>,
+                "only arithmetic and sf::Vector2f members can be tweened");
 
-        void setBeginValue(float beginValue) { m_beginValue = beginValue; }
-        [[nodiscard]] float getBeginValue() const { return m_beginValue; }
+            if (auto* component = registry.try_get<typename Traits::component_type>(entity)) {
+                if constexpr (std::is_member_function_pointer_v<decltype(Member)>) {
+                    (component->*Member)(convertTweenValue<Value>(value));
+                } else {
+                    component->*Member = convertTweenValue<Value>(value);
+                }
+            }
+        }
+    }
+
+    struct TweenHandle {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t index { INVALID_INDEX };
+        uint32_t generation { 0 };
+    };
+
+    using TweenCompletionDelegate = entt::delegate<void(entt::entity)>;
+
+    struct TweenSpec {
+        TweenSpec() = default;
 
-        void setEndValue(float endValue) { m_endValue = endValue; }
-        [[nodiscard]] float getEndValue() const { return m_endValue; }
+        TweenSpec& setTarget(const TweenTarget target) {
+            m_target = target;
+            return *this;
+        }
+
+        TweenSpec& setEasing(const Easing easing) {
+            m_easing = easing;
+            return *this;
+        }
+
+        TweenSpec& setRange(const sf::Vector2f from, const sf::Vector2f to) {
+            m_from = from;
+            m_to = to;
+            return *this;
+        }
 
-        void setRange(float beginValue, float endValue) {
-            m_beginValue = beginValue;
-            m_endValue = endValue;
+        TweenSpec& setRange(const float from, const float to) {
+            return setRange(sf::Vector2f { from, 0.f }, sf::Vector2f { to, 0.f });
         }
-        [[nodiscard]] std::pair<float, float> getRange() const { return { m_beginValue, m_endValue }; }
 
-        void setEasingFunction(std::function<float(float progress)> easingFunction) { m_easingFunction = std::move(easingFunction); }
-        void setCallback(std::function<void(entt::entity entity, float value)> callback) { m_callback = std::move(callback); }
-        void setCompletionCallback(std::function<void(entt::entity entity)> callback) { m_completionCallback = std::move(callback); }
+        TweenSpec& setDuration(const sf::Time duration) {
+            m_duration = duration;
+            return *this;
+        }
 
-        [[nodiscard]] float getRatioValue() const;
+        TweenSpec& setDelay(const sf::Time delay) {
+            m_delay = delay;
+            return *this;
+        }
 
-        template <typename Fn, std::enable_if_t<std::is_invocable_v<Fn>, int> = 0>
-        void setEasingFunction(Fn&& easingFunction) {
-            m_easingFunction = std::function<float(float)>(std::forward<Fn>(easingFunction));
+        /**
+         * Tweens a field or a single argument setter of a component, e.g. bind<&CTextRenderComponent::setRevealCount>().
+         * Scalars take x of the range. Nothing is marked dirty, use the typed targets for the transforms.
+         */
+        template <auto Member>
+        TweenSpec& bind() {
+            m_target = TweenTarget::Binding;
+            m_writer = &detail::writeTweenMember<Member>;
+            return *this;
         }
 
-        template <typename Fn, std::enable_if_t<std::is_invocable_v<Fn, float>, int> = 0>
-        void setCallback(Fn&& callback) {
-            m_callback = std::function<void(entt::entity, float)>(std::forward<Fn>(callback));
+        /**
+         * Called with the entity once the tween has finished, after the last value has been applied.
+         */
+        template <auto Candidate>
+        TweenSpec& setCompletionCallback() {
+            m_onComplete.connect<Candidate>();
+            return *this;
         }
 
-        template <typename Fn, std::enable_if_t<std::is_invocable_v<Fn>, int> = 0>
-        void setCompletionCallback(Fn&& callback) {
-            m_completionCallback = std::function<void(entt::entity)>(std::forward<Fn>(callback));
+        TweenSpec& setCompletionCallback(const TweenCompletionDelegate onComplete) {
+            m_onComplete = onComplete;
+            return *this;
         }
 
-        void update(entt::entity entity, sf::Time deltaTime);
-        void restart();
+        [[nodiscard]] TweenTarget getTarget() const { return m_target; }
+        [[nodiscard]] Easing getEasing() const { return m_easing; }
+        [[nodiscard]] sf::Vector2f getFrom() const { return m_from; }
+        [[nodiscard]] sf::Vector2f getTo() const { return m_to; }
+        [[nodiscard]] sf::Time getDuration() const { return m_duration; }
+        [[nodiscard]] sf::Time getDelay() const { return m_delay; }
+        [[nodiscard]] TweenCompletionDelegate getCompletionCallback() const { return m_onComplete; }
+        [[nodiscard]] TweenWriter getWriter() const { return m_writer; }
 
     private:
+        TweenTarget m_target { TweenTarget::None };
+        Easing m_easing { Easing::Linear };
+        sf::Vector2f m_from { 0.f, 0.f };
+        sf::Vector2f m_to { 1.f, 0.f };
         sf::Time m_duration;
-        sf::Time m_elapsed;
         sf::Time m_delay;
+        TweenCompletionDelegate m_onComplete;
+        TweenWriter m_writer { nullptr };
+    };
+
+    struct TimelineHandle {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t index { INVALID_INDEX };
+        uint32_t generation { 0 };
+    };
+
+    /**
+     * One keyframe span of a timeline, times are in seconds from the start of the timeline.
+     */
+    struct TimelineSegment {
+        entt::entity entity { entt::null };
+        TweenTarget target { TweenTarget::None };
+        Easing easing { Easing::Linear };
+        TweenWriter writer { nullptr };
+        sf::Vector2f from;
+        sf::Vector2f to;
+        float start { 0.f };
+        float end { 0.f };
+    };
+
+    /**
+     * Builds a whole animation up front, the steps are flattened into segments as they are added:
+     *
+     * Timeline(banner)
+     *     .then(sizeSpec).with(text, fadeSpec)
+     *     .wait(sf::seconds(1.f))
+     *     .then(shrinkSpec)
+     *     .setCompletionCallback<&Banner::onComplete>();
+     *
+     * Played by TweenEngine::play(). The completion callbacks of the specs are ignored,
+     * only the one of the timeline is called, with the owner, once all the repeats are done.
+     */
+    class Timeline {
+    public:
+        explicit Timeline(entt::entity owner) : m_owner(owner) {}
+
+        /**
+         * Starts after everything added so far, on the owner or on another entity.
+         */
+        Timeline& then(const TweenSpec& spec) { return then(m_owner, spec); }
+        Timeline& then(entt::entity entity, const TweenSpec& spec);
 
-        bool m_running { false };
+        /**
+         * Starts together with the last step.
+         */
+        Timeline& with(const TweenSpec& spec) { return with(m_owner, spec); }
+        Timeline& with(entt::entity entity, const TweenSpec& spec);
 
-        float m_beginValue { 0.f };
-        float m_endValue { 1.f };
+        Timeline& wait(sf::Time delay);
+
+        /**
+         * @param count how many more times the timeline is played, -1 for ever
+         */
+        Timeline& setRepeat(int32_t count) {
+            m_repeat = count;
+            return *this;
+        }
+
+        /**
+         * Every repeat plays backwards from where the last one ended.
+         */
+        Timeline& setYoyo(bool yoyo) {
+            m_yoyo = yoyo;
+            return *this;
+        }
+
+        template <auto Candidate>
+        Timeline& setCompletionCallback() {
+            m_onComplete.connect<Candidate>();
+            return *this;
+        }
+
+        Timeline& setCompletionCallback(const TweenCompletionDelegate onComplete) {
+            m_onComplete = onComplete;
+            return *this;
+        }
+
+        [[nodiscard]] entt::entity getOwner() const { return m_owner; }
+        [[nodiscard]] const std::vector<TimelineSegment>& getSegments() const { return m_segments; }
+        // in seconds.
+        [[nodiscard]] float getDuration() const { return m_cursor; }
+        [[nodiscard]] int32_t getRepeat() const { return m_repeat; }
+        [[nodiscard]] bool isYoyo() const { return m_yoyo; }
+        [[nodiscard]] TweenCompletionDelegate getCompletionCallback() const { return m_onComplete; }
+
+    private:
+        entt::entity m_owner;
+        std::vector<TimelineSegment> m_segments;
+        // start of the last step and end of everything so far.
+        float m_stepStart { 0.f };
+        float m_cursor { 0.f };
+        int32_t m_repeat { 0 };
+        bool m_yoyo { false };
+        TweenCompletionDelegate m_onComplete;
 
-        std::function<float(float progress)> m_easingFunction { EasingFunction::linear };
-        std::function<void(entt::entity entity, float value)> m_callback;
-        std::function<void(entt::entity entity)> m_completionCallback;
+        void add(entt::entity entity, const TweenSpec& spec, float start);
     };
 
 } // game
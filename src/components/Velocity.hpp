@@ -23,6 +23,8 @@ namespace game {
 
         void update(sf::Time deltaTime) { m_velocity += m_acceleration * deltaTime.asSeconds(); }
     private:
+        friend class SMovementSystem;
+
         sf::Vector2f m_velocity;
         sf::Vector2f m_acceleration;
     };
@@ -11,6 +11,7 @@
 #include "components/Scripts.hpp"
 #include "utils/MovementUtils.hpp"
 #include "components/Tweening.hpp"
+#include "utils/TweenEngine.hpp"
 
 namespace game::prefab {
     Banner Banner::create() {
@@ -61,11 +62,6 @@ namespace game::prefab {
                 .build(container);
         SceneTreeUtils::attachSceneTreeComponents(container);
 
-        auto& tweenComponent = registry.emplace<game::CTweenComponent>(container);
-        tweenComponent.setCallback(&Banner::onTweenUpdate);
-        tweenComponent.setCompletionCallback(&Banner::onTweenComplete);
-        tweenComponent.setEasingFunction(CTweenComponent::EasingFunction::exponential);
-
         //registry.emplace<game::CRenderComponent>(container);
         registry.emplace<game::CRenderLayerComponent>(container, RENDER_LAYER, 1);
         registry.emplace<game::CRenderTargetComponent>(container, game::CRenderTargetComponent::UI);
@@ -111,58 +107,54 @@ namespace game::prefab {
         }
 
         if (bannerComponent.bannerState == GBannerComponent::BannerState::BANNER_READY) {
-            bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_FADE_IN;
-
-            auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
-            tweenComponent.setRange(0.0f, 0.4f);
-            tweenComponent.setDuration(sf::seconds(0.2f));
-            tweenComponent.restart();
+            bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_DISPLAY;
+            game::getTweenEngine().play(makeTimeline(entity));
         }
     }
 
-    void Banner::onTweenUpdate(entt::entity entity, float value) {
-        auto windowSize = getGame().getWindow().getWindowSize();
-        sf::Vector2f size = { static_cast<float>(windowSize.x), static_cast<float>(windowSize.y) * value };
-        MovementUtils::setSize(entity, size);
-
+    Timeline Banner::makeTimeline(entt::entity entity) {
         auto& registry = game::getRegistry();
-        auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
         auto& bannerComponent = registry.get<GBannerComponent>(entity);
-        auto& textRenderComponent = registry.get<game::CTextRenderComponent>(bannerComponent.bannerText);
 
-        sf::Color color = TEXT_COLOR;
-        // I found that using tweening like below will have some weird but cool effects.
-        // this is because, in the DISPLAY stage, the ratio will be reset to 0,
-        // and the color will be transparent:
+        auto windowSize = getGame().getWindow().getWindowSize();
+        auto width = static_cast<float>(windowSize.x);
+        auto height = static_cast<float>(windowSize.y);
+
+        auto resize = [width, height](float fromHeight, float toHeight, sf::Time duration) {
+            return TweenSpec()
+                .setTarget(TweenTarget::Size)
+                .setEasing(Easing::Exponential)
+                .setRange({ width, height * fromHeight }, { width, height * toHeight })
+                .setDuration(duration);
+        };
+        // I found that fading the text like below will have some weird but cool effects.
+        // this is because, in every stage, the alpha will be reset to 0,
+        // and the text will be transparent:
         // 0~1 -> 0~1 -> 0~1.
-        color.a = static_cast<uint8_t>(255.0f * tweenComponent.getRatioValue());
-        textRenderComponent.setColor(color);
+        auto fade = [](sf::Time duration) {
+            return TweenSpec()
+                .setTarget(TweenTarget::Alpha)
+                .setEasing(Easing::Exponential)
+                .setRange(0.0f, 1.0f)
+                .setDuration(duration);
+        };
+
+        return Timeline(entity)
+            .then(resize(0.0f, 0.4f, sf::seconds(0.2f)))
+            .with(bannerComponent.bannerText, fade(sf::seconds(0.2f)))
+            .then(bannerComponent.bannerText, fade(sf::seconds(1.2f)))
+            .then(resize(0.4f, 0.0f, sf::seconds(0.2f)))
+            .with(bannerComponent.bannerText, fade(sf::seconds(0.2f)))
+            .setCompletionCallback<&Banner::onTimelineComplete>();
     }
 
-    void Banner::onTweenComplete(entt::entity entity) {
+    void Banner::onTimelineComplete(entt::entity entity) {
         auto& registry = game::getRegistry();
         auto& bannerComponent = registry.get<GBannerComponent>(entity);
-        auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
 
-        if (bannerComponent.bannerState == GBannerComponent::BannerState::BANNER_FADE_IN) {
-            bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_DISPLAY;
-            tweenComponent.setRange(0.4f, 0.4f);
-            tweenComponent.setDuration(sf::seconds(1.2f));
-            tweenComponent.restart();
-            return;
-        }
-        if (bannerComponent.bannerState == GBannerComponent::BannerState::BANNER_DISPLAY) {
-            bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_FADE_OUT;
-            tweenComponent.setRange(0.4f, 0.0f);
-            tweenComponent.setDuration(sf::seconds(0.2f));
-            tweenComponent.restart();
-            return;
-        }
-        if (bannerComponent.bannerState == GBannerComponent::BannerState::BANNER_FADE_OUT) {
-            bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_IDLE;
-            game::getEventDispatcher().trigger<EOnBannerCompleteEvent>(EOnBannerCompleteEvent { entity });
-            game::RenderUtils::markAsInvisible(entity);
-        }
+        bannerComponent.bannerState = GBannerComponent::BannerState::BANNER_IDLE;
+        game::getEventDispatcher().trigger<EOnBannerCompleteEvent>(EOnBannerCompleteEvent { entity });
+        game::RenderUtils::markAsInvisible(entity);
     }
 
     void Banner::launch() {
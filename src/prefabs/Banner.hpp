@@ -8,6 +8,7 @@
 #include "systems/SceneControl.hpp"
 #include "SFML/Graphics/Font.hpp"
 #include "SFML/Graphics/Text.hpp"
+#include "components/Tweening.hpp"
 
 namespace game::prefab {
 
@@ -19,9 +20,7 @@ namespace game::prefab {
         enum class BannerState {
             BANNER_IDLE = 0,
             BANNER_READY = 1,
-            BANNER_FADE_IN,
             BANNER_DISPLAY,
-            BANNER_FADE_OUT,
         };
 
         entt::entity bannerText { entt::null };
@@ -44,8 +43,8 @@ namespace game::prefab {
         static void makeContainer(entt::entity container);
         static void makeText(entt::entity text);
         static void onUpdate(entt::entity entity, sf::Time deltaTime);
-        static void onTweenUpdate(entt::entity entity, float value);
-        static void onTweenComplete(entt::entity entity);
+        static Timeline makeTimeline(entt::entity entity);
+        static void onTimelineComplete(entt::entity entity);
         static float getTextWidth(const sf::String& text);
     };
 
@@ -10,6 +10,7 @@
 #include "components/Collision.hpp"
 #include "components/Render.hpp"
 #include "components/Velocity.hpp"
+#include "utils/Archetype.hpp"
 #include "utils/LazyLoader.hpp"
 #include "utils/MovementUtils.hpp"
 #include "components/Lighting.hpp"
@@ -35,50 +36,93 @@ namespace game::prefab {
         }
     }
 
-    Bullet::Bullet(sf::Vector2f pos, sf::Vector2f dir) {
-        create(pos, dir, DEFAULT_SPEED);
-    }
+    Bullet::Bullet(sf::Vector2f pos, sf::Vector2f dir) : Bullet(pos, dir, DEFAULT_SPEED) {}
 
     Bullet::Bullet(sf::Vector2f pos, sf::Vector2f dir, float speed) : TreeLike() {
         static size_t renderOrderAccumulator = 0;
 
         auto& registry = game::getRegistry();
-        auto entity = registry.create();
+        auto entity = getPool().acquire();
         m_entity = entity;
 
-        game::MovementUtils::builder()
-            .setLocalPosition(pos)
-            .setSize({32, 32})
-            .setScale({0.25, 0.25})
-            .setAnchor(game::CLayout::Anchor::MiddleCenter())
-            .build(entity);
-        game::SceneTreeUtils::attachSceneTreeComponents(entity);
-
-        registry.emplace<game::CRenderComponent>(entity);
-        registry.emplace<game::CRenderLayerComponent>(entity, RENDER_LAYER, renderOrderAccumulator++);
-        registry.emplace<game::CRenderTargetComponent>(entity, game::CRenderTargetComponent::GameComponent);
-
-        auto frame = loadTexture();
-        registry.emplace<game::CSpriteRenderComponent>(entity, frame);
-        registry.emplace<game::CVelocity>(entity, dir.normalized() * speed);
-
-        registry.emplace<game::CCollisionComponent>(entity);
-        registry.emplace<game::CCollisionCircleComponent>(entity, 16.f);
-        // on layer 2, collide with player(1)
-        registry.emplace<game::CCollisionLayerComponent>(entity,
-            CollisionUtils::getCollisionMask(2), CollisionUtils::getCollisionMask(1));
-
-        game::InvokeUpdateDelegate delegate;
-        delegate.connect<&Bullet::onUpdate>();
-        registry.emplace<game::CScriptsComponent>(entity, delegate);
-
-        registry.emplace<game::CLightingComponent>(entity, sf::Color(255, 192, 203, 196), 12.f);
+        // a recycled bullet still carries the state of its previous life.
+        game::MovementUtils::setPosition(entity, pos);
+        registry.replace<game::CVelocity>(entity, dir.normalized() * speed);
+        registry.get<game::CRenderLayerComponent>(entity).setOrder(renderOrderAccumulator++);
+        registry.get<game::prefab::GBulletComponent>(entity).generation++;
+    }
 
-        registry.emplace<game::prefab::GBulletComponent>(entity);
+    PrefabPool& Bullet::getPool() {
+        static PrefabPool pool { &Bullet::build, POOL_WARM_UP_SIZE, POOL_HIGH_WATER_MARK };
+        return pool;
+    }
 
-        auto smallMapIndicator = registry.create();
-        makeSmallMapIndicator(smallMapIndicator);
-        SceneTreeUtils::attachChild(entity, smallMapIndicator);
+    std::vector<entt::entity> Bullet::build(const size_t count) {
+        using BulletArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent, CSpriteRenderComponent,
+            CVelocity, CCollisionComponent, CCollisionCircleComponent, CCollisionLayerComponent,
+            CScriptsComponent, CLightingComponent, GBulletComponent>;
+        using IndicatorArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent>;
+
+        static const BulletArchetype bulletArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({32, 32})
+                .setScale({0.25, 0.25})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            game::InvokeUpdateDelegate delegate;
+            delegate.connect<&Bullet::onUpdate>();
+            // only the bounds are checked, a few frames late does not matter.
+            CScriptsComponent scripts { delegate };
+            scripts.setUpdateInterval(SCRIPT_UPDATE_INTERVAL);
+
+            return BulletArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CRenderComponent {},
+                CRenderLayerComponent { RENDER_LAYER, 0 },
+                CRenderTargetComponent { CRenderTargetComponent::GameComponent },
+                CSpriteRenderComponent { loadTexture() },
+                CVelocity {},
+                CCollisionComponent {},
+                CCollisionCircleComponent { 16.f },
+                // on layer 2, collide with player(1)
+                CCollisionLayerComponent { CollisionUtils::getCollisionMask(2), CollisionUtils::getCollisionMask(1) },
+                scripts,
+                CLightingComponent { sf::Color(255, 192, 203, 196), 12.f },
+                GBulletComponent {}
+            };
+        }();
+
+        static const IndicatorArchetype indicatorArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
+                .setScale({1.0, 1.0})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            return IndicatorArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CRenderComponent {},
+                CRenderLayerComponent { SMALL_MAP_INDICATOR_LAYER, 0 },
+                CRenderTargetComponent { CRenderTargetComponent::SmallMap }
+            };
+        }();
+
+        auto bullets = spawnBatch(bulletArchetype, count);
+        const auto indicators = spawnBatch(indicatorArchetype, count, [](const entt::entity indicator, size_t) {
+            makeSmallMapIndicator(indicator);
+        });
+
+        for (size_t i = 0; i < count; i++) {
+            SceneTreeUtils::attachChild(bullets[i], indicators[i]);
+        }
+        return bullets;
     }
 
     entt::resource<SpriteFrame> Bullet::loadTexture() {
@@ -99,21 +143,9 @@ namespace game::prefab {
     }
 
     void Bullet::makeSmallMapIndicator(entt::entity indicator) {
-
+        // the rest comes from the indicator archetype, see build().
         auto& registry = game::getRegistry();
 
-        game::MovementUtils::builder()
-                .setLocalPosition({0.f, 0.f})
-                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
-                .setScale({1.0, 1.0})
-                .setAnchor(game::CLayout::Anchor::MiddleCenter())
-                .build(indicator);
-        SceneTreeUtils::attachSceneTreeComponents(indicator);
-
-        registry.emplace<game::CRenderComponent>(indicator);
-        registry.emplace<game::CRenderLayerComponent>(indicator, SMALL_MAP_INDICATOR_LAYER, 0);
-        registry.emplace<game::CRenderTargetComponent>(indicator, game::CRenderTargetComponent::SmallMap);
-
         auto* circleShape = new sf::CircleShape(SMALL_MAP_INDICATOR_SIZE);
         circleShape->setFillColor(sf::Color(255, 255, 255, 196));
 
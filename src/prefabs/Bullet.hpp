@@ -9,11 +9,16 @@
 #include "SFML/System/Time.hpp"
 #include "SFML/System/Vector2.hpp"
 #include "systems/SceneControl.hpp"
+#include "utils/PrefabPool.hpp"
 
 namespace game::prefab {
 
     struct GBulletComponent {
         GBulletComponent() = default;
+
+        // bumped every time the bullet is taken from the pool,
+        // tells a recycled bullet apart from the one that was spawned before.
+        uint32_t generation { 0 };
     };
 
     class Bullet : public game::TreeLike {
@@ -24,9 +29,14 @@ namespace game::prefab {
         ~Bullet() = default;
         Bullet() = delete;
 
+        static PrefabPool& getPool();
+
     private:
         static constexpr float DEFAULT_SPEED = 256.f;
+        static constexpr size_t POOL_WARM_UP_SIZE = 64;
+        static constexpr size_t POOL_HIGH_WATER_MARK = 512;
         static constexpr size_t RENDER_LAYER = 24;
+        static constexpr uint32_t SCRIPT_UPDATE_INTERVAL = 4;
 
         static constexpr float SMALL_MAP_INDICATOR_SIZE = 32.f;
         static constexpr size_t SMALL_MAP_INDICATOR_LAYER = 254;
@@ -35,6 +45,7 @@ namespace game::prefab {
         Bullet(sf::Vector2f pos, sf::Vector2f dir);
         Bullet(sf::Vector2f pos, sf::Vector2f dir, float speed);
 
+        static std::vector<entt::entity> build(size_t count);
         static entt::resource<SpriteFrame> loadTexture();
         static void makeSmallMapIndicator(entt::entity indicator);
     };
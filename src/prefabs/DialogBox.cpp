@@ -15,6 +15,8 @@
 #include "utils/DialogGenerator.hpp"
 #include "utils/LazyLoader.hpp"
 #include "utils/MovementUtils.hpp"
+#include "utils/TextUtils.hpp"
+#include "utils/TweenEngine.hpp"
 
 namespace game::prefab {
     DialogBox DialogBox::create() {
@@ -33,32 +35,8 @@ namespace game::prefab {
         dialogBoxComponent.dialogCollection = std::move(dialogCollection);
         dialogBoxComponent.currentDialogLine = 0;
 
-        auto speaker = dialogBoxComponent.dialogCollection.value()->getSpeaker(dialogBoxComponent.dialogCollection.value()->lines[0].speakerId);
-        auto& nameTextRender = registry.get<game::CTextRenderComponent>(dialogBoxComponent.nameText);
-        nameTextRender.setText(speaker.name);
-        nameTextRender.setColor(speaker.nameColor);
-
-        auto* portraitShape = registry.get<game::CShapeRenderComponent>(dialogBoxComponent.portrait).getShape();
-        auto& portraitPosition = registry.get<game::CLocalTransform>(dialogBoxComponent.portrait);
-        if (speaker.portrait.has_value()) {
-            RenderUtils::markAsVisible(dialogBoxComponent.portrait);
-            portraitShape->setTexture(&speaker.portrait.value()->rawTextureRef->texture);
-            portraitShape->setTextureRect(speaker.portrait.value()->textureRect.value());
-
-            auto size = speaker.portrait.value()->textureRect.value().size;
-
-            MovementUtils::setSize(dialogBoxComponent.portrait, { static_cast<float>(size.x), static_cast<float>(size.y) });
-            MovementUtils::setScale(dialogBoxComponent.portrait, speaker.portraitScalingFactor);
-        } else {
-            RenderUtils::markAsInvisible(dialogBoxComponent.portrait);
-            portraitShape->setTexture(nullptr);
-        }
-
-        auto& tween = registry.get<CTweenComponent>(m_entity);
-        auto textLength = dialogBoxComponent.dialogCollection.value()->lines[0].text.getSize();
-        tween.setDuration(sf::seconds(SINGLE_CHAR_TIME * static_cast<float>(textLength)));
-        tween.setEndValue(static_cast<float>(dialogBoxComponent.dialogCollection.value()->lines[0].text.getSize()));
-        tween.restart();
+        prebakeGlyphs(*dialogBoxComponent.dialogCollection.value());
+        showDialogLine(m_entity);
     }
 
     void DialogBox::loadDialog(const std::string& resourceName, const DialogCollection& dialogCollection) {
@@ -94,13 +72,6 @@ namespace game::prefab {
         dialogBoxComponent.nameText = nameText;
         dialogBoxComponent.portrait = portrait;
 
-        auto& tween = registry.emplace<CTweenComponent>(container);
-        tween.setBeginValue(0.f);
-        // tween.setEndValue(static_cast<float>(dialogBoxComponent.dialogCollection->lines[0].text.getSize()));
-        // tween.setDuration(sf::seconds(0.5f));
-        tween.setCallback(DialogBox::onTweenCallback);
-        tween.setCompletionCallback(DialogBox::onTweenCompletionCallback);
-
         //loadDialog(loadDialogCollection());
     }
 
@@ -129,38 +100,13 @@ namespace game::prefab {
         if (keyboard.isKeyPressed(sf::Keyboard::Key::LControl)) {
             nextDialogLine(entity);
         }
-
-        if (!dialogBoxComponent.dialogCollection.has_value()) {
-            return;
-        }
-
-        auto& contentText = registry.get<game::CTextRenderComponent>(dialogBoxComponent.contentText);
-        contentText.setText(dialogBoxComponent.line);
-    }
-
-    void DialogBox::onTweenCallback(entt::entity entity, float value) {
-        auto& registry = game::getRegistry();
-        auto& dialogBoxComponent = registry.get<game::prefab::GDialogBoxComponent>(entity);
-
-        if (dialogBoxComponent.currentDialogLine >= dialogBoxComponent.dialogCollection.value()->lines.size()) {
-            return;
-        }
-
-        dialogBoxComponent.line =
-            dialogBoxComponent.dialogCollection.value()->lines[dialogBoxComponent.currentDialogLine]
-            .text.substring(0, std::ceil(value));
     }
 
     void DialogBox::onTweenCompletionCallback(entt::entity entity) {
+        // the tween runs on the content text itself.
         auto& registry = game::getRegistry();
-        auto& dialogBoxComponent = registry.get<game::prefab::GDialogBoxComponent>(entity);
-
-        if (dialogBoxComponent.currentDialogLine >= dialogBoxComponent.dialogCollection.value()->lines.size()) {
-            return;
-        }
-
-        dialogBoxComponent.line =
-                dialogBoxComponent.dialogCollection.value()->lines[dialogBoxComponent.currentDialogLine].text;
+        auto& contentText = registry.get<game::CTextRenderComponent>(entity);
+        contentText.setRevealCount(game::CTextRenderComponent::ALL_CHARACTERS);
     }
 
     void DialogBox::nextDialogLine(entt::entity entity) {
@@ -171,8 +117,6 @@ namespace game::prefab {
             return;
         }
 
-        auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
-
         // look out for minus-one errors
         if (dialogBoxComponent.dialogCollection.value()->lines.size() <= dialogBoxComponent.currentDialogLine + 1) {
             dialogBoxComponent.isOpen = false;
@@ -184,19 +128,34 @@ namespace game::prefab {
         getLogger().logDebug("Dialog line completed, offset: " + std::to_string(dialogBoxComponent.currentDialogLine));
 
         dialogBoxComponent.currentDialogLine++;
+        showDialogLine(entity);
+    }
 
-        auto textLength = dialogBoxComponent.dialogCollection.value()->lines[dialogBoxComponent.currentDialogLine].text.getSize();
-        tweenComponent.setEndValue(static_cast<float>(textLength));
-        tweenComponent.setDuration(sf::seconds(SINGLE_CHAR_TIME * static_cast<float>(textLength)));
-        tweenComponent.restart();
+    void DialogBox::showDialogLine(entt::entity entity) {
+        auto& registry = game::getRegistry();
+        auto& dialogBoxComponent = registry.get<game::prefab::GDialogBoxComponent>(entity);
+        const auto& line = dialogBoxComponent.dialogCollection.value()->lines[dialogBoxComponent.currentDialogLine];
 
-        auto speaker = dialogBoxComponent.dialogCollection.value()->getSpeaker(dialogBoxComponent.dialogCollection.value()->lines[dialogBoxComponent.currentDialogLine].speakerId);
+        // the whole line is laid out once, the tween then only reveals more of it.
+        auto& contentText = registry.get<game::CTextRenderComponent>(dialogBoxComponent.contentText);
+        contentText.setText(line.text);
+        contentText.setRevealCount(0);
+
+        auto& tweens = game::getTweenEngine();
+        auto textLength = static_cast<float>(line.text.getSize());
+        tweens.stop(dialogBoxComponent.revealTween);
+        dialogBoxComponent.revealTween = tweens.start(dialogBoxComponent.contentText, TweenSpec()
+                .bind<&game::CTextRenderComponent::setRevealCount>()
+                .setRange(0.f, textLength)
+                .setDuration(sf::seconds(SINGLE_CHAR_TIME * textLength))
+                .setCompletionCallback<&DialogBox::onTweenCompletionCallback>());
+
+        auto speaker = dialogBoxComponent.dialogCollection.value()->getSpeaker(line.speakerId);
         auto& nameText = registry.get<game::CTextRenderComponent>(dialogBoxComponent.nameText);
         nameText.setText(speaker.name);
         nameText.setColor(speaker.nameColor);
 
         auto* portraitShape = registry.get<game::CShapeRenderComponent>(dialogBoxComponent.portrait).getShape();
-        auto& portraitPosition = registry.get<game::CLocalTransform>(dialogBoxComponent.portrait);
         if (speaker.portrait.has_value()) {
             RenderUtils::markAsVisible(dialogBoxComponent.portrait);
             portraitShape->setTexture(&speaker.portrait.value()->rawTextureRef->texture);
@@ -212,6 +171,18 @@ namespace game::prefab {
         }
     }
 
+    void DialogBox::prebakeGlyphs(const DialogCollection& dialogCollection) {
+        // rasterize every character of the dialog up front,
+        // so that the glyph atlas doesn't change while the lines are being revealed.
+        const auto font = loadFont();
+        for (const auto& line : dialogCollection.lines) {
+            TextUtils::prebakeGlyphs(*font, line.text, CONTENT_FONT_SIZE);
+        }
+        for (const auto& [id, speaker] : dialogCollection.speakers) {
+            TextUtils::prebakeGlyphs(*font, speaker.name, NAME_FONT_SIZE, true);
+        }
+    }
+
     entt::resource<sf::Font> DialogBox::loadFont() {
         static Lazy font = Lazy<entt::resource<sf::Font>>(
             [] {
@@ -8,6 +8,7 @@
 #include "ResourceManager.hpp"
 #include "SFML/Graphics/Font.hpp"
 #include "SFML/System/Time.hpp"
+#include "components/Tweening.hpp"
 #include "systems/SceneControl.hpp"
 
 namespace game::prefab {
@@ -25,8 +26,7 @@ namespace game::prefab {
 
         std::optional<entt::resource<DialogCollection>> dialogCollection {};
         size_t currentDialogLine = 0;
-
-        sf::String line {};
+        TweenHandle revealTween {};
 
         bool keydown { false };
 
@@ -50,10 +50,12 @@ namespace game::prefab {
         DialogBox();
 
         static void onUpdate(entt::entity entity, sf::Time deltaTime);
-        static void onTweenCallback(entt::entity entity, float value);
         static void onTweenCompletionCallback(entt::entity entity);
 
         static void nextDialogLine(entt::entity entity);
+        static void showDialogLine(entt::entity entity);
+
+        static void prebakeGlyphs(const DialogCollection& dialogCollection);
 
         static entt::resource<sf::Font> loadFont();
         static entt::resource<DialogCollection> loadDialogCollection();
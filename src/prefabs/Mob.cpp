@@ -7,14 +7,16 @@
 #include "Bullet.hpp"
 #include "Player.hpp"
 #include "ResourceManager.hpp"
-#include "components/Scripts.hpp"
 #include "components/Velocity.hpp"
 #include "utils/TextureGenerator.hpp"
 #include "utils/LazyLoader.hpp"
+#include "utils/Archetype.hpp"
 #include "utils/MovementUtils.hpp"
+#include "utils/TimerWheel.hpp"
 #include "Root.hpp"
 #include "components/Lighting.hpp"
 #include "components/Collision.hpp"
+#include "components/Pool.hpp"
 #include "PlayerBullet.hpp"
 
 namespace game::prefab {
@@ -23,51 +25,99 @@ namespace game::prefab {
     }
 
     Mob Mob::create(sf::Vector2f pos) {
-        static entt::connection collisionConn;
-        collisionConn = getEventDispatcher().sink<game::EOnCollisionEvent>().connect<&Mob::onCollision>();
+        connectCollision();
         return Mob { pos };
     }
 
+    std::vector<entt::entity> Mob::createBatch(const std::vector<sf::Vector2f>& positions) {
+        connectCollision();
+        return spawn(positions.data(), positions.size());
+    }
+
     Mob::Mob(sf::Vector2f pos) {
-        static size_t renderOrderAccumulator = 0;
+        m_entity = spawn(&pos, 1).front();
+    }
+
+    void Mob::connectCollision() {
+        static entt::connection collisionConn;
+        collisionConn = getEventDispatcher().sink<game::EOnCollisionEvent>().connect<&Mob::onCollision>();
+    }
+
+    std::vector<entt::entity> Mob::spawn(const sf::Vector2f* positions, const size_t count) {
+        using MobArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent, CAnimatedSpriteRenderComponent,
+            CVelocity,
+            CCollisionComponent, CCollisionCircleComponent, CCollisionLayerComponent,
+            CLightingComponent, GMobComponent>;
+        using IndicatorArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent>;
+
+        static const MobArchetype mobArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({32, 48})
+                .setScale({1.0, 1.0})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            auto animations = loadAnimationResources();
+
+            return MobArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CRenderComponent {},
+                CRenderLayerComponent { RENDER_LAYER, 0 },
+                CRenderTargetComponent { CRenderTargetComponent::GameComponent },
+                CAnimatedSpriteRenderComponent { (*animations)["idle"], true },
+                CVelocity {},
+                CCollisionComponent {},
+                CCollisionCircleComponent { 32.f },
+                // on layer 4, collide with player bullets(3)
+                CCollisionLayerComponent { CollisionUtils::getCollisionMask(4), CollisionUtils::getCollisionMask(3) },
+                CLightingComponent { sf::Color(64, 96, 255, 255), 50.f },
+                GMobComponent { animations }
+            };
+        }();
+
+        static const IndicatorArchetype indicatorArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
+                .setScale({1.0, 1.0})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            return IndicatorArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CRenderComponent {},
+                CRenderLayerComponent { SMALL_MAP_INDICATOR_LAYER, 0 },
+                CRenderTargetComponent { CRenderTargetComponent::SmallMap }
+            };
+        }();
 
+        static size_t renderOrderAccumulator = 0;
         auto& registry = game::getRegistry();
-        auto entity = registry.create();
-        m_entity = entity;
-
-        game::MovementUtils::builder()
-            .setLocalPosition(pos)
-            .setSize({32, 48})
-            .setScale({1.0, 1.0})
-            .setAnchor(game::CLayout::Anchor::MiddleCenter())
-            .build(entity);
-        game::SceneTreeUtils::attachSceneTreeComponents(entity);
-
-        registry.emplace<game::CRenderComponent>(entity);
-        registry.emplace<game::CRenderLayerComponent>(entity, RENDER_LAYER, renderOrderAccumulator++);
-        registry.emplace<game::CRenderTargetComponent>(entity, game::CRenderTargetComponent::GameComponent);
-
-        auto animations = loadAnimationResources();
-        registry.emplace<game::CAnimatedSpriteRenderComponent>(entity, (*animations)["idle"], true);
-        InvokeUpdateDelegate delegate;
-        delegate.connect<&Mob::mobUpdate>();
-
-        registry.emplace<game::CScriptsComponent>(entity, delegate);
-        registry.emplace<game::CVelocity>(entity);
-
-        registry.emplace<game::CCollisionComponent>(entity);
-        registry.emplace<game::CCollisionCircleComponent>(entity, 32.f);
-        // on layer 4, collide with player bullets(3)
-        registry.emplace<game::CCollisionLayerComponent>(entity,
-                                                         CollisionUtils::getCollisionMask(4), CollisionUtils::getCollisionMask(3));
-
-        registry.emplace<game::CLightingComponent>(entity, sf::Color(64, 96, 255, 255), 50.f);
-
-        registry.emplace<game::prefab::GMobComponent>(entity, animations);
-
-        auto smallMapIndicator = registry.create();
-        makeSmallMapIndicator(smallMapIndicator);
-        SceneTreeUtils::attachChild(entity, smallMapIndicator);
+
+        auto mobs = spawnBatch(mobArchetype, count, [&registry, positions](const entt::entity entity, const size_t i) {
+            registry.get<CLocalTransform>(entity).setPosition(positions[i]);
+            registry.get<CRenderLayerComponent>(entity).setOrder(renderOrderAccumulator++);
+
+            // bound to the mob, they are dropped once it is gone.
+            auto& timers = getTimerWheel();
+            auto& mobComponent = registry.get<GMobComponent>(entity);
+            mobComponent.moveTimer = timers.scheduleRepeating(GMobComponent::MOVE_INTERVAL, &Mob::onMoveTimer, entity);
+            mobComponent.attackTimer = timers.scheduleRepeating(GMobComponent::ATTACK_INTERVAL, &Mob::onAttackTimer, entity);
+        });
+
+        const auto indicators = spawnBatch(indicatorArchetype, count, [](const entt::entity indicator, size_t) {
+            makeSmallMapIndicator(indicator);
+        });
+
+        for (size_t i = 0; i < count; i++) {
+            SceneTreeUtils::attachChild(mobs[i], indicators[i]);
+        }
+        return mobs;
     }
 
     MobSharedAnimation Mob::loadAnimationResources() {
@@ -89,65 +139,78 @@ namespace game::prefab {
         return *animations;
     }
 
-    void Mob::mobUpdate(entt::entity entity, sf::Time deltaTime) {
+    std::optional<sf::Vector2f> Mob::getDirectionToPlayer(entt::entity entity) {
         auto& registry = game::getRegistry();
-        auto& mobComponent = registry.get<game::prefab::GMobComponent>(entity);
-
-        if (mobComponent.health <= 0) {
-            UnmountUtils::queueUnmount(entity);
-            game::getEventDispatcher().trigger<EOnMobDeathEvent>(EOnMobDeathEvent { entity });
-            return;
-        }
 
-        auto& playerSelector = *registry.view<game::prefab::GPlayerComponent>().begin();
-        if (!registry.valid(playerSelector)) {
+        const auto playerView = registry.view<game::prefab::GPlayerComponent>();
+        if (playerView.begin() == playerView.end()) {
             auto& velocityComponent = registry.get<game::CVelocity>(entity);
             velocityComponent.setAcceleration(sf::Vector2f {0, 0});
             velocityComponent.setVelocity(sf::Vector2f {0, 0});
-            return;
+            return std::nullopt;
         }
 
-        const auto& playerPos = registry.get<game::CGlobalTransform>(playerSelector).getPosition();
+        const auto& playerPos = registry.get<game::CGlobalTransform>(*playerView.begin()).getPosition();
         const auto& mobPos = registry.get<game::CGlobalTransform>(entity).getPosition();
-        auto delta = (playerPos - mobPos).normalized();
-
-        if (mobComponent.attackClock.getElapsedTime() > GMobComponent::ATTACK_INTERVAL && randomBool(0.75f)) {
-            Bullet bullet = Bullet::create(mobPos, delta, random(100.f, 200.f));
-            mobComponent.bullets.push_back(bullet.getEntity());
-
-            auto& root = game::prefab::Root::create();
-            root.mountChild(bullet.getEntity());
+        return (playerPos - mobPos).normalized();
+    }
 
-            if (mobComponent.bullets.size() > GMobComponent::MAX_BULLET_NUM) {
-                SceneTreeUtils::unmount(mobComponent.bullets.front());
-                mobComponent.bullets.pop_front();
-            }
+    void Mob::onAttackTimer(entt::entity entity) {
+        auto& registry = game::getRegistry();
 
-            mobComponent.attackClock.restart();
+        const auto delta = getDirectionToPlayer(entity);
+        if (!delta.has_value()) {
+            return;
         }
 
-        if (mobComponent.moveClock.getElapsedTime() > GMobComponent::MOVE_INTERVAL && randomBool(0.75f)) {
-            auto& velocityComponent = registry.get<game::CVelocity>(entity);
+        const auto mobPos = registry.get<game::CGlobalTransform>(entity).getPosition();
+        Bullet bullet = Bullet::create(mobPos, delta.value(), random(100.f, 200.f));
 
-            auto velocity = (delta + random({-0.1f, 0.1f}, {-0.1f, 0.1f})) * random(50.f, 100.f);
-            auto acceleration = -velocity / (random(1.0f, 1.5f) * GMobComponent::MOVE_INTERVAL.asSeconds());
+        auto& mobComponent = registry.get<game::prefab::GMobComponent>(entity);
+        mobComponent.bullets.emplace_back(bullet.getEntity(),
+            registry.get<GBulletComponent>(bullet.getEntity()).generation);
+
+        auto& root = game::prefab::Root::create();
+        root.mountChild(bullet.getEntity());
 
-            velocityComponent.setAcceleration(acceleration);
-            velocityComponent.setVelocity(velocity);
+        if (mobComponent.bullets.size() > GMobComponent::MAX_BULLET_NUM) {
+            auto [oldest, generation] = mobComponent.bullets.front();
+            mobComponent.bullets.pop_front();
 
-            // the asset is facing left, so we need to flip it back.
-            // this behavior is quite absurd, so
-            // use a better asset.
-            if (velocity.x > 0) {
-                mobComponent.flipH = true;
-            } else {
-                mobComponent.flipH = false;
+            // it may have been recycled for another mob in the meantime.
+            if (registry.valid(oldest) && !registry.any_of<CPooled>(oldest)
+                && registry.get<GBulletComponent>(oldest).generation == generation) {
+                UnmountUtils::queueUnmount(oldest);
             }
+        }
+    }
+
+    void Mob::onMoveTimer(entt::entity entity) {
+        auto& registry = game::getRegistry();
 
-            mobComponent.moveClock.restart();
+        const auto delta = getDirectionToPlayer(entity);
+        if (!delta.has_value()) {
+            return;
         }
 
-        game::MovementUtils::flipHorizontal(entity, mobComponent.flipH);
+        auto& velocityComponent = registry.get<game::CVelocity>(entity);
+
+        auto velocity = (delta.value() + random({-0.1f, 0.1f}, {-0.1f, 0.1f})) * random(50.f, 100.f);
+        auto acceleration = -velocity / (random(1.0f, 1.5f) * GMobComponent::MOVE_INTERVAL.asSeconds());
+
+        velocityComponent.setAcceleration(acceleration);
+        velocityComponent.setVelocity(velocity);
+
+        // the asset is facing left, so we need to flip it back.
+        // this behavior is quite absurd, so
+        // use a better asset.
+        auto& mobComponent = registry.get<game::prefab::GMobComponent>(entity);
+        const bool flipH = velocity.x > 0;
+        if (flipH != mobComponent.flipH) {
+            // flipping patches the transform and dirties the subtree, only do it on a change.
+            mobComponent.flipH = flipH;
+            game::MovementUtils::flipHorizontal(entity, flipH);
+        }
     }
 
     void Mob::onCollision(game::EOnCollisionEvent e) {
@@ -157,28 +220,27 @@ namespace game::prefab {
             auto& playerBulletComponent = registry.get<game::prefab::GPlayerBulletComponent>(pair->first);
             auto& mobComponent = registry.get<game::prefab::GMobComponent>(pair->second);
             mobComponent.health -= playerBulletComponent.damage;
+            const bool dead = mobComponent.health <= 0 && !UnmountUtils::isUnmountingQueued(pair->second);
+            if (dead) {
+                auto& timers = getTimerWheel();
+                timers.cancel(mobComponent.moveTimer);
+                timers.cancel(mobComponent.attackTimer);
+                UnmountUtils::queueUnmount(pair->second);
+            }
 
             UnmountUtils::queueUnmount(pair->first);
 
             getEventDispatcher().trigger<EOnMobHitEvent>(EOnMobHitEvent { pair->second });
+            if (dead) {
+                getEventDispatcher().trigger<EOnMobDeathEvent>(EOnMobDeathEvent { pair->second });
+            }
         }
     }
 
     void Mob::makeSmallMapIndicator(entt::entity indicator) {
+        // the rest comes from the indicator archetype, see spawn().
         auto& registry = game::getRegistry();
 
-        game::MovementUtils::builder()
-                .setLocalPosition({0.f, 0.f})
-                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
-                .setScale({1.0, 1.0})
-                .setAnchor(game::CLayout::Anchor::MiddleCenter())
-                .build(indicator);
-        SceneTreeUtils::attachSceneTreeComponents(indicator);
-
-        registry.emplace<game::CRenderComponent>(indicator);
-        registry.emplace<game::CRenderLayerComponent>(indicator, SMALL_MAP_INDICATOR_LAYER, 0);
-        registry.emplace<game::CRenderTargetComponent>(indicator, game::CRenderTargetComponent::SmallMap);
-
         auto* circleShape = new sf::CircleShape(SMALL_MAP_INDICATOR_SIZE);
         circleShape->setFillColor(sf::Color(255, 96, 96, 196));
         circleShape->setOutlineColor(sf::Color(255, 255, 255, 196));
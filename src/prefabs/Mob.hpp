@@ -4,13 +4,17 @@
 
 #ifndef MOB_HPP
 #define MOB_HPP
+#include <deque>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "components/Render.hpp"
-#include "SFML/System/Clock.hpp"
+#include "SFML/System/Time.hpp"
 #include "systems/SceneControl.hpp"
 #include "systems/CollisionControl.hpp"
+#include "utils/TimerWheel.hpp"
 
 namespace game::prefab {
 
@@ -37,23 +41,27 @@ namespace game::prefab {
         MobSharedAnimation animations;
         float health = 100;
 
-        sf::Clock moveClock;
-        sf::Clock attackClock;
+        TimerHandle moveTimer;
+        TimerHandle attackTimer;
 
         GMobComponent() = delete;
 
-        std::deque<entt::entity> bullets;
+        // bullets are pooled, the generation tells whether the entity is still the bullet this mob fired.
+        std::deque<std::pair<entt::entity, uint32_t>> bullets;
 
-        explicit GMobComponent(MobSharedAnimation animations) : animations(std::move(animations)) {
-            moveClock.restart();
-            attackClock.restart();
-        }
+        explicit GMobComponent(MobSharedAnimation animations) : animations(std::move(animations)) {}
     };
 
     class Mob : public game::TreeLike {
     public:
         static Mob create();
         static Mob create(sf::Vector2f pos);
+
+        /**
+         * Spawns a mob at every position in a single batch, see spawnBatch().
+         * @return the mobs, not mounted to anything yet
+         */
+        static std::vector<entt::entity> createBatch(const std::vector<sf::Vector2f>& positions);
         ~Mob() = default;
     private:
         static constexpr size_t RENDER_LAYER = 12;
@@ -62,8 +70,15 @@ namespace game::prefab {
         static constexpr size_t SMALL_MAP_INDICATOR_LAYER = 256;
 
         explicit Mob(sf::Vector2f pos);
+        static void connectCollision();
+        static std::vector<entt::entity> spawn(const sf::Vector2f* positions, size_t count);
         static MobSharedAnimation loadAnimationResources();
-        static void mobUpdate(entt::entity entity, sf::Time deltaTime);
+        /**
+         * Stops the mob if there is no player.
+         */
+        static std::optional<sf::Vector2f> getDirectionToPlayer(entt::entity entity);
+        static void onAttackTimer(entt::entity entity);
+        static void onMoveTimer(entt::entity entity);
         static void onCollision(game::EOnCollisionEvent e);
         static void makeSmallMapIndicator(entt::entity indicator);
     };
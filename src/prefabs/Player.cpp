@@ -17,6 +17,7 @@
 #include "utils/TextureGenerator.hpp"
 #include "utils/LazyLoader.hpp"
 #include "utils/MovementUtils.hpp"
+#include "utils/TextUtils.hpp"
 #include "Window.hpp"
 
 void game::prefab::Player::onUpdate(entt::entity entity, sf::Time deltaTime) {
@@ -88,27 +89,38 @@ void game::prefab::Player::onUpdate(entt::entity entity, sf::Time deltaTime) {
     auto lerpedPosition = lerp(lastCameraPosition, destination, DAMPING_FACTOR, deltaTime);
     window.setViewCenter(lerpedPosition);
 
-    if (keyboard.isKeyPressed(sf::Keyboard::Key::X) && (player.attackCoolDown.getElapsedTime() > ATTACK_COOLDOWN || player.allowCheating)) {
+    auto& timers = getTimerWheel();
+    if (keyboard.isKeyPressed(sf::Keyboard::Key::X) && (!timers.isPending(player.attackCoolDown) || player.allowCheating)) {
         player.attackKeyDown = true;
     }
     if (keyboard.isKeyReleased(sf::Keyboard::Key::X) && player.attackKeyDown) {
         game::prefab::PlayerBullet::create(position);
         player.attackKeyDown = false;
-        player.attackCoolDown.restart();
+        timers.cancel(player.attackCoolDown);
+        player.attackCoolDown = timers.schedule(ATTACK_COOLDOWN, nullptr, entity);
     }
 
-    if (keyboard.isKeyPressed(sf::Keyboard::Key::Z) && player.normalAttackCoolDown.getElapsedTime() > NORMAL_ATTACK_COOLDOWN) {
+    if (keyboard.isKeyPressed(sf::Keyboard::Key::Z) && !timers.isPending(player.normalAttackCoolDown)) {
         game::prefab::PlayerBullet::create(position, PlayerBullet::Type::Normal);
-        player.normalAttackCoolDown.restart();
+        player.normalAttackCoolDown = timers.schedule(NORMAL_ATTACK_COOLDOWN, nullptr, entity);
     }
 
-    auto& mpTextRenderComponent = registry.get<game::CTextRenderComponent>(player.mpCoolDownText);
-    float mpCoolDownRatio = std::clamp(player.attackCoolDown.getElapsedTime().asSeconds() / ATTACK_COOLDOWN.asSeconds(), 0.f, 1.f) * 100.f;
-    mpTextRenderComponent.setText(std::to_string(static_cast<int32_t>(std::ceil(mpCoolDownRatio))) + "%");
+    const auto remainingCoolDown = timers.getRemaining(player.attackCoolDown);
+    float mpCoolDownRatio = std::clamp(1.f - remainingCoolDown.asSeconds() / ATTACK_COOLDOWN.asSeconds(), 0.f, 1.f) * 100.f;
+    auto mpCoolDown = static_cast<int32_t>(std::ceil(mpCoolDownRatio));
+    if (mpCoolDown != player.displayedMpCoolDown) {
+        auto& mpTextRenderComponent = registry.get<game::CTextRenderComponent>(player.mpCoolDownText);
+        mpTextRenderComponent.setText(std::to_string(mpCoolDown) + "%");
+        player.displayedMpCoolDown = mpCoolDown;
+    }
 
-    auto& hpTextRenderComponent = registry.get<game::CTextRenderComponent>(player.hpText);
-    hpTextRenderComponent.setText(std::to_string(static_cast<int32_t>(std::floor(player.health)))
-        + (player.allowCheating ? "*" : ""));
+    auto health = static_cast<int32_t>(std::floor(player.health));
+    if (health != player.displayedHealth || player.allowCheating != player.displayedCheating) {
+        auto& hpTextRenderComponent = registry.get<game::CTextRenderComponent>(player.hpText);
+        hpTextRenderComponent.setText(std::to_string(health) + (player.allowCheating ? "*" : ""));
+        player.displayedHealth = health;
+        player.displayedCheating = player.allowCheating;
+    }
 
     auto lerpedPositionFast = lerp(lastCameraPosition, destination, DAMPING_FACTOR_FAST);
     auto& hpTextLocalTransform = registry.get<game::CLocalTransform>(player.hpText);
@@ -190,8 +202,9 @@ game::prefab::Player::Player() : TreeLike() {
     registry.emplace<game::CLightingComponent>(entity, sf::Color(255, 0, 255, 196), 100.f);
 
     auto& playerComponent = registry.emplace<game::prefab::GPlayerComponent>(entity, animations);
-    playerComponent.attackCoolDown.restart();
-    playerComponent.normalAttackCoolDown.restart();
+    auto& timers = getTimerWheel();
+    playerComponent.attackCoolDown = timers.schedule(ATTACK_COOLDOWN, nullptr, entity);
+    playerComponent.normalAttackCoolDown = timers.schedule(NORMAL_ATTACK_COOLDOWN, nullptr, entity);
 
     entt::entity hpText = registry.create();
     makeHpText(hpText);
@@ -278,6 +291,8 @@ void game::prefab::Player::makeHpText(entt::entity text) {
     registry.emplace<game::CRenderTargetComponent>(text, game::CRenderTargetComponent::GameComponent);
 
     auto font = loadFont();
+    // the numbers change all the time, keep their glyphs in the atlas from the start.
+    TextUtils::prebakeAscii(*font, HP_FONT_SIZE);
     auto& textRenderComponent = registry.emplace<game::CTextRenderComponent>(text, font);
     textRenderComponent.setTextSize(HP_FONT_SIZE);
     textRenderComponent.setColor(sf::Color(255, 96, 0));
@@ -301,6 +316,7 @@ void game::prefab::Player::makeMpCoolDownText(entt::entity text) {
     registry.emplace<game::CRenderTargetComponent>(text, game::CRenderTargetComponent::GameComponent);
 
     auto font = loadFont();
+    TextUtils::prebakeAscii(*font, MP_FONT_SIZE);
     auto& textRenderComponent = registry.emplace<game::CTextRenderComponent>(text, font);
     textRenderComponent.setTextSize(MP_FONT_SIZE);
     textRenderComponent.setColor(sf::Color(0, 196, 196));
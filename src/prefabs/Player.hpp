@@ -11,7 +11,8 @@
 #include "systems/SceneControl.hpp"
 #include "ResourceManager.hpp"
 
-#include "SFML/System/Clock.hpp"
+#include "SFML/System/Time.hpp"
+#include "utils/TimerWheel.hpp"
 
 
 namespace game {
@@ -38,11 +39,16 @@ namespace game::prefab {
         float health = 100.f;
 
         bool attackKeyDown { false };
-        sf::Clock attackCoolDown;
-        sf::Clock normalAttackCoolDown;
+        // pending while cooling down.
+        TimerHandle attackCoolDown;
+        TimerHandle normalAttackCoolDown;
 
         entt::entity hpText { entt::null };
         entt::entity mpCoolDownText { entt::null };
+        // values currently shown, the texts are only rebuilt when these change.
+        int32_t displayedHealth { -1 };
+        int32_t displayedMpCoolDown { -1 };
+        bool displayedCheating { false };
         bool allowCheating { false };
 
         bool smallMapKeyDown { false };
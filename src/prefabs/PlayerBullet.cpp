@@ -11,6 +11,7 @@
 #include "components/Collision.hpp"
 #include "components/Lighting.hpp"
 #include "components/Scripts.hpp"
+#include "utils/Archetype.hpp"
 #include "utils/LazyLoader.hpp"
 #include "ResourceManager.hpp"
 #include "utils/TextureGenerator.hpp"
@@ -25,7 +26,7 @@ namespace game::prefab {
         static size_t renderOrderAccumulator = 0;
 
         auto& registry = game::getRegistry();
-        auto entity = registry.create();
+        auto entity = getPool().acquire();
         m_entity = entity;
 
         sf::Vector2f scale;
@@ -42,41 +43,84 @@ namespace game::prefab {
             damage = 25.f;
         }
 
-        game::MovementUtils::builder()
-                .setLocalPosition(pos)
-                .setSize({32.f, 32.f})
-                .setScale(scale)
-                .setAnchor(game::CLayout::Anchor::MiddleCenter())
-                .build(entity);
-        game::SceneTreeUtils::attachSceneTreeComponents(entity);
-
-        registry.emplace<CVelocity>(entity);
-
-        registry.emplace<game::CRenderComponent>(entity);
-        registry.emplace<game::CRenderLayerComponent>(entity, RENDER_LAYER, renderOrderAccumulator++);
-        registry.emplace<game::CRenderTargetComponent>(entity, game::CRenderTargetComponent::GameComponent);
-
-        auto frame = loadTexture();
-        registry.emplace<game::CSpriteRenderComponent>(entity, frame);
-
-        registry.emplace<game::CCollisionComponent>(entity);
-        registry.emplace<game::CCollisionCircleComponent>(entity, 16.f);
-        // on layer 3, collide with mobs(4)
-        registry.emplace<game::CCollisionLayerComponent>(entity,
-                                                         CollisionUtils::getCollisionMask(3), CollisionUtils::getCollisionMask(4));
-
-        game::InvokeUpdateDelegate delegate;
-        delegate.connect<&PlayerBullet::onUpdate>();
-        registry.emplace<game::CScriptsComponent>(entity, delegate);
+        // both types share the pool, everything that differs is set here.
+        game::MovementUtils::setPosition(entity, pos);
+        game::MovementUtils::setScale(entity, scale);
+        registry.replace<CVelocity>(entity);
+        registry.get<game::CRenderLayerComponent>(entity).setOrder(renderOrderAccumulator++);
+        registry.get<game::CLightingComponent>(entity).setRadius(lightRadius);
+        registry.get<game::prefab::GPlayerBulletComponent>(entity).damage = damage;
+    }
 
-        registry.emplace<game::CLightingComponent>(entity, sf::Color(255, 192, 203, 240), lightRadius);
+    PrefabPool& PlayerBullet::getPool() {
+        static PrefabPool pool { &PlayerBullet::build, POOL_WARM_UP_SIZE, POOL_HIGH_WATER_MARK };
+        return pool;
+    }
 
-        auto& bulletComponent = registry.emplace<game::prefab::GPlayerBulletComponent>(entity);
-        bulletComponent.damage = damage;
+    std::vector<entt::entity> PlayerBullet::build(const size_t count) {
+        using PlayerBulletArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CVelocity,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent, CSpriteRenderComponent,
+            CCollisionComponent, CCollisionCircleComponent, CCollisionLayerComponent,
+            CScriptsComponent, CLightingComponent, GPlayerBulletComponent>;
+        using IndicatorArchetype = Archetype<
+            CHasLayout, CLayout, CLocalTransform, CGlobalTransform,
+            CNode, CParent, CChild,
+            CRenderComponent, CRenderLayerComponent, CRenderTargetComponent>;
+
+        static const PlayerBulletArchetype playerBulletArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({32.f, 32.f})
+                .setScale({1.f, 1.f})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            game::InvokeUpdateDelegate delegate;
+            delegate.connect<&PlayerBullet::onUpdate>();
+
+            return PlayerBulletArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CVelocity {},
+                CRenderComponent {},
+                CRenderLayerComponent { static_cast<size_t>(RENDER_LAYER), 0 },
+                CRenderTargetComponent { CRenderTargetComponent::GameComponent },
+                CSpriteRenderComponent { loadTexture() },
+                CCollisionComponent {},
+                CCollisionCircleComponent { 16.f },
+                // on layer 3, collide with mobs(4)
+                CCollisionLayerComponent { CollisionUtils::getCollisionMask(3), CollisionUtils::getCollisionMask(4) },
+                CScriptsComponent { delegate },
+                CLightingComponent { sf::Color(255, 192, 203, 240), 36.f },
+                GPlayerBulletComponent {}
+            };
+        }();
+
+        static const IndicatorArchetype indicatorArchetype = [] {
+            const auto layout = game::MovementUtils::builder()
+                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
+                .setScale({1.0, 1.0})
+                .setAnchor(game::CLayout::Anchor::MiddleCenter());
+
+            return IndicatorArchetype {
+                CHasLayout {}, layout.buildLayout(), layout.buildLocalTransform(), layout.buildGlobalTransform(),
+                CNode {}, CParent {}, CChild {},
+                CRenderComponent {},
+                CRenderLayerComponent { SMALL_MAP_INDICATOR_LAYER, 0 },
+                CRenderTargetComponent { CRenderTargetComponent::SmallMap }
+            };
+        }();
+
+        auto bullets = spawnBatch(playerBulletArchetype, count);
+        const auto indicators = spawnBatch(indicatorArchetype, count, [](const entt::entity indicator, size_t) {
+            makeSmallMapIndicator(indicator);
+        });
 
-        auto smallMapIndicator = registry.create();
-        makeSmallMapIndicator(smallMapIndicator);
-        SceneTreeUtils::attachChild(entity, smallMapIndicator);
+        for (size_t i = 0; i < count; i++) {
+            SceneTreeUtils::attachChild(bullets[i], indicators[i]);
+        }
+        return bullets;
     }
 
     entt::resource<SpriteFrame> PlayerBullet::loadTexture() {
@@ -141,20 +185,9 @@ namespace game::prefab {
     }
 
     void PlayerBullet::makeSmallMapIndicator(entt::entity indicator) {
+        // the rest comes from the indicator archetype, see build().
         auto& registry = game::getRegistry();
 
-        game::MovementUtils::builder()
-                .setLocalPosition({0.f, 0.f})
-                .setSize({SMALL_MAP_INDICATOR_SIZE, 0.f})
-                .setScale({1.0, 1.0})
-                .setAnchor(game::CLayout::Anchor::MiddleCenter())
-                .build(indicator);
-        SceneTreeUtils::attachSceneTreeComponents(indicator);
-
-        registry.emplace<game::CRenderComponent>(indicator);
-        registry.emplace<game::CRenderLayerComponent>(indicator, SMALL_MAP_INDICATOR_LAYER, 0);
-        registry.emplace<game::CRenderTargetComponent>(indicator, game::CRenderTargetComponent::SmallMap);
-
         auto* circleShape = new sf::CircleShape(SMALL_MAP_INDICATOR_SIZE);
         circleShape->setFillColor(sf::Color(96, 196, 255, 196));
         circleShape->setOutlineColor(sf::Color(255, 255, 255, 196));
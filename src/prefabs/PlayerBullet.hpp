@@ -10,6 +10,7 @@
 #include "systems/SceneControl.hpp"
 #include "components/Render.hpp"
 #include "systems/CollisionControl.hpp"
+#include "utils/PrefabPool.hpp"
 
 namespace game::prefab {
 
@@ -26,8 +27,12 @@ namespace game::prefab {
 
         static PlayerBullet create() { return {}; }
         static PlayerBullet create(const sf::Vector2f& pos, const Type type = Type::Big) { return PlayerBullet { pos, type }; }
+
+        static PrefabPool& getPool();
     private:
         static constexpr float RENDER_LAYER = 25;
+        static constexpr size_t POOL_WARM_UP_SIZE = 32;
+        static constexpr size_t POOL_HIGH_WATER_MARK = 256;
         static constexpr float SPEED = 800.f;
         static constexpr float SMALL_MAP_INDICATOR_SIZE = 24.f;
         static constexpr float SMALL_MAP_INDICATOR_OUTLINE = 6.f;
@@ -36,6 +41,7 @@ namespace game::prefab {
         PlayerBullet();
         explicit PlayerBullet(const sf::Vector2f& pos, Type type = Type::Big);
 
+        static std::vector<entt::entity> build(size_t count);
         static entt::resource<SpriteFrame> loadTexture();
         static void onUpdate(entt::entity entity, sf::Time deltaTime);
         static void makeSmallMapIndicator(entt::entity indicator);
@@ -4,6 +4,8 @@
 
 
 #include "SimpleMapLayer.hpp"
+#include "Game.hpp"
+#include "Window.hpp"
 #include "components/Velocity.hpp"
 #include "utils/TextureGenerator.hpp"
 #include "utils/MovementUtils.hpp"
@@ -36,10 +38,13 @@ namespace game::prefab {
         registry.emplace<game::CRenderLayerComponent>(entity, renderOrder, 0);
         registry.emplace<game::CRenderTargetComponent>(
                 entity,
-                game::CRenderTargetComponent::GameComponent | game::CRenderTargetComponent::SmallMap);
+                game::CRenderTargetComponent::GameComponent | game::CRenderTargetComponent::SmallMapStatic);
 
         auto frame = loadTextureLayer(renderOrder);
         registry.emplace<game::CSpriteRenderComponent>(entity, frame);
+
+        // the small map caches the static layers, let it know that there is a new one.
+        game::getGame().getWindow().invalidateSmallMapCache();
     }
 
     entt::resource<game::SpriteFrame> SimpleMapLayer::loadTextureLayer(size_t layer) {
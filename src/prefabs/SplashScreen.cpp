@@ -8,6 +8,7 @@
 #include "utils/TextureGenerator.hpp"
 #include "utils/MovementUtils.hpp"
 #include "components/Tweening.hpp"
+#include "utils/TweenEngine.hpp"
 
 namespace game::prefab {
     SplashScreen::SplashScreen() : game::TreeLike() {
@@ -32,13 +33,17 @@ namespace game::prefab {
 
         registry.emplace<GSplashScreenComponent>(entity);
 
-        auto& tweenComponent = registry.emplace<game::CTweenComponent>(entity);
-        tweenComponent.setCallback(&SplashScreen::onTweenUpdate);
-        tweenComponent.setCompletionCallback(&SplashScreen::onTweenCompleted);
-        tweenComponent.setBeginValue(0.f);
-        tweenComponent.setEndValue(1.f);
-        tweenComponent.setDuration(sf::seconds(SPLASH_SCREEN_PHASE_DURATION));
-        tweenComponent.restart();
+        auto fade = [](float fromAlpha, float toAlpha, sf::Time duration) {
+            return TweenSpec()
+                .setTarget(TweenTarget::Alpha)
+                .setRange(fromAlpha, toAlpha)
+                .setDuration(duration);
+        };
+        game::getTweenEngine().play(Timeline(entity)
+            .then(fade(0.f, 1.f, sf::seconds(SPLASH_SCREEN_PHASE_DURATION)))
+            .wait(sf::seconds(SPLASH_SCREEN_PHASE_DURATION))
+            .then(fade(1.f, 0.f, sf::seconds(SPLASH_SCREEN_PHASE_DURATION * 2.0f)))
+            .setCompletionCallback<&SplashScreen::onTimelineCompleted>());
     }
 
     entt::resource<game::SpriteFrame> SplashScreen::loadImage() {
@@ -57,45 +62,11 @@ namespace game::prefab {
         return *image;
     }
 
-    void SplashScreen::onTweenCompleted(entt::entity entity) {
-        auto& registry = game::getRegistry();
-        auto& splashScreenComponent = registry.get<GSplashScreenComponent>(entity);
-        auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
-
-        if (splashScreenComponent.splashScreenState == GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_FADE_IN) {
-            splashScreenComponent.splashScreenState = GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_WAIT;
-            tweenComponent.setBeginValue(1.f);
-            tweenComponent.setEndValue(1.f);
-            tweenComponent.setDuration(sf::seconds(SPLASH_SCREEN_PHASE_DURATION));
-            tweenComponent.restart();
-
-            return;
-        }
-        if (splashScreenComponent.splashScreenState == GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_WAIT) {
-            splashScreenComponent.splashScreenState = GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_FADE_OUT;
-            tweenComponent.setBeginValue(1.f);
-            tweenComponent.setEndValue(0.f);
-            tweenComponent.setDuration(sf::seconds(SPLASH_SCREEN_PHASE_DURATION * 2.0f));
-            tweenComponent.restart();
-
-            return;
-        }
-        if (splashScreenComponent.splashScreenState == GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_FADE_OUT) {
-            splashScreenComponent.splashScreenState = GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_IDLE;
-            game::getEventDispatcher().trigger<EOnSplashScreenCompletedEvent>(EOnSplashScreenCompletedEvent { entity });
-        }
-    }
-
-    void SplashScreen::onTweenUpdate(entt::entity entity, float progress) {
+    void SplashScreen::onTimelineCompleted(entt::entity entity) {
         auto& registry = game::getRegistry();
         auto& splashScreenComponent = registry.get<GSplashScreenComponent>(entity);
-        auto& tweenComponent = registry.get<game::CTweenComponent>(entity);
-        auto& spriteRenderComponent = registry.get<game::CSpriteRenderComponent>(entity);
 
-        auto sprite = spriteRenderComponent.getSprite();
-        if (!sprite.has_value()) {
-            return;
-        }
-        sprite.value()->setColor(sf::Color(255, 255, 255, static_cast<uint8_t>(progress * 255)));
+        splashScreenComponent.splashScreenState = GSplashScreenComponent::SplashScreenState::SPLASH_SCREEN_IDLE;
+        game::getEventDispatcher().trigger<EOnSplashScreenCompletedEvent>(EOnSplashScreenCompletedEvent { entity });
     }
 } // game
\ No newline at end of file
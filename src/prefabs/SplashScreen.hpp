@@ -18,12 +18,10 @@ namespace game::prefab {
     struct GSplashScreenComponent {
         enum class SplashScreenState {
             SPLASH_SCREEN_IDLE,
-            SPLASH_SCREEN_FADE_IN,
-            SPLASH_SCREEN_WAIT,
-            SPLASH_SCREEN_FADE_OUT,
+            SPLASH_SCREEN_PLAYING,
         };
 
-        SplashScreenState splashScreenState { SplashScreenState::SPLASH_SCREEN_FADE_IN };
+        SplashScreenState splashScreenState { SplashScreenState::SPLASH_SCREEN_PLAYING };
     };
 
     class SplashScreen : game::TreeLike {
@@ -34,8 +32,7 @@ namespace game::prefab {
 
         SplashScreen();
         static entt::resource<game::SpriteFrame> loadImage();
-        static void onTweenCompleted(entt::entity entity);
-        static void onTweenUpdate(entt::entity entity, float progress);
+        static void onTimelineCompleted(entt::entity entity);
 
     };
 
@@ -0,0 +1,78 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TileMapLayer.hpp"
+
+#include <memory>
+
+#include "ResourceManager.hpp"
+#include "components/TileStreaming.hpp"
+#include "utils/MovementUtils.hpp"
+
+namespace game::prefab {
+    TileMapLayer TileMapLayer::create(const std::string& filePath) {
+        return TileMapLayer {filePath};
+    }
+
+    TileMapLayer TileMapLayer::create(const std::string& filePath, size_t renderOrder) {
+        return TileMapLayer {filePath, renderOrder};
+    }
+
+    TileMapLayer::TileMapLayer(const std::string& filePath, size_t renderOrder) {
+        auto& registry = game::getRegistry();
+        auto entity = registry.create();
+        m_entity = entity;
+
+        // only the header and the palette are read here, the tiles are streamed in later on.
+        auto mapFile = std::make_shared<const TileMapFile>(filePath);
+        const auto tileSize = sf::Vector2f(mapFile->getTileSize());
+
+        game::MovementUtils::builder()
+                .setLocalPosition({0, 0})
+                .setSize({0, 0})
+                .setScale({1.0, 1.0})
+                .setAnchor(game::CLayout::Anchor::TopLeft())
+                .build(entity);
+        game::SceneTreeUtils::attachSceneTreeComponents(entity);
+
+        registry.emplace<game::CRenderComponent>(entity);
+        registry.emplace<game::CRenderLayerComponent>(entity, renderOrder, 0);
+        registry.emplace<game::CRenderTargetComponent>(entity, game::CRenderTargetComponent::GameComponent);
+
+        auto& tiledRenderComponent = registry.emplace<game::CTiledRenderComponent>(entity, tileSize);
+        loadPalette(tiledRenderComponent, *mapFile);
+
+        registry.emplace<game::CTileMapStreamComponent>(entity, std::move(mapFile));
+    }
+
+    void TileMapLayer::loadPalette(CTiledRenderComponent& tiledRenderComponent, const TileMapFile& mapFile) {
+        for (const auto& entry : mapFile.getPalette()) {
+            if (entry.frames.size() == 1) {
+                tiledRenderComponent.addTile(Tile { loadFrame(entry.frames.front()), entry.tileId });
+                continue;
+            }
+
+            std::vector<SpriteFrame> frames;
+            frames.reserve(entry.frames.size());
+            for (const auto& frame : entry.frames) {
+                frames.push_back(loadFrame(frame));
+            }
+            tiledRenderComponent.addTile(Tile { std::move(frames), entry.tileId });
+        }
+    }
+
+    SpriteFrame TileMapLayer::loadFrame(const TileMapFile::Frame& frame) {
+        // textures are shared by path, so every layer using the same tile set loads it only once.
+        auto rawTexture = ResourceManager::getRawTextureCache()
+                .load(entt::hashed_string { frame.texturePath.c_str() }, frame.texturePath).first->second;
+
+        const auto& rect = frame.textureRect;
+        const auto textureName = frame.texturePath + "#" + std::to_string(rect.position.x) + "," + std::to_string(rect.position.y)
+                + "," + std::to_string(rect.size.x) + "," + std::to_string(rect.size.y);
+        auto texture = ResourceManager::getTextureCache()
+                .load(entt::hashed_string { textureName.c_str() }, rawTexture, rect).first->second;
+
+        return SpriteFrame { texture, frame.duration };
+    }
+} // game
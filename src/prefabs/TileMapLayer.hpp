@@ -0,0 +1,30 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef GAME25SP_TILEMAPLAYER_HPP
+#define GAME25SP_TILEMAPLAYER_HPP
+
+#include "systems/SceneControl.hpp"
+#include "components/Render.hpp"
+#include "utils/TileMapFile.hpp"
+
+namespace game::prefab {
+
+    /**
+     * A map layer streamed from a binary tile map (see TileMapFile), only the chunks around the view are resident.
+     */
+    class TileMapLayer : public game::TreeLike {
+    public:
+        static TileMapLayer create(const std::string& filePath);
+        static TileMapLayer create(const std::string& filePath, size_t renderOrder);
+    private:
+        explicit TileMapLayer(const std::string& filePath, size_t renderOrder = 0);
+
+        static void loadPalette(CTiledRenderComponent& tiledRenderComponent, const TileMapFile& mapFile);
+        static SpriteFrame loadFrame(const TileMapFile::Frame& frame);
+    };
+
+} // game
+
+#endif //GAME25SP_TILEMAPLAYER_HPP
@@ -10,6 +10,7 @@
 #include "Game.hpp"
 #include "components/Collision.hpp"
 #include "components/Layout.hpp"
+#include "components/Pool.hpp"
 
 namespace game {
     struct CollisionGrid {
@@ -35,13 +36,24 @@ namespace std {
 }
 
 namespace game {
+    namespace {
+        auto collisionGroup(entt::registry& registry) {
+            return registry.group<CCollisionComponent, CCollisionLayerComponent>(
+                    entt::get<CGlobalTransform>, entt::exclude<CPooled>);
+        }
+    }
+
+    void SCollisionSystem::init() {
+        collisionGroup(getRegistry());
+    }
+
     void SCollisionSystem::update(sf::Time deltaTime) {
         using CollisionInfoTuple = std::tuple<std::vector<entt::entity>, size_t, size_t>;
 
         auto& registry = getRegistry();
-        auto view = registry.view<CCollisionComponent, CCollisionLayerComponent>();
 
 #ifdef GAME_USE_LEGACY_COLLISION
+        auto view = registry.view<CCollisionComponent, CCollisionLayerComponent>(entt::exclude<CPooled>);
 
         for (auto it1 = view.begin(); it1 != view.end(); ++it1) {
                 for (auto it2 = std::next(it1); it2 != view.end(); ++it2) {
@@ -72,16 +84,20 @@ namespace game {
 #else
         constexpr sf::Vector2f GRID_SIZE = { 48.f, 48.f };
 
+        auto group = collisionGroup(registry);
+        // the callbacks may park bullets in their pool, which takes them out of the group,
+        // so the pairs below are looked up in the storage instead.
+        auto& collisionLayers = registry.storage<CCollisionLayerComponent>();
+
         std::unordered_map<std::pair<ssize_t, ssize_t>, CollisionInfoTuple> collisionGrid;
-        for (auto entity : view) {
+        for (auto [entity, collision, collisionLayer, globalTransform] : group.each()) {
             // todo: rounding issue
             // this mapping uses std::floor,
             // which may lead to unexpected behavior when the entity is placed on the edge of the grid
-            auto grid = mapGrid(registry.get<CGlobalTransform>(entity).getPosition(), GRID_SIZE);
+            auto grid = mapGrid(globalTransform.getPosition(), GRID_SIZE);
             auto& singleGrid = collisionGrid[grid];
             std::get<0>(singleGrid).push_back(entity);
 
-            auto& collisionLayer = view.get<CCollisionLayerComponent>(entity);
             std::get<1>(singleGrid) |= collisionLayer.getLayer();
             std::get<2>(singleGrid) |= collisionLayer.getMask();
         }
@@ -100,8 +116,8 @@ namespace game {
                         continue;
                     }
 
-                    auto& layer1 = view.get<CCollisionLayerComponent>(*it1);
-                    auto& layer2 = view.get<CCollisionLayerComponent>(*it2);
+                    auto& layer1 = collisionLayers.get(*it1);
+                    auto& layer2 = collisionLayers.get(*it2);
 
                     if (!CollisionUtils::shouldCollide(
                             layer1.getLayer(), layer2.getLayer(),
@@ -21,6 +21,10 @@ namespace game {
     public:
         SCollisionSystem() = default;
 
+        /**
+         * Declares the group of the colliders, before any entity is created.
+         */
+        static void init();
         static void update(sf::Time deltaTime);
     private:
         static bool checkCollisionBoxes(entt::registry& reg, const entt::entity& entity1, const entt::entity& entity2);
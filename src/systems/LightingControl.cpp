@@ -3,49 +3,383 @@
 // by konakona418 (https://github.com/konakona418)
 
 #include "LightingControl.hpp"
+
+#include <algorithm>
+#include <cmath>
+
 #include "Common.hpp"
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
 #include "components/Lighting.hpp"
 #include "components/Layout.hpp"
-#include "components/SceneTree.hpp"
+#include "components/Pool.hpp"
+#include "systems/SceneControl.hpp"
+
+namespace {
+    // encoding of the light data texture of the tiled backend.
+    // positions are biased, so that lights slightly outside the target still fit into 16 bits.
+    constexpr float c_positionBias = 4096.f;
+    constexpr float c_positionScale = 4.f;
+    constexpr float c_exponentScale = 256.f;
+
+    uint16_t encode16(float value) {
+        return static_cast<uint16_t>(std::clamp(std::lround(value), 0L, 65535L));
+    }
+
+    void write16(uint8_t* dest, uint16_t value) {
+        dest[0] = static_cast<uint8_t>(value >> 8);
+        dest[1] = static_cast<uint8_t>(value & 0xff);
+    }
+
+    void ensureTextureSize(sf::Texture& texture, sf::Vector2u size) {
+        if (texture.getSize() == size) {
+            return;
+        }
+        if (!texture.resize(size)) {
+            throw std::runtime_error("LightingControl: failed to allocate data texture");
+        }
+    }
+}
 
 namespace game {
     void SLightingSystem::update(sf::RenderTarget& target) {
+        switch (getBackend()) {
+            case LightingBackend::Forward:
+                updateForward(target);
+                break;
+            case LightingBackend::Tiled:
+                updateTiled(target);
+                break;
+        }
+    }
+
+    void SLightingSystem::setBackend(LightingBackend backend) {
+        getBackendRef() = backend;
+    }
+
+    LightingBackend SLightingSystem::getBackend() {
+        return getBackendRef();
+    }
+
+    LightingBackend& SLightingSystem::getBackendRef() {
+        static LightingBackend s_backend = LightingBackend::Forward;
+        return s_backend;
+    }
+
+    void SLightingSystem::updateForward(sf::RenderTarget& target) {
         auto& registry = game::getRegistry();
         auto& shader = getShader();
 
-        for (auto [entity, lighting] : registry.view<CLightingComponent>().each()) {
+        // all the lights are packed into a single vertex array and drawn in one call.
+        // the per-light parameters travel with the vertices instead of uniforms,
+        // see appendLight() for the layout.
+        auto& vertices = getVertexBuffer();
+        vertices.clear();
+
+        const auto viewBounds = getViewBounds(target.getView());
+
+        auto lightingView = registry.view<CLightingComponent>(entt::exclude<CPooled>);
+        const auto& dirtySet = SceneTreeUtils::getDirtySet();
+        vertices.reserve(lightingView.size() * VERTICES_PER_LIGHT);
+
+        for (auto [entity, lighting] : lightingView.each()) {
             // this means that the entity's position hasn't been properly calculated.
             // by doing so, we can avoid to many entities' illumination set at the origin,
             // which is the default position of un-calculated entities.
-            if (registry.any_of<game::CSceneElementNeedsUpdate>(entity)) {
+            if (dirtySet.contains(entity)) {
                 continue;
             }
 
             auto& globalTransform = registry.get<CGlobalTransform>(entity);
-            auto radius = lighting.getRadius();
+            if (!isLightVisible(viewBounds, globalTransform.getPosition(), lighting.getRadius())) {
+                continue;
+            }
+            appendLight(vertices, globalTransform.getPosition(), lighting);
+        }
+
+        if (vertices.empty()) {
+            return;
+        }
+        target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates(&shader));
+    }
+
+    void SLightingSystem::updateTiled(sf::RenderTarget& target) {
+        auto& registry = game::getRegistry();
+        auto& state = getTiledState();
+        state.clearLights();
+
+        // a copy, the view gets swapped for the full-screen pass below.
+        const sf::View view = target.getView();
+        const auto viewBounds = getViewBounds(view);
+        const auto targetSize = target.getSize();
+        // world units to target pixels. the views in use always cover the whole target.
+        const sf::Vector2f pixelsPerUnit {
+            static_cast<float>(targetSize.x) / viewBounds.size.x,
+            static_cast<float>(targetSize.y) / viewBounds.size.y
+        };
 
-            sf::RectangleShape shape({radius * 2.f, radius * 2.f});
-            shape.setOrigin({radius, radius});
-            shape.setPosition(globalTransform.getPosition());
-            shape.setFillColor(lighting.getColor());
-            shape.setTexture(&getDummyTexture());
+        const auto& dirtySet = SceneTreeUtils::getDirtySet();
+        for (auto [entity, lighting] : registry.view<CLightingComponent>(entt::exclude<CPooled>).each()) {
+            if (state.getLightCount() >= MAX_TILED_LIGHTS) {
+                static bool s_warned = false;
+                if (!s_warned) {
+                    getLogger().logWarn("LightingControl: too many visible lights, the rest are dropped");
+                    s_warned = true;
+                }
+                break;
+            }
+
+            // see updateForward().
+            if (dirtySet.contains(entity)) {
+                continue;
+            }
+
+            const auto center = registry.get<CGlobalTransform>(entity).getPosition();
+            if (!isLightVisible(viewBounds, center, lighting.getRadius())) {
+                continue;
+            }
+
+            state.posX.push_back((center.x - viewBounds.position.x) * pixelsPerUnit.x);
+            state.posY.push_back((center.y - viewBounds.position.y) * pixelsPerUnit.y);
+            state.radius.push_back(lighting.getRadius() * pixelsPerUnit.x);
+            state.exponent.push_back(lighting.getAttenuationExponent());
+            state.color.push_back(lighting.getColor());
+        }
+
+        if (state.getLightCount() == 0) {
+            return;
+        }
+
+        binLights(state, targetSize);
+        uploadTiledState(state);
+
+        auto& shader = getTiledShader();
+        shader.setUniform("u_lights", state.lightTexture);
+        shader.setUniform("u_lightsSize", sf::Glsl::Vec2(sf::Vector2f(state.lightTexture.getSize())));
+        shader.setUniform("u_tileCounts", state.tileCountTexture);
+        shader.setUniform("u_tileCountsSize", sf::Glsl::Vec2(sf::Vector2f(state.tileCountTexture.getSize())));
+        shader.setUniform("u_tileIndices", state.tileIndexTexture);
+        shader.setUniform("u_tileIndicesSize", sf::Glsl::Vec2(sf::Vector2f(state.tileIndexTexture.getSize())));
+
+        // texCoords carry the pixel coordinates, which is the space the lights were binned in.
+        const sf::Vector2f size(targetSize);
+        const sf::Vertex quad[] = {
+            { { 0.f, 0.f }, sf::Color::White, { 0.f, 0.f } },
+            { { size.x, 0.f }, sf::Color::White, { size.x, 0.f } },
+            { { 0.f, size.y }, sf::Color::White, { 0.f, size.y } },
+            { { size.x, size.y }, sf::Color::White, { size.x, size.y } },
+        };
+
+        // the shader does the blending of the lights itself, and writes every pixel exactly once.
+        sf::RenderStates states(&shader);
+        states.blendMode = sf::BlendNone;
 
-            shader.setUniform("lightColor", sf::Glsl::Vec4(lighting.getColor()));
-            shader.setUniform("attenuationExponent", lighting.getAttenuationExponent());
+        target.setView(target.getDefaultView());
+        target.draw(quad, 4, sf::PrimitiveType::TriangleStrip, states);
+        target.setView(view);
+    }
+
+    void SLightingSystem::binLights(TiledState& state, sf::Vector2u targetSize) {
+        const size_t lightCount = state.getLightCount();
+
+        state.tilesX = (targetSize.x + TILE_SIZE - 1) / TILE_SIZE;
+        state.tilesY = (targetSize.y + TILE_SIZE - 1) / TILE_SIZE;
+
+        state.minTileX.resize(lightCount);
+        state.maxTileX.resize(lightCount);
+        state.minTileY.resize(lightCount);
+        state.maxTileY.resize(lightCount);
+
+        // tile range covered by the bounding box of every light.
+        // kept as a flat loop over the arrays, without branches, so that it can be vectorized.
+        const float invTileSize = 1.f / static_cast<float>(TILE_SIZE);
+        const auto lastTileX = static_cast<int32_t>(state.tilesX) - 1;
+        const auto lastTileY = static_cast<int32_t>(state.tilesY) - 1;
+        for (size_t i = 0; i < lightCount; ++i) {
+            const float x = state.posX[i];
+            const float y = state.posY[i];
+            const float r = state.radius[i];
+            state.minTileX[i] = std::clamp(static_cast<int32_t>(std::floor((x - r) * invTileSize)), 0, lastTileX);
+            state.maxTileX[i] = std::clamp(static_cast<int32_t>(std::floor((x + r) * invTileSize)), 0, lastTileX);
+            state.minTileY[i] = std::clamp(static_cast<int32_t>(std::floor((y - r) * invTileSize)), 0, lastTileY);
+            state.maxTileY[i] = std::clamp(static_cast<int32_t>(std::floor((y + r) * invTileSize)), 0, lastTileY);
+        }
+
+        const size_t tileCount = static_cast<size_t>(state.tilesX) * state.tilesY;
+        state.tileCounts.assign(tileCount, 0);
+        state.tileIndices.resize(tileCount * MAX_LIGHTS_PER_TILE);
+
+        // every batch owns whole rows of tiles, so no two threads ever write the same tile.
+        // the lights are walked in order, which keeps the blending order the same as the forward backend.
+        auto binRows = [&state, lightCount](size_t rowBegin, size_t rowEnd) {
+            const auto firstRow = static_cast<int32_t>(rowBegin);
+            const auto lastRow = static_cast<int32_t>(rowEnd) - 1;
+            for (size_t i = 0; i < lightCount; ++i) {
+                const int32_t top = std::max(state.minTileY[i], firstRow);
+                const int32_t bottom = std::min(state.maxTileY[i], lastRow);
+                for (int32_t ty = top; ty <= bottom; ++ty) {
+                    const size_t rowOffset = static_cast<size_t>(ty) * state.tilesX;
+                    for (int32_t tx = state.minTileX[i]; tx <= state.maxTileX[i]; ++tx) {
+                        const size_t tile = rowOffset + tx;
+                        auto& count = state.tileCounts[tile];
+                        if (count < MAX_LIGHTS_PER_TILE) {
+                            state.tileIndices[tile * MAX_LIGHTS_PER_TILE + count] = static_cast<uint16_t>(i);
+                            count++;
+                        }
+                    }
+                }
+            }
+        };
 
-            target.draw(shape, sf::RenderStates(&shader));
+        if (lightCount < PARALLEL_BINNING_THRESHOLD) {
+            binRows(0, state.tilesY);
+        } else {
+            getThreadPool().parallelFor(0, state.tilesY, 2, binRows);
         }
     }
 
+    void SLightingSystem::uploadTiledState(TiledState& state) {
+        const size_t lightCount = state.getLightCount();
+
+        // light data: 3 texels per light.
+        // texel 0: x and y, 16 bits each; texel 1: radius and exponent, 16 bits each; texel 2: color.
+        const uint32_t lightTextureWidth = LIGHTS_PER_ROW * TEXELS_PER_LIGHT;
+        const auto lightRows = static_cast<uint32_t>((lightCount + LIGHTS_PER_ROW - 1) / LIGHTS_PER_ROW);
+        state.lightPixels.resize(static_cast<size_t>(lightTextureWidth) * lightRows * 4);
+        for (size_t i = 0; i < lightCount; ++i) {
+            const size_t row = i / LIGHTS_PER_ROW;
+            const size_t column = (i % LIGHTS_PER_ROW) * TEXELS_PER_LIGHT;
+            uint8_t* texel = state.lightPixels.data() + (row * lightTextureWidth + column) * 4;
+
+            write16(texel + 0, encode16((state.posX[i] + c_positionBias) * c_positionScale));
+            write16(texel + 2, encode16((state.posY[i] + c_positionBias) * c_positionScale));
+            write16(texel + 4, encode16(state.radius[i] * c_positionScale));
+            write16(texel + 6, encode16(state.exponent[i] * c_exponentScale));
+            texel[8] = state.color[i].r;
+            texel[9] = state.color[i].g;
+            texel[10] = state.color[i].b;
+            texel[11] = state.color[i].a;
+        }
+
+        // the light texture only grows, in steps of whole powers of two,
+        // so that a fluctuating light count doesn't reallocate it every frame.
+        const auto lightTextureSize = state.lightTexture.getSize();
+        if (lightTextureSize.x != lightTextureWidth || lightTextureSize.y < lightRows) {
+            uint32_t rows = 1;
+            while (rows < lightRows) {
+                rows <<= 1;
+            }
+            ensureTextureSize(state.lightTexture, { lightTextureWidth, rows });
+        }
+        state.lightTexture.update(state.lightPixels.data(), { lightTextureWidth, lightRows }, { 0, 0 });
+
+        // per-tile light count, in the red channel.
+        const size_t tileCount = state.tileCounts.size();
+        state.tileCountPixels.resize(tileCount * 4);
+        for (size_t tile = 0; tile < tileCount; ++tile) {
+            state.tileCountPixels[tile * 4] = state.tileCounts[tile];
+        }
+        ensureTextureSize(state.tileCountTexture, { state.tilesX, state.tilesY });
+        state.tileCountTexture.update(state.tileCountPixels.data());
+
+        // per-tile light indices, two 16-bit indices per texel.
+        // every tile owns a fixed span of MAX_LIGHTS_PER_TILE / 2 texels in its row,
+        // only the used part of it is written, the shader never reads past the count.
+        const uint32_t texelsPerTile = MAX_LIGHTS_PER_TILE / 2;
+        const uint32_t indexTextureWidth = state.tilesX * texelsPerTile;
+        state.tileIndexPixels.resize(static_cast<size_t>(indexTextureWidth) * state.tilesY * 4);
+        for (size_t tile = 0; tile < tileCount; ++tile) {
+            const uint8_t count = state.tileCounts[tile];
+            const uint16_t* indices = state.tileIndices.data() + tile * MAX_LIGHTS_PER_TILE;
+            uint8_t* texel = state.tileIndexPixels.data() + tile * texelsPerTile * 4;
+            for (uint8_t slot = 0; slot < count; ++slot) {
+                write16(texel + slot * 2, indices[slot]);
+            }
+        }
+        ensureTextureSize(state.tileIndexTexture, { indexTextureWidth, state.tilesY });
+        state.tileIndexTexture.update(state.tileIndexPixels.data());
+    }
+
+    void SLightingSystem::TiledState::clearLights() {
+        posX.clear();
+        posY.clear();
+        radius.clear();
+        exponent.clear();
+        color.clear();
+    }
+
+    SLightingSystem::TiledState& SLightingSystem::getTiledState() {
+        static TiledState s_state;
+        return s_state;
+    }
+
+    sf::FloatRect SLightingSystem::getViewBounds(const sf::View& view) {
+        // the views used here are never rotated, so an axis-aligned box is enough.
+        return { view.getCenter() - view.getSize() * 0.5f, view.getSize() };
+    }
+
+    bool SLightingSystem::isLightVisible(const sf::FloatRect& viewBounds, sf::Vector2f center, float radius) {
+        // circle-rectangle intersection: clamp the center into the rectangle,
+        // and check whether the closest point lies within the radius.
+        const auto min = viewBounds.position;
+        const auto max = viewBounds.position + viewBounds.size;
+        const sf::Vector2f closest {
+            std::clamp(center.x, min.x, max.x),
+            std::clamp(center.y, min.y, max.y)
+        };
+        return (closest - center).lengthSquared() <= radius * radius;
+    }
+
+    void SLightingSystem::appendLight(std::vector<sf::Vertex>& vertices, sf::Vector2f center, const CLightingComponent& lighting) {
+        const auto radius = lighting.getRadius();
+        const auto color = lighting.getColor();
+        const auto exponent = lighting.getAttenuationExponent();
+
+        // texCoords.x carries the attenuation exponent,
+        // texCoords.y carries the corner index (0: top-left, 1: top-right, 2: bottom-left, 3: bottom-right),
+        // which the vertex shader turns back into the local quad coordinates.
+        // both values are constant across a corner, so nothing gets lost in interpolation.
+        auto corner = [&](float index) {
+            const float x = std::fmod(index, 2.f);
+            const float y = index >= 2.f ? 1.f : 0.f;
+            return sf::Vertex {
+                center + sf::Vector2f { (x * 2.f - 1.f) * radius, (y * 2.f - 1.f) * radius },
+                color,
+                sf::Vector2f { exponent, index }
+            };
+        };
+
+        const auto topLeft = corner(0.f);
+        const auto topRight = corner(1.f);
+        const auto bottomLeft = corner(2.f);
+        const auto bottomRight = corner(3.f);
+
+        vertices.push_back(topLeft);
+        vertices.push_back(topRight);
+        vertices.push_back(bottomLeft);
+        vertices.push_back(bottomLeft);
+        vertices.push_back(topRight);
+        vertices.push_back(bottomRight);
+    }
+
     sf::Shader& SLightingSystem::getShader() {
         static sf::Shader s_shader;
         static bool s_initialized = false;
 
         const static std::string c_vertShader = R"(
+            #version 120
+
+            varying vec2 localCoords;
+            varying float attenuationExponent;
+
             void main()
             {
                 gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
-                gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+
+                float corner = gl_MultiTexCoord0.y;
+                localCoords = vec2(mod(corner, 2.0), floor(corner / 2.0));
+                attenuationExponent = gl_MultiTexCoord0.x;
+
                 gl_FrontColor = gl_Color;
             }
         )";
@@ -53,15 +387,11 @@ namespace game {
         const static std::string c_fragShader = R"(
             #version 120
 
-            uniform vec4 lightColor;
-            uniform float attenuationExponent;
+            varying vec2 localCoords;
+            varying float attenuationExponent;
 
-            float absolute(float x) {
-                return x < 0.0 ? -x : x;
-            }
             void main() {
-                vec2 texCoords = gl_TexCoord[0].xy;
-                vec2 relativePos = texCoords - vec2(0.5);
+                vec2 relativePos = localCoords - vec2(0.5);
 
                 float distance = length(relativePos);
                 if (distance > 0.5) {
@@ -73,6 +403,7 @@ namespace game {
                 //float attenuation = 1.0 / (attenuationConstant + attenuationLinear * realDistance + attenuationQuadratic * realDistance * realDistance);
                 float attenuation = pow(1.0 - realDistance, attenuationExponent);
 
+                vec4 lightColor = gl_Color;
                 vec4 finalColor = lightColor;
                 finalColor.a = lightColor.a * attenuation;
 
@@ -89,16 +420,110 @@ namespace game {
         return s_shader;
     }
 
-    sf::Texture& SLightingSystem::getDummyTexture() {
-        static sf::Texture s_dummyTexture;
-        static sf::Image s_dummyImage;
+    sf::Shader& SLightingSystem::getTiledShader() {
+        static sf::Shader s_shader;
         static bool s_initialized = false;
 
+        const static std::string c_vertShader = R"(
+            #version 120
+
+            varying vec2 pixelCoords;
+
+            void main()
+            {
+                gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+                pixelCoords = gl_MultiTexCoord0.xy;
+                gl_FrontColor = gl_Color;
+            }
+        )";
+
+        // the layout constants are shared with the cpu side, GLSL 120 wants the loop bound to be a constant.
+        const static std::string c_fragShader =
+            "#version 120\n"
+            "#define MAX_LIGHTS_PER_TILE " + std::to_string(MAX_LIGHTS_PER_TILE) + "\n"
+            "#define LIGHTS_PER_ROW " + std::to_string(LIGHTS_PER_ROW) + ".0\n"
+            "#define TEXELS_PER_LIGHT " + std::to_string(TEXELS_PER_LIGHT) + ".0\n"
+            "#define TILE_SIZE " + std::to_string(TILE_SIZE) + ".0\n"
+            "#define POSITION_BIAS " + std::to_string(c_positionBias) + "\n"
+            "#define POSITION_SCALE " + std::to_string(c_positionScale) + "\n"
+            "#define EXPONENT_SCALE " + std::to_string(c_exponentScale) + "\n"
+            R"(
+            uniform sampler2D u_lights;
+            uniform vec2 u_lightsSize;
+            uniform sampler2D u_tileCounts;
+            uniform vec2 u_tileCountsSize;
+            uniform sampler2D u_tileIndices;
+            uniform vec2 u_tileIndicesSize;
+
+            varying vec2 pixelCoords;
+
+            vec4 fetch(sampler2D source, vec2 size, vec2 texel) {
+                return texture2D(source, (texel + vec2(0.5)) / size);
+            }
+
+            float decode8(float value) {
+                return floor(value * 255.0 + 0.5);
+            }
+
+            float decode16(float high, float low) {
+                return decode8(high) * 256.0 + decode8(low);
+            }
+
+            void main() {
+                vec2 tile = floor(pixelCoords / TILE_SIZE);
+                float count = decode8(fetch(u_tileCounts, u_tileCountsSize, tile).r);
+
+                vec4 result = vec4(0.0);
+                for (int i = 0; i < MAX_LIGHTS_PER_TILE; ++i) {
+                    float slot = float(i);
+                    if (slot >= count) {
+                        break;
+                    }
+
+                    float indexTexel = tile.x * float(MAX_LIGHTS_PER_TILE / 2) + floor(slot / 2.0);
+                    vec4 packedIndices = fetch(u_tileIndices, u_tileIndicesSize, vec2(indexTexel, tile.y));
+                    float index = mod(slot, 2.0) < 0.5
+                        ? decode16(packedIndices.r, packedIndices.g)
+                        : decode16(packedIndices.b, packedIndices.a);
+
+                    float row = floor(index / LIGHTS_PER_ROW);
+                    float column = (index - row * LIGHTS_PER_ROW) * TEXELS_PER_LIGHT;
+                    vec4 position = fetch(u_lights, u_lightsSize, vec2(column, row));
+                    vec4 shape = fetch(u_lights, u_lightsSize, vec2(column + 1.0, row));
+                    vec4 lightColor = fetch(u_lights, u_lightsSize, vec2(column + 2.0, row));
+
+                    vec2 center = vec2(decode16(position.r, position.g), decode16(position.b, position.a)) / POSITION_SCALE - vec2(POSITION_BIAS);
+                    float radius = decode16(shape.r, shape.g) / POSITION_SCALE;
+                    float attenuationExponent = decode16(shape.b, shape.a) / EXPONENT_SCALE;
+
+                    float realDistance = length(pixelCoords - center) / radius;
+                    if (realDistance > 1.0) {
+                        continue;
+                    }
+
+                    // same falloff as the forward backend,
+                    // and the same result as drawing the lights one by one with alpha blending.
+                    float alpha = lightColor.a * pow(1.0 - realDistance, attenuationExponent);
+                    result.rgb = lightColor.rgb * alpha + result.rgb * (1.0 - alpha);
+                    result.a = alpha + result.a * (1.0 - alpha);
+                }
+
+                gl_FragColor = result;
+            }
+        )";
+
         if (!s_initialized) {
-            s_dummyImage = sf::Image({1, 1});
-            s_dummyTexture = sf::Texture(s_dummyImage);
+            if (!s_shader.loadFromMemory(std::string_view(c_vertShader), std::string_view(c_fragShader))) {
+                throw std::runtime_error("LightingControl: failed to load tiled shader");
+            }
             s_initialized = true;
         }
-        return s_dummyTexture;
+        return s_shader;
+    }
+
+    std::vector<sf::Vertex>& SLightingSystem::getVertexBuffer() {
+        // kept across frames, so that the capacity is reused.
+        static std::vector<sf::Vertex> s_vertices;
+        return s_vertices;
     }
-}
\ No newline at end of file
+}
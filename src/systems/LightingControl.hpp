@@ -5,17 +5,115 @@
 #ifndef GAME25SP_LIGHTINGCONTROL_HPP
 #define GAME25SP_LIGHTINGCONTROL_HPP
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
+#include "SFML/Graphics/Color.hpp"
+#include "SFML/Graphics/Rect.hpp"
 #include "SFML/Graphics/RenderTarget.hpp"
+#include "SFML/Graphics/Shader.hpp"
+#include "SFML/Graphics/Texture.hpp"
+#include "SFML/Graphics/Vertex.hpp"
 
 namespace game {
+    struct CLightingComponent;
+
+    enum class LightingBackend {
+        /**
+         * every light is drawn as its own alpha-blended quad.
+         * cheap for a handful of lights, but the overdraw grows with the overlap.
+         */
+        Forward,
+        /**
+         * lights are binned into screen tiles on the cpu,
+         * then a single full-screen pass evaluates only the lights touching each tile.
+         * meant for scenes with thousands of lights.
+         */
+        Tiled,
+    };
+
     class SLightingSystem {
     public:
         static void update(sf::RenderTarget& target);
+
+        static void setBackend(LightingBackend backend);
+        static LightingBackend getBackend();
     private:
+        static constexpr size_t VERTICES_PER_LIGHT = 6;
+
+        /**
+         * tile edge length, in target pixels.
+         */
+        static constexpr uint32_t TILE_SIZE = 32;
+        /**
+         * lights beyond this count in a single tile are dropped for that tile.
+         * must be even, as two indices share one texel.
+         */
+        static constexpr uint32_t MAX_LIGHTS_PER_TILE = 64;
+        /**
+         * light indices are packed as 16-bit values.
+         */
+        static constexpr uint32_t MAX_TILED_LIGHTS = 16384;
+        /**
+         * each light takes 3 texels in the light data texture, this many lights share a row.
+         */
+        static constexpr uint32_t LIGHTS_PER_ROW = 512;
+        static constexpr uint32_t TEXELS_PER_LIGHT = 3;
+        /**
+         * below this count the binning is done on the calling thread,
+         * as the scheduling costs more than the work itself.
+         */
+        static constexpr size_t PARALLEL_BINNING_THRESHOLD = 256;
+
+        /**
+         * per-frame state of the tiled backend, kept across frames to reuse the allocations.
+         * the light attributes are stored as separate arrays (in target pixels),
+         * which keeps the bounds computation in binLights() a plain loop over floats.
+         */
+        struct TiledState {
+            std::vector<float> posX;
+            std::vector<float> posY;
+            std::vector<float> radius;
+            std::vector<float> exponent;
+            std::vector<sf::Color> color;
+
+            std::vector<int32_t> minTileX;
+            std::vector<int32_t> maxTileX;
+            std::vector<int32_t> minTileY;
+            std::vector<int32_t> maxTileY;
+
+            uint32_t tilesX = 0;
+            uint32_t tilesY = 0;
+            std::vector<uint8_t> tileCounts;
+            std::vector<uint16_t> tileIndices;
+
+            std::vector<uint8_t> lightPixels;
+            std::vector<uint8_t> tileCountPixels;
+            std::vector<uint8_t> tileIndexPixels;
+
+            sf::Texture lightTexture;
+            sf::Texture tileCountTexture;
+            sf::Texture tileIndexTexture;
+
+            void clearLights();
+            [[nodiscard]] size_t getLightCount() const { return posX.size(); }
+        };
+
+        static void updateForward(sf::RenderTarget& target);
+        static void updateTiled(sf::RenderTarget& target);
+
+        static LightingBackend& getBackendRef();
+        static TiledState& getTiledState();
+        static void binLights(TiledState& state, sf::Vector2u targetSize);
+        static void uploadTiledState(TiledState& state);
+
         static sf::Shader& getShader();
-        static sf::Texture& getDummyTexture();
+        static sf::Shader& getTiledShader();
+        static std::vector<sf::Vertex>& getVertexBuffer();
+        static sf::FloatRect getViewBounds(const sf::View& view);
+        static bool isLightVisible(const sf::FloatRect& viewBounds, sf::Vector2f center, float radius);
+        static void appendLight(std::vector<sf::Vertex>& vertices, sf::Vector2f center, const CLightingComponent& lighting);
     };
 }
 
@@ -4,17 +4,60 @@
 
 #include "MovementControl.hpp"
 
+#include <vector>
+
+#include "components/Pool.hpp"
 #include "components/Velocity.hpp"
-#include "utils/MovementUtils.hpp"
+#include "systems/SceneControl.hpp"
 
 namespace game {
+    namespace {
+        auto movementGroup(entt::registry& registry) {
+            return registry.group<CLocalTransform, CVelocity>(entt::exclude<CPooled>);
+        }
+    }
+
+    void SMovementSystem::init() {
+        // owning both storages keeps every moving entity packed at the front of them, in the same order.
+        movementGroup(getRegistry());
+    }
+
     void SMovementSystem::update(sf::Time deltaTime) {
         auto& registry = getRegistry();
-        auto view = registry.view<CLocalTransform, CVelocity>();
-        for (auto entity : view) {
-            MovementUtils::move(entity,
-                view.get<CVelocity>(entity).getVelocity() * deltaTime.asSeconds());
-            view.get<CVelocity>(entity).update(deltaTime);
+        const float dt = deltaTime.asSeconds();
+
+        static std::vector<entt::entity> moved;
+        moved.clear();
+
+        for (auto [entity, localTransform, velocity] : movementGroup(registry).each()) {
+            if (integrate(localTransform, velocity, dt)) {
+                moved.push_back(entity);
+            }
+        }
+
+        markAsDirty(moved);
+    }
+
+    bool SMovementSystem::integrate(CLocalTransform& localTransform, CVelocity& velocity, const float deltaTime) {
+        // plain scalar code. with the position and the velocity in two storages, one entity fills half a register
+        // at best, and packing two of them costs more shuffles than the four multiply-adds it would save.
+        const auto offset = velocity.m_velocity * deltaTime;
+        localTransform.m_position += offset;
+        velocity.m_velocity += velocity.m_acceleration * deltaTime;
+
+        return offset.x != 0.f || offset.y != 0.f;
+    }
+
+    void SMovementSystem::markAsDirty(const std::vector<entt::entity>& moved) {
+        auto& dirtySet = SceneTreeUtils::getDirtySet();
+        for (const auto entity : moved) {
+            if (!dirtySet.insert(entity)) {
+                continue;
+            }
+            // the subtrees go along with their roots. most of what moves (bullets) has no children though.
+            SceneTreeUtils::forEachChild(entity, [](const entt::entity child) {
+                SceneTreeUtils::markAsDirty(child);
+            });
         }
     }
-} // game
\ No newline at end of file
+} // game
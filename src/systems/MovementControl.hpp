@@ -4,15 +4,34 @@
 
 #ifndef MOVEMENTCONTROL_HPP
 #define MOVEMENTCONTROL_HPP
+#include <vector>
 #include <entt/entity/entity.hpp>
 
 #include "components/Layout.hpp"
+#include "SFML/System/Time.hpp"
 #include "SFML/System/Vector2.hpp"
 
 namespace game {
+    struct CVelocity;
+
+    /**
+     * Integrates CVelocity into CLocalTransform, over an owning group of the two.
+     * This skips MovementUtils::move(): no update signal of CLocalTransform is fired,
+     * and the moved entities are marked as dirty together at the end.
+     */
     class SMovementSystem {
     public:
+        /**
+         * Declares the group, before any entity is created.
+         */
+        static void init();
         static void update(sf::Time deltaTime);
+    private:
+        /**
+         * @return false if the entity stood still
+         */
+        static bool integrate(CLocalTransform& localTransform, CVelocity& velocity, float deltaTime);
+        static void markAsDirty(const std::vector<entt::entity>& moved);
     };
 } // game
 
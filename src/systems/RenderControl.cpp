@@ -6,13 +6,62 @@
 
 #include "Common.hpp"
 #include "components/Layout.hpp"
+#include "components/Pool.hpp"
 #include "components/Render.hpp"
 #include "components/SceneTree.hpp"
+#include "systems/SceneControl.hpp"
+
+namespace {
+    // owns what only the render loop reads. the layers are sorted every frame,
+    // and the transforms are shared with the layout, so these two are only looked up.
+    auto renderGroup(entt::registry& registry) {
+        return registry.group<game::CRenderComponent, game::CRenderTargetComponent>(
+                entt::get<game::CRenderLayerComponent, game::CGlobalTransform>,
+                entt::exclude<game::CPooled>);
+    }
+
+    template <typename T>
+    constexpr game::RenderKind renderKindOf();
+
+    template <>
+    constexpr game::RenderKind renderKindOf<game::CSpriteRenderComponent>() { return game::RenderKind::Sprite; }
+    template <>
+    constexpr game::RenderKind renderKindOf<game::CAnimatedSpriteRenderComponent>() { return game::RenderKind::AnimatedSprite; }
+    template <>
+    constexpr game::RenderKind renderKindOf<game::CTextRenderComponent>() { return game::RenderKind::Text; }
+    template <>
+    constexpr game::RenderKind renderKindOf<game::CShapeRenderComponent>() { return game::RenderKind::Shape; }
+    template <>
+    constexpr game::RenderKind renderKindOf<game::CTiledRenderComponent>() { return game::RenderKind::Tiled; }
+}
+
+void game::SRenderSystem::init() {
+    auto& registry = game::getRegistry();
+
+    registry.on_construct<CRenderComponent>().connect<&SRenderSystem::onRenderComponentConstruct>();
+
+    registry.on_construct<CSpriteRenderComponent>().connect<&SRenderSystem::onRenderableConstruct<CSpriteRenderComponent>>();
+    registry.on_construct<CAnimatedSpriteRenderComponent>().connect<&SRenderSystem::onRenderableConstruct<CAnimatedSpriteRenderComponent>>();
+    registry.on_construct<CTextRenderComponent>().connect<&SRenderSystem::onRenderableConstruct<CTextRenderComponent>>();
+    registry.on_construct<CShapeRenderComponent>().connect<&SRenderSystem::onRenderableConstruct<CShapeRenderComponent>>();
+    registry.on_construct<CTiledRenderComponent>().connect<&SRenderSystem::onRenderableConstruct<CTiledRenderComponent>>();
+
+    registry.on_destroy<CSpriteRenderComponent>().connect<&SRenderSystem::onRenderableDestroy<CSpriteRenderComponent>>();
+    registry.on_destroy<CAnimatedSpriteRenderComponent>().connect<&SRenderSystem::onRenderableDestroy<CAnimatedSpriteRenderComponent>>();
+    registry.on_destroy<CTextRenderComponent>().connect<&SRenderSystem::onRenderableDestroy<CTextRenderComponent>>();
+    registry.on_destroy<CShapeRenderComponent>().connect<&SRenderSystem::onRenderableDestroy<CShapeRenderComponent>>();
+    registry.on_destroy<CTiledRenderComponent>().connect<&SRenderSystem::onRenderableDestroy<CTiledRenderComponent>>();
+
+    renderGroup(registry);
+}
 
 void game::SRenderSystem::update(sf::RenderTarget& target, size_t targetId, sf::Time deltaTime) {
     auto& registry = game::getRegistry();
 
-    registry.sort<CRenderLayerComponent>(
+    // only the renderable part is sorted, and the owned storages follow along,
+    // so the group is iterated front to back in layer order.
+    auto group = renderGroup(registry);
+    group.sort<CRenderLayerComponent>(
         [](const auto& lhs, const auto& rhs) {
             if (lhs.getLayer() == rhs.getLayer()) {
                 return lhs.getOrder() < rhs.getOrder();
@@ -20,38 +69,86 @@ void game::SRenderSystem::update(sf::RenderTarget& target, size_t targetId, sf::
             return lhs.getLayer() < rhs.getLayer();
     });
 
-    auto commonView = registry.view<CGlobalTransform, CRenderComponent, CRenderLayerComponent, CRenderTargetComponent>();
-    // make sure that the ordering is applied.
-    // see also: https://github.com/skypjack/entt/issues/752
-    commonView.use<CRenderLayerComponent>();
+    // the storages are looked up once per frame instead of once per entity and kind.
+    // the layer ordering interleaves the kinds, so they are still drawn in a single pass.
+    auto& sprites = registry.storage<CSpriteRenderComponent>();
+    auto& animatedSprites = registry.storage<CAnimatedSpriteRenderComponent>();
+    auto& texts = registry.storage<CTextRenderComponent>();
+    auto& shapes = registry.storage<CShapeRenderComponent>();
+    auto& tiles = registry.storage<CTiledRenderComponent>();
 
-    for (auto entity : commonView) {
-        size_t renderTargetId = commonView.get<CRenderTargetComponent>(entity).getTargetId();
-        if (!checkRenderTargetMask(renderTargetId, targetId)) {
+    for (auto [entity, renderComponent, renderTarget, renderLayer, globalTransform] : group.each()) {
+        if (!checkRenderTargetMask(renderTarget.getTargetId(), targetId)) {
             continue;
         }
 
-        auto globalTransform = commonView.get<CGlobalTransform>(entity);
-        if (registry.any_of<CSpriteRenderComponent>(entity)) {
-            registry.get<CSpriteRenderComponent>(entity).update(target, globalTransform);
-            continue;
-        }
-        if (registry.any_of<CAnimatedSpriteRenderComponent>(entity)) {
-            registry.get<CAnimatedSpriteRenderComponent>(entity).update(target, deltaTime, globalTransform);
-            continue;
-        }
-        if (registry.any_of<CTextRenderComponent>(entity)) {
-            registry.get<CTextRenderComponent>(entity).update(target, globalTransform);
-            continue;
+        switch (renderComponent.kind) {
+            case RenderKind::Sprite:
+                sprites.get(entity).update(target, globalTransform);
+                break;
+            case RenderKind::AnimatedSprite:
+                animatedSprites.get(entity).update(target, deltaTime, globalTransform);
+                break;
+            case RenderKind::Text:
+                texts.get(entity).update(target, globalTransform);
+                break;
+            case RenderKind::Shape:
+                shapes.get(entity).update(target, globalTransform);
+                break;
+            case RenderKind::Tiled:
+                tiles.get(entity).update(target, deltaTime, globalTransform);
+                break;
+            case RenderKind::None:
+                // todo: implement other render systems
+                break;
         }
-        if (registry.any_of<CShapeRenderComponent>(entity)) {
-            registry.get<CShapeRenderComponent>(entity).update(target, globalTransform);
-            continue;
-        }
-        // todo: implement other render systems
     }
 }
 
+game::RenderKind game::SRenderSystem::resolveRenderKind(const entt::registry& registry, entt::entity entity,
+                                                         const RenderKind ignored) {
+    // same precedence as the render loop used to have.
+    if (ignored != RenderKind::Sprite && registry.any_of<CSpriteRenderComponent>(entity)) {
+        return RenderKind::Sprite;
+    }
+    if (ignored != RenderKind::AnimatedSprite && registry.any_of<CAnimatedSpriteRenderComponent>(entity)) {
+        return RenderKind::AnimatedSprite;
+    }
+    if (ignored != RenderKind::Text && registry.any_of<CTextRenderComponent>(entity)) {
+        return RenderKind::Text;
+    }
+    if (ignored != RenderKind::Shape && registry.any_of<CShapeRenderComponent>(entity)) {
+        return RenderKind::Shape;
+    }
+    if (ignored != RenderKind::Tiled && registry.any_of<CTiledRenderComponent>(entity)) {
+        return RenderKind::Tiled;
+    }
+    return RenderKind::None;
+}
+
+void game::SRenderSystem::onRenderComponentConstruct(entt::registry& registry, entt::entity entity) {
+    registry.get<CRenderComponent>(entity).kind = resolveRenderKind(registry, entity);
+}
+
+template <typename T>
+void game::SRenderSystem::onRenderableConstruct(entt::registry& registry, entt::entity entity) {
+    if (auto* renderComponent = registry.try_get<CRenderComponent>(entity)) {
+        renderComponent->kind = resolveRenderKind(registry, entity);
+    }
+}
+
+template <typename T>
+void game::SRenderSystem::onRenderableDestroy(entt::registry& registry, entt::entity entity) {
+    auto* renderComponent = registry.try_get<CRenderComponent>(entity);
+    if (renderComponent == nullptr || renderComponent->kind != renderKindOf<T>()) {
+        return;
+    }
+
+    // the component being destroyed is still in its storage at this point,
+    // so it is skipped, and whatever else the entity draws takes over.
+    renderComponent->kind = resolveRenderKind(registry, entity, renderKindOf<T>());
+}
+
 bool game::RenderUtils::isVisible(entt::entity entity) {
     auto& registry = game::getRegistry();
     return registry.any_of<CRenderComponent>(entity);
@@ -65,9 +162,9 @@ void game::RenderUtils::markAsInvisible(entt::entity entity) {
         return;
     }
 
-    for (auto child : registry.get<CChild>(entity).getChildren()) {
+    SceneTreeUtils::forEachChild(entity, [](const entt::entity child) {
         markAsInvisible(child);
-    }
+    });
     markAsInvisibleNotRecurse(entity);
 }
 
@@ -79,9 +176,9 @@ void game::RenderUtils::markAsVisible(entt::entity entity) {
         return;
     }
 
-    for (auto child : registry.get<CChild>(entity).getChildren()) {
+    SceneTreeUtils::forEachChild(entity, [](const entt::entity child) {
         markAsVisible(child);
-    }
+    });
     markAsVisibleNotRecurse(entity);
 }
 
@@ -4,7 +4,9 @@
 
 #ifndef RENDERCONTROL_HPP
 #define RENDERCONTROL_HPP
+#include <cstdint>
 #include <entt/entity/entity.hpp>
+#include <entt/entity/fwd.hpp>
 
 #include "SFML/System/Time.hpp"
 
@@ -14,11 +16,29 @@ namespace sf {
 }
 
 namespace game {
+    enum class RenderKind : uint8_t;
+
     class SRenderSystem {
     public:
+        /**
+         * Connects the signals which keep CRenderComponent::kind up to date, and declares the render group.
+         * Must be called once before any renderable is created.
+         */
+        static void init();
         static void update(sf::RenderTarget& target, size_t targetId, sf::Time deltaTime);
     private:
         static bool checkRenderTargetMask(size_t targetId, size_t mask);
+
+        /**
+         * @param ignored a kind to skip, for a component which is about to be removed but still present
+         */
+        static RenderKind resolveRenderKind(const entt::registry& registry, entt::entity entity,
+                                            RenderKind ignored = RenderKind::None);
+        static void onRenderComponentConstruct(entt::registry& registry, entt::entity entity);
+        template <typename T>
+        static void onRenderableConstruct(entt::registry& registry, entt::entity entity);
+        template <typename T>
+        static void onRenderableDestroy(entt::registry& registry, entt::entity entity);
     };
 
     class RenderUtils {
@@ -4,10 +4,21 @@
 
 #include "SceneControl.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 #include "Common.hpp"
 #include "Logger.hpp"
+#include "ThreadPool.hpp"
 #include "components/SceneTree.hpp"
 #include "components/Layout.hpp"
+#include "components/Pool.hpp"
+#include "utils/PrefabPool.hpp"
+#include "utils/TransformUtils.hpp"
 
 entt::entity game::SceneTreeUtils::attachSceneTreeComponents(entt::entity entity) {
     auto& registry = game::getRegistry();
@@ -28,20 +39,18 @@ entt::entity game::SceneTreeUtils::attachSceneTreeComponents(entt::entity entity
 entt::entity game::SceneTreeUtils::detachSceneTreeComponents(entt::entity entity) {
     auto& registry = game::getRegistry();
 
-    if (registry.any_of<CSceneElementNeedsUpdate>(entity)) {
+    if (isDirty(entity)) {
         markAsCleanRecurse(entity);
     }
 
-    auto parent = registry.get<CParent>(entity);
-    if (parent.getParent() != entt::null) {
-        detachChild(parent.getParent(), entity);
+    const auto parent = registry.get<CParent>(entity).getParent();
+    if (parent != entt::null) {
+        detachChild(parent, entity);
     }
 
-    if (registry.get<CChild>(entity).hasChildren()) {
-        for (const auto child : registry.get<CChild>(entity).getChildren()) {
-            detachParent(child, entity);
-        }
-    }
+    forEachChild(entity, [entity](const entt::entity child) {
+        detachParent(child, entity);
+    });
 
     registry.remove<CNode>(entity);
     registry.remove<CParent>(entity);
@@ -60,12 +69,14 @@ entt::entity game::SceneTreeUtils::attachChild(const entt::entity parent, const
         throw std::runtime_error("Child entity does not have CParent component.");
     }
 
-    registry.get<CChild>(parent).addChild(child);
-
-    if (registry.get<CParent>(child).getParent() != entt::null) {
-        detachParent(child, registry.get<CParent>(child).getParent());
+    const auto previousParent = registry.get<CParent>(child).getParent();
+    if (previousParent == parent) {
+        return child;
     }
-    registry.get<CParent>(child).setParent(parent);
+    if (previousParent != entt::null) {
+        detachParent(child, previousParent);
+    }
+    linkChild(parent, child);
 
     markAsDirty(child);
 
@@ -82,8 +93,11 @@ entt::entity game::SceneTreeUtils::detachChild(const entt::entity parent, const
         throw std::runtime_error("Child entity does not have CParent component.");
     }
 
-    registry.get<CChild>(parent).removeChild(child);
-    registry.get<CParent>(child).setParent(entt::null);
+    if (registry.get<CParent>(child).getParent() != parent) {
+        getLogger().logWarn("SceneTreeUtils::detachChild(): entity is not a child of the given parent.");
+        return child;
+    }
+    unlinkChild(parent, child);
 
     markAsDirty(child);
 
@@ -126,146 +140,293 @@ entt::entity game::SceneTreeUtils::detachParent(entt::entity child, entt::entity
 }
 
 entt::entity game::SceneTreeUtils::markAsDirty(entt::entity entity) {
-    auto& registry = game::getRegistry();
-
-    if (registry.any_of<CSceneElementNeedsUpdate>(entity)) {
+    if (!s_dirtySet.insert(entity)) {
         // already dirty
         return entity;
     }
 
-    registry.emplace<CSceneElementNeedsUpdate>(entity);
-
-    for (const auto child : registry.get<CChild>(entity).getChildren()) {
+    forEachChild(entity, [](const entt::entity child) {
         markAsDirty(child);
-    }
+    });
     // this will recursively mark all children as dirty
 
     return entity;
 }
 
 entt::entity game::SceneTreeUtils::markAsClean(entt::entity entity) {
-    auto& registry = game::getRegistry();
-
-    if (!registry.any_of<CSceneElementNeedsUpdate>(entity)) {
-        // already clean
-        return entity;
-    }
-
-    registry.remove<CSceneElementNeedsUpdate>(entity);
+    s_dirtySet.erase(entity);
     // in the meantime, we shouldn't mark children as clean even if its parent is clean
     return entity;
 }
 
 entt::entity game::SceneTreeUtils::markAsCleanRecurse(entt::entity entity) {
-    auto& registry = game::getRegistry();
-    if (registry.any_of<CSceneElementNeedsUpdate>(entity)) {
-        // only mark as clean if it's dirty
-        markAsClean(entity);
-    }
+    markAsClean(entity);
 
-    for (const auto child : registry.get<CChild>(entity).getChildren()) {
+    forEachChild(entity, [](const entt::entity child) {
         markAsCleanRecurse(child);
-    }
+    });
 
     return entity;
 }
 
-bool game::SceneTreeUtils::isDirty(entt::entity entity) {
+bool game::SceneTreeUtils::isChildOf(const entt::entity child, const entt::entity parent) {
     auto& registry = game::getRegistry();
-    return registry.any_of<CSceneElementNeedsUpdate>(entity);
+    return registry.any_of<CParent>(child) && registry.get<CParent>(child).getParent() == parent;
+}
+
+void game::SceneTreeUtils::linkChild(const entt::entity parent, const entt::entity child) {
+    auto& registry = game::getRegistry();
+    auto& children = registry.get<CChild>(parent);
+    auto& node = registry.get<CParent>(child);
+
+    // prepended, the order of children does not matter anywhere.
+    node.m_parent = parent;
+    node.m_previousSibling = entt::null;
+    node.m_nextSibling = children.m_firstChild;
+    if (children.m_firstChild != entt::null) {
+        registry.get<CParent>(children.m_firstChild).m_previousSibling = child;
+    }
+    children.m_firstChild = child;
+    children.m_childCount++;
+}
+
+void game::SceneTreeUtils::unlinkChild(const entt::entity parent, const entt::entity child) {
+    auto& registry = game::getRegistry();
+    auto& children = registry.get<CChild>(parent);
+    auto& node = registry.get<CParent>(child);
+
+    if (node.m_previousSibling != entt::null) {
+        registry.get<CParent>(node.m_previousSibling).m_nextSibling = node.m_nextSibling;
+    } else {
+        children.m_firstChild = node.m_nextSibling;
+    }
+    if (node.m_nextSibling != entt::null) {
+        registry.get<CParent>(node.m_nextSibling).m_previousSibling = node.m_previousSibling;
+    }
+
+    node.m_parent = entt::null;
+    node.m_previousSibling = entt::null;
+    node.m_nextSibling = entt::null;
+    children.m_childCount--;
 }
 
 void game::SceneTreeUtils::unmount(entt::entity entity) {
+    unmount(&entity, 1);
+}
+
+void game::SceneTreeUtils::unmount(const entt::entity* roots, const size_t count) {
     auto& registry = game::getRegistry();
 
-    if (!registry.valid(entity)) {
-        //getLogger().logWarn("Entity has been invalidated forehand.");
-        return;
+    // pooled subtrees found on the way, they go back to their pool instead.
+    std::vector<entt::entity> released;
+    std::vector<entt::entity> dying;
+    std::vector<entt::entity> stack;
+
+    for (size_t i = 0; i < count; i++) {
+        const auto root = roots[i];
+        if (!registry.valid(root)) {
+            //getLogger().logWarn("Entity has been invalidated forehand.");
+            continue;
+        }
+
+        if (!registry.any_of<CNode>(root)) {
+            throw std::runtime_error("Entity does not have CNode component.");
+        }
+
+        if (registry.any_of<CPooled>(root)) {
+            // already parked, nothing to tear down.
+            registry.remove<CUnmount>(root);
+            continue;
+        }
+
+        if (registry.any_of<CPoolable>(root)) {
+            released.push_back(root);
+            continue;
+        }
+
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const auto entity = stack.back();
+            stack.pop_back();
+            dying.push_back(entity);
+
+            forEachChild(entity, [&](const entt::entity child) {
+                if (registry.any_of<CPoolable>(child)) {
+                    released.push_back(child);
+                } else {
+                    stack.push_back(child);
+                }
+            });
+        }
     }
 
-    if (!registry.any_of<CNode>(entity)) {
-        throw std::runtime_error("Entity does not have CNode component.");
+    // the pools detach their subtrees, which needs the parents to be still alive.
+    for (const auto entity : released) {
+        if (registry.valid(entity)) {
+            // the subtree is kept as it is, the pool only parks it.
+            registry.get<CPoolable>(entity).getPool()->release(entity);
+        }
     }
 
-    // life cycle!!
-    // the problem is, unmounting a child will cause all the components to be destroyed
-    // and if we use inline iteration, as we hold a **reference** to the children list,
-    // it will cause the iterator to be invalidated!
-    const auto children = registry.get<CChild>(entity).getChildren();
-    for (const auto child : children) {
-        unmount(child);
+    if (dying.empty()) {
+        return;
     }
 
-    if (registry.any_of<CNode>(entity)) {
-        detachSceneTreeComponents(entity);
+    // a queued root may live in the subtree of another one.
+    std::sort(dying.begin(), dying.end());
+    dying.erase(std::unique(dying.begin(), dying.end()), dying.end());
+
+    // only the links into surviving parents have to be undone,
+    // everything else goes away together with the storages below.
+    for (const auto entity : dying) {
+        const auto parent = registry.get<CParent>(entity).getParent();
+        if (parent != entt::null && !std::binary_search(dying.begin(), dying.end(), parent)) {
+            unlinkChild(parent, entity);
+        }
     }
-    registry.destroy(entity);
 
-    /*getLogger().logDebug("invoked SceneTreeUtils::unmount() on entity "
-        + std::to_string(static_cast<entt::id_type>(entity)));*/
+    registry.destroy(dying.begin(), dying.end());
 }
 
+namespace {
+    using LayoutView = decltype(std::declval<entt::registry&>()
+            .view<game::CLayout, game::CParent, game::CLocalTransform, game::CGlobalTransform>());
+    using ParentView = decltype(std::declval<entt::registry&>().view<game::CParent>());
+    using ChildView = decltype(std::declval<entt::registry&>().view<game::CChild>());
+    using GlobalTransformView = decltype(std::declval<entt::registry&>().view<game::CGlobalTransform>());
+}
+
+// views only, so that the propagation never has to go through the registry from a pool thread.
+// the dirty set is only read while the layouts are computed.
+struct game::SScenePositionUpdateSystem::LayoutContext {
+    const DirtySet& dirtySet;
+    LayoutView layoutView;
+    ParentView parentView;
+    ChildView childView;
+    GlobalTransformView globalTransformView;
+
+    template <typename Fn>
+    void forEachDirtyChild(const entt::entity entity, Fn&& fn) const {
+        auto child = childView.get<CChild>(entity).getFirstChild();
+        while (child != entt::null) {
+            if (dirtySet.contains(child)) {
+                fn(child);
+            }
+            child = parentView.get<CParent>(child).getNextSibling();
+        }
+    }
+};
+
 void game::SScenePositionUpdateSystem::update() {
     auto& registry = game::getRegistry();
+    auto& dirtySet = SceneTreeUtils::getDirtySet();
 
-    // this is to prevent potential infinite loop
-    // at least we can make it easy to debug
-    constexpr size_t maxIterationLimit = 512;
-    size_t iterationCount = 0;
+    // entities destroyed while they were dirty are still listed.
+    dirtySet.retain([&registry](const entt::entity entity) {
+        return registry.valid(entity);
+    });
 
-    while (registry.view<CSceneElementNeedsUpdate>().size() > 0) {
-        if (++iterationCount > maxIterationLimit) {
-            getLogger().logError(
-                Logger::concatLineFile(
-                    "SceneGlobalPositionSystem::update() iteration count exceeded maxIterationLimit",
-                    __LINE__, __FILE_NAME__));
+    const size_t dirtyCount = dirtySet.size();
+    if (dirtyCount == 0) {
+        return;
+    }
 
-            for (const auto dirty : registry.view<CSceneElementNeedsUpdate>()) {
-                markEntityAsClean(dirty);
-            }
-            return;
+    const LayoutContext context {
+        dirtySet,
+        registry.view<CLayout, CParent, CLocalTransform, CGlobalTransform>(),
+        registry.view<CParent>(),
+        registry.view<CChild>(),
+        registry.view<CGlobalTransform>()
+    };
+
+    // marking an entity as dirty marks its whole subtree, see SceneTreeUtils::markAsDirty().
+    // so every dirty entity with a clean (or no) parent is the root of a dirty subtree.
+    // these subtrees don't share anything that is written, so they can be computed independently.
+    static std::vector<entt::entity> frontier;
+    static std::vector<entt::entity> nextFrontier;
+    frontier.clear();
+
+    for (const auto dirty : dirtySet.getEntities()) {
+        if (!context.parentView.contains(dirty)) {
+            // not part of the scene tree, reported below.
+            continue;
         }
+        const auto parent = context.parentView.get<CParent>(dirty).getParent();
+        if (parent == entt::null || !dirtySet.contains(parent)) {
+            frontier.push_back(dirty);
+        }
+    }
 
-        auto dirtyView = registry.view<CNode, CParent, CChild, CSceneElementNeedsUpdate>();
-        for (const auto dirty : dirtyView) {
-            bool canUpdateNow = false;
+    size_t visitedCount = 0;
+    bool missingLayout = false;
 
-            if (!registry.valid(dirty)) {
-                getLogger().logError(
-                    Logger::concatLineFile(
-                        "SceneGlobalPositionSystem::update() invalid entity",
-                        __LINE__, __FILE_NAME__));
-            }
+    // a few large subtrees (e.g. everything under the root) don't split well,
+    // so the top levels are computed here until there are enough subtrees to share out.
+    while (!frontier.empty() && frontier.size() < PARALLEL_MIN_SUBTREES) {
+        missingLayout |= !calculateLayouts(context, frontier.data(), frontier.size());
+        visitedCount += frontier.size();
 
-            auto parent = dirtyView.get<CParent>(dirty);
+        nextFrontier.clear();
+        for (const auto dirty : frontier) {
+            context.forEachDirtyChild(dirty, [](const entt::entity child) {
+                nextFrontier.push_back(child);
+            });
+        }
+        frontier.swap(nextFrontier);
+    }
 
-            if (parent.getParent() == entt::null) {
-                canUpdateNow = true;
-            } else {
-                if (!dirtyView.contains(parent.getParent())) {
-                    // so here the parent is not in the view,
-                    // which means that the parent is not dirty.
-                    canUpdateNow = true;
-                }
+    // the rest goes level by level per batch of subtrees, which computes each parent before its children,
+    // and lets calculateLayouts() compose whole lanes of transforms at once.
+    // nothing is added or removed from the registry in here, so the batches can run in parallel.
+    std::atomic<size_t> parallelVisitedCount { 0 };
+    std::atomic<bool> parallelMissingLayout { false };
+    const auto propagate = [&context, &parallelVisitedCount, &parallelMissingLayout](size_t begin, size_t end) {
+        thread_local std::vector<entt::entity> level;
+        thread_local std::vector<entt::entity> nextLevel;
+        level.assign(frontier.begin() + static_cast<std::ptrdiff_t>(begin), frontier.begin() + static_cast<std::ptrdiff_t>(end));
+
+        size_t batchVisitedCount = 0;
+        bool batchMissingLayout = false;
+
+        while (!level.empty()) {
+            batchMissingLayout |= !calculateLayouts(context, level.data(), level.size());
+            batchVisitedCount += level.size();
+
+            nextLevel.clear();
+            for (const auto dirty : level) {
+                context.forEachDirtyChild(dirty, [](const entt::entity child) {
+                    nextLevel.push_back(child);
+                });
             }
+            level.swap(nextLevel);
+        }
 
-            if (canUpdateNow) {
-                // todo: process transform.
-                calculateLayout(dirty);
-                markEntityAsClean(dirty);
-            }
+        parallelVisitedCount.fetch_add(batchVisitedCount, std::memory_order_relaxed);
+        if (batchMissingLayout) {
+            parallelMissingLayout.store(true, std::memory_order_relaxed);
         }
+    };
+
+    if (s_parallelPropagation) {
+        getThreadPool().parallelFor(0, frontier.size(), PARALLEL_BATCH_SIZE, propagate);
+    } else {
+        propagate(0, frontier.size());
     }
+    visitedCount += parallelVisitedCount.load(std::memory_order_relaxed);
+    missingLayout |= parallelMissingLayout.load(std::memory_order_relaxed);
 
-    if (registry.view<CSceneElementNeedsUpdate>().size() > 0) {
+    // whatever was not visited could not be reached from a root,
+    // i.e. it is not part of the scene tree or its parents form a cycle.
+    if (visitedCount != dirtyCount) {
         getLogger().logError(
             Logger::concatLineFile(
                 "SceneGlobalPositionSystem::update() dirty entities still exist",
                 __LINE__, __FILE_NAME__));
+    }
+    dirtySet.clear();
 
-        for (const auto dirty : registry.view<CSceneElementNeedsUpdate>()) {
-            markEntityAsClean(dirty);
-        }
+    if (missingLayout) {
+        throw std::runtime_error("Entity does not have CLayout component.");
     }
 }
 
@@ -277,55 +438,112 @@ void game::SScenePositionUpdateSystem::markEntityAsClean(entt::entity entity) {
     SceneTreeUtils::markAsClean(entity);
 }
 
-void game::SScenePositionUpdateSystem::calculateLayout(entt::entity entity) {
-    auto& registry = game::getRegistry();
-
-    if (!registry.any_of<CLayout>(entity)) {
-        throw std::runtime_error("Entity does not have CLayout component.");
-    }
-
-    auto layout = registry.get<CLayout>(entity);
-    auto parent = registry.get<CParent>(entity);
+void game::SScenePositionUpdateSystem::setParallelPropagation(const bool enabled) {
+    s_parallelPropagation = enabled;
+}
 
-    auto localTransform = registry.get<CLocalTransform>(entity);
+bool game::SScenePositionUpdateSystem::calculateLayouts(const LayoutContext& context, const entt::entity* entities, const size_t count) {
+    // this may run on any thread of the pool, so it must not touch the registry itself.
+    const auto& layoutView = context.layoutView;
+    const auto& globalTransformView = context.globalTransformView;
 
-    // we use anchor to calculate the origin offset
-    auto anchorOffset = layout.getAnchor().getAnchorVec();
-    auto calculatedOrigin = sf::Vector2f { anchorOffset.x * localTransform.getSize().x, anchorOffset.y * localTransform.getSize().y };
-    registry.get<CGlobalTransform>(entity).setOrigin(calculatedOrigin);
+    const auto cosSin = [](const sf::Angle angle) -> std::pair<float, float> {
+        if (angle == sf::Angle::Zero) {
+            return { 1.f, 0.f };
+        }
+        return { std::cos(angle.asRadians()), std::sin(angle.asRadians()) };
+    };
+
+    bool allFound = true;
+    TransformBatch batch {};
+    std::array<entt::entity, TransformBatch::LANES> lanes {};
+    std::array<sf::Angle, TransformBatch::LANES> rotations {};
+
+    for (size_t offset = 0; offset < count; offset += TransformBatch::LANES) {
+        const size_t laneCount = std::min(TransformBatch::LANES, count - offset);
+
+        // gather
+        batch = TransformBatch {};
+        size_t used = 0;
+        for (size_t i = 0; i < laneCount; i++) {
+            const auto entity = entities[offset + i];
+            if (!layoutView.contains(entity)) {
+                allFound = false;
+                continue;
+            }
 
-    auto absoluteScale = localTransform.getScale();
+            const auto& layout = layoutView.get<CLayout>(entity);
+            const auto& localTransform = layoutView.get<CLocalTransform>(entity);
+            const auto parent = layoutView.get<CParent>(entity).getParent();
+
+            sf::Vector2f parentPosition { 0.f, 0.f };
+            sf::Vector2f parentScale { 1.f, 1.f };
+            sf::Angle parentRotation = sf::Angle::Zero;
+            if (layout.getLayoutType() != CLayout::LayoutType::Absolute &&
+                parent != entt::null && globalTransformView.contains(parent)) {
+                const auto& parentGlobalTransform = globalTransformView.get<CGlobalTransform>(parent);
+                parentPosition = parentGlobalTransform.getPosition();
+                parentScale = parentGlobalTransform.getScale();
+                parentRotation = parentGlobalTransform.getRotation();
+            }
+            const auto [parentCos, parentSin] = cosSin(parentRotation);
+            const auto rotation = parentRotation + localTransform.getRotation();
+            const auto [cos, sin] = cosSin(rotation);
+
+            const auto position = localTransform.getPosition();
+            const auto scale = localTransform.getScale();
+            const auto size = localTransform.getSize();
+            const auto anchor = layout.getAnchor().getAnchorVec();
+
+            batch.parentX[used] = parentPosition.x;
+            batch.parentY[used] = parentPosition.y;
+            batch.parentCos[used] = parentCos;
+            batch.parentSin[used] = parentSin;
+            batch.parentScaleX[used] = parentScale.x;
+            batch.parentScaleY[used] = parentScale.y;
+            batch.localX[used] = position.x;
+            batch.localY[used] = position.y;
+            batch.localScaleX[used] = scale.x;
+            batch.localScaleY[used] = scale.y;
+            batch.anchorX[used] = anchor.x;
+            batch.anchorY[used] = anchor.y;
+            batch.width[used] = size.x;
+            batch.height[used] = size.y;
+            batch.cos[used] = cos;
+            batch.sin[used] = sin;
+
+            lanes[used] = entity;
+            rotations[used] = rotation;
+            used++;
+        }
 
-    if (layout.getLayoutType() == CLayout::LayoutType::Absolute ||
-        parent.getParent() == entt::null) {
-        registry.get<CGlobalTransform>(entity).setPosition(
-            localTransform.getPosition()
-            /*+ sf::Vector2f  { anchorOffset.x * localTransform.getSize().x, anchorOffset.y * localTransform.getSize().y }*/);
-        registry.get<CGlobalTransform>(entity).setSize(localTransform.getSize());
-        registry.get<CGlobalTransform>(entity).setScale(absoluteScale);
-        return;
+        TransformUtils::compose(batch);
+
+        // scatter
+        for (size_t i = 0; i < used; i++) {
+            layoutView.get<CGlobalTransform>(lanes[i]).setComposed(
+                { batch.x[i], batch.y[i] },
+                { batch.width[i], batch.height[i] },
+                { batch.scaleX[i], batch.scaleY[i] },
+                { batch.originX[i], batch.originY[i] },
+                rotations[i],
+                { batch.a[i], batch.b[i], batch.c[i], batch.d[i], batch.tx[i], batch.ty[i] });
+        }
     }
-
-    auto parentGlobalTransform = registry.get<CGlobalTransform>(parent.getParent());
-
-    auto relativeOffset = localTransform.getPosition() /*+
-        sf::Vector2f { anchorOffset.x * localTransform.getSize().x, anchorOffset.y * localTransform.getSize().y }*/;
-
-    registry.get<CGlobalTransform>(entity).setPosition(
-        parentGlobalTransform.getPosition() + relativeOffset);
-    registry.get<CGlobalTransform>(entity).setSize(localTransform.getSize());
-
-    auto parentScale = parentGlobalTransform.getScale();
-    auto relativeScale = sf::Vector2f { absoluteScale.x * parentScale.x, absoluteScale.y * parentScale.y};
-    registry.get<CGlobalTransform>(entity).setScale(relativeScale);
+    return allFound;
 }
 
 void game::SSceneUnmountSystem::update() {
     auto& registry = game::getRegistry();
 
-    for (const auto entity : registry.view<CUnmount>()) {
-        unmount(entity);
+    auto view = registry.view<CUnmount>();
+    if (view.empty()) {
+        return;
     }
+
+    // copied out, the storage shrinks while the entities are destroyed.
+    const std::vector<entt::entity> queued { view.begin(), view.end() };
+    SceneTreeUtils::unmount(queued.data(), queued.size());
 }
 
 void game::SSceneUnmountSystem::unmount(entt::entity entity) {
@@ -334,7 +552,7 @@ void game::SSceneUnmountSystem::unmount(entt::entity entity) {
 
 void game::UnmountUtils::queueUnmount(entt::entity entity) {
     auto& registry = game::getRegistry();
-    if (registry.any_of<CUnmount>(entity)) {
+    if (registry.any_of<CUnmount, CPooled>(entity)) {
         return;
     }
     registry.emplace<CUnmount>(entity);
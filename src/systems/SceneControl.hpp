@@ -8,13 +8,11 @@
 #include <entt/entt.hpp>
 
 #include "Common.hpp"
+#include "components/SceneTree.hpp"
+#include "utils/DirtySet.hpp"
 
 
 namespace game {
-    struct CChild;
-    struct CParent;
-    struct CNode;
-
     class SceneTreeUtils {
     public:
         SceneTreeUtils() = default;
@@ -43,9 +41,46 @@ namespace game {
 
         static entt::entity markAsCleanRecurse(entt::entity entity);
 
-        static bool isDirty(entt::entity entity);
+        static bool isDirty(entt::entity entity) { return s_dirtySet.contains(entity); }
+
+        /**
+         * Everything marked as dirty since the last SScenePositionUpdateSystem::update().
+         */
+        static DirtySet& getDirtySet() { return s_dirtySet; }
+
+        [[nodiscard]] static bool isChildOf(entt::entity child, entt::entity parent);
 
+        /**
+         * Calls fn with every direct child of the entity.
+         * fn may detach or unmount the child it is given, but not its siblings.
+         */
+        template <typename Fn>
+        static void forEachChild(const entt::entity entity, Fn&& fn) {
+            auto& registry = game::getRegistry();
+            auto child = registry.get<CChild>(entity).getFirstChild();
+            while (child != entt::null) {
+                // fetched ahead, the current child may be gone after fn.
+                const auto next = registry.get<CParent>(child).getNextSibling();
+                fn(child);
+                child = next;
+            }
+        }
+
+        /**
+         * Destroys the entity and its subtree. Subtrees that belong to a PrefabPool are parked there instead.
+         */
         static void unmount(entt::entity entity);
+
+        /**
+         * Unmounts every subtree in one go: the subtrees are collected first,
+         * then destroyed with a single range destroy. Roots may be nested in each other.
+         */
+        static void unmount(const entt::entity* roots, size_t count);
+    private:
+        inline static DirtySet s_dirtySet;
+
+        static void linkChild(entt::entity parent, entt::entity child);
+        static void unlinkChild(entt::entity parent, entt::entity child);
     };
 
     class SScenePositionUpdateSystem {
@@ -61,8 +96,32 @@ namespace game {
         static void markEntityAsDirty(entt::entity entity);
 
         static void markEntityAsClean(entt::entity entity);
+
+        /**
+         * Independent dirty subtrees are computed on the thread pool when there are enough of them.
+         * Turn this off to compare against, or when the pool is busy with something else.
+         */
+        static void setParallelPropagation(bool enabled);
     private:
-        static void calculateLayout(entt::entity entity);
+        /**
+         * at least this many subtrees before they are shared out to the pool.
+         */
+        static constexpr size_t PARALLEL_MIN_SUBTREES = 64;
+        /**
+         * subtrees per batch, most are a moving entity and its small map indicator.
+         * the batches are walked level by level, so that the transforms of a level are composed together.
+         */
+        static constexpr size_t PARALLEL_BATCH_SIZE = 128;
+
+        inline static bool s_parallelPropagation = true;
+
+        struct LayoutContext;
+
+        /**
+         * Computes the global transforms of the given entities, their parents must be up-to-date already.
+         * @return false if any of the entities misses one of the layout components.
+         */
+        static bool calculateLayouts(const LayoutContext& context, const entt::entity* entities, size_t count);
     };
 
     class SSceneUnmountSystem {
@@ -5,13 +5,54 @@
 #include "ScriptsControl.hpp"
 
 #include "Common.hpp"
+#include "Logger.hpp"
 #include "components/Scripts.hpp"
+#include "components/Pool.hpp"
+#include "SFML/System/Clock.hpp"
 
 void game::SScriptsSystem::update(sf::Time deltaTime) {
-    for (auto entity : getRegistry().view<CScriptsComponent>()) {
-        auto& scripts = getRegistry().get<CScriptsComponent>(entity);
+    auto& registry = getRegistry();
+    const sf::Clock clock;
+    FrameStats stats;
 
-        scripts.invokeOnce(entity);
-        scripts.invokeUpdate(entity, deltaTime);
+    for (auto entity : registry.view<CScriptsComponent>(entt::exclude<CPooled>)) {
+        registry.get<CScriptsComponent>(entity).invokeOnce(entity);
+
+        // fetched again, the once script may have created scripts of its own.
+        auto& scripts = registry.get<CScriptsComponent>(entity);
+        scripts.m_pendingTime += deltaTime;
+
+        if (scripts.m_updateInterval > 1) {
+            const auto phase = scripts.m_phase.value_or(entt::to_entity(entity));
+            if (!scripts.m_updateRequested && (s_frame + phase) % scripts.m_updateInterval != 0) {
+                stats.skipped++;
+                continue;
+            }
+
+            if (s_frameBudget != sf::Time::Zero && clock.getElapsedTime() > s_frameBudget) {
+                scripts.m_updateRequested = true;
+                stats.deferred++;
+                continue;
+            }
+        }
+
+        scripts.m_updateRequested = false;
+        const auto elapsed = scripts.m_pendingTime;
+        scripts.m_pendingTime = sf::Time::Zero;
+
+        scripts.invokeUpdate(entity, elapsed);
+        stats.invoked++;
+    }
+
+    stats.elapsed = clock.getElapsedTime();
+    if (stats.deferred > 0) {
+        if (s_deferredTotal == 0) {
+            getLogger().logWarn("ScriptsSystem: frame budget exceeded, "
+                + std::to_string(stats.deferred) + " scripts deferred");
+        }
+        s_deferredTotal += stats.deferred;
     }
+
+    s_lastFrameStats = stats;
+    s_frame++;
 }
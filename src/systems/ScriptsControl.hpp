@@ -4,13 +4,40 @@
 
 #ifndef SCRIPTSCONTROL_HPP
 #define SCRIPTSCONTROL_HPP
+#include <cstdint>
+
 #include "SFML/System/Time.hpp"
 
 namespace game {
     class SScriptsSystem {
     public:
+        struct FrameStats {
+            uint32_t invoked { 0 };
+            // not their frame.
+            uint32_t skipped { 0 };
+            // their frame, but out of budget. they run on the next one.
+            uint32_t deferred { 0 };
+            sf::Time elapsed;
+        };
+
         SScriptsSystem() = default;
         static void update(sf::Time deltaTime);
+
+        /**
+         * Once the scripts of a frame took longer than this, the ones with an update interval are deferred.
+         * Scripts running every frame are never deferred. Zero disables the budget.
+         */
+        static void setFrameBudget(sf::Time budget) { s_frameBudget = budget; }
+        [[nodiscard]] static sf::Time getFrameBudget() { return s_frameBudget; }
+
+        [[nodiscard]] static const FrameStats& getLastFrameStats() { return s_lastFrameStats; }
+        [[nodiscard]] static uint64_t getDeferredTotal() { return s_deferredTotal; }
+
+    private:
+        inline static uint64_t s_frame { 0 };
+        inline static sf::Time s_frameBudget { sf::milliseconds(2) };
+        inline static FrameStats s_lastFrameStats {};
+        inline static uint64_t s_deferredTotal { 0 };
     };
 
 } // game
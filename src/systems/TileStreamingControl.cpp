@@ -0,0 +1,129 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TileStreamingControl.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+#include "Common.hpp"
+#include "Game.hpp"
+#include "Logger.hpp"
+#include "ThreadPool.hpp"
+#include "Window.hpp"
+#include "components/Layout.hpp"
+#include "components/TileStreaming.hpp"
+
+namespace game {
+    void STileStreamingSystem::update() {
+        auto& registry = getRegistry();
+        const auto viewCenter = getGame().getWindow().getViewCenter();
+
+        auto view = registry.view<CTileMapStreamComponent, CTiledRenderComponent, CGlobalTransform>();
+        for (auto [entity, stream, tiled, globalTransform] : view.each()) {
+            const auto& mapFile = stream.getMapFile();
+            const auto chunkRange = mapFile.getChunkRange();
+            const auto centerChunk = getCenterChunk(stream, globalTransform, viewCenter);
+
+            // the chunks that should be resident: inside the radius and the map, closest first, within the budget.
+            std::vector<sf::Vector2i> wantedChunks;
+            const auto radius = stream.getStreamRadius();
+            for (int32_t y = centerChunk.y - radius; y <= centerChunk.y + radius; y++) {
+                for (int32_t x = centerChunk.x - radius; x <= centerChunk.x + radius; x++) {
+                    if (chunkRange.contains({ x, y })) {
+                        wantedChunks.emplace_back(x, y);
+                    }
+                }
+            }
+            std::sort(wantedChunks.begin(), wantedChunks.end(), [centerChunk](sf::Vector2i lhs, sf::Vector2i rhs) {
+                return (lhs - centerChunk).lengthSquared() < (rhs - centerChunk).lengthSquared();
+            });
+            if (wantedChunks.size() > stream.getResidencyBudget()) {
+                wantedChunks.resize(stream.getResidencyBudget());
+            }
+
+            std::unordered_set<uint64_t> wantedKeys;
+            wantedKeys.reserve(wantedChunks.size());
+            for (auto chunkCoord : wantedChunks) {
+                wantedKeys.insert(CTiledRenderComponent::getChunkKey(chunkCoord));
+            }
+
+            // install what the workers have finished, unless the view has moved away in the meantime.
+            std::vector<CTileMapStreamComponent::DecodedChunk> decodedChunks;
+            {
+                std::scoped_lock lock(stream.m_queue->mutex);
+                decodedChunks.swap(stream.m_queue->chunks);
+            }
+            for (auto& decoded : decodedChunks) {
+                const auto key = CTiledRenderComponent::getChunkKey(decoded.chunkCoord);
+                stream.m_pendingChunks.erase(key);
+                if (!decoded.isValid) {
+                    // left as a hole, the rest of the map still streams.
+                    stream.m_failedChunks.insert(key);
+                    getLogger().logError("Tile map chunk (" + std::to_string(decoded.chunkCoord.x) + ", "
+                        + std::to_string(decoded.chunkCoord.y) + ") refers to tiles missing from the palette");
+                    continue;
+                }
+                if (wantedKeys.count(key) != 0) {
+                    tiled.loadChunk(decoded.chunkCoord, std::move(decoded.tileItems));
+                }
+            }
+
+            // evict first, so that the residency never goes beyond the budget.
+            std::vector<sf::Vector2i> evictedChunks;
+            tiled.forEachChunk([&wantedKeys, &evictedChunks](sf::Vector2i chunkCoord) {
+                if (wantedKeys.count(CTiledRenderComponent::getChunkKey(chunkCoord)) == 0) {
+                    evictedChunks.push_back(chunkCoord);
+                }
+            });
+            for (auto chunkCoord : evictedChunks) {
+                tiled.unloadChunk(chunkCoord);
+            }
+
+            for (auto chunkCoord : wantedChunks) {
+                const auto key = CTiledRenderComponent::getChunkKey(chunkCoord);
+                if (!tiled.hasChunk(chunkCoord)
+                    && stream.m_pendingChunks.count(key) == 0
+                    && stream.m_failedChunks.count(key) == 0) {
+                    requestChunk(stream, chunkCoord);
+                }
+            }
+        }
+    }
+
+    sf::Vector2i STileStreamingSystem::getCenterChunk(const CTileMapStreamComponent& stream,
+                                                       const CGlobalTransform& globalTransform, sf::Vector2f viewCenter) {
+        // inverse of the transform the tiles are drawn with, see CTiledRenderComponent::update().
+        const auto local = globalTransform.getTransform().getInverse().transformPoint(viewCenter);
+
+        // tiles are centered on their placement.
+        const auto tileSize = sf::Vector2f(stream.getMapFile().getTileSize());
+        const sf::Vector2i tile {
+            static_cast<int32_t>(std::floor(local.x / tileSize.x + 0.5f)),
+            static_cast<int32_t>(std::floor(local.y / tileSize.y + 0.5f))
+        };
+        return CTiledRenderComponent::getChunkCoord(tile);
+    }
+
+    void STileStreamingSystem::requestChunk(CTileMapStreamComponent& stream, sf::Vector2i chunkCoord) {
+        stream.m_pendingChunks.insert(CTiledRenderComponent::getChunkKey(chunkCoord));
+
+        auto decode = [mapFile = stream.m_mapFile, queue = stream.m_queue, chunkCoord]() {
+            CTileMapStreamComponent::DecodedChunk decoded { chunkCoord, {} };
+            decoded.isValid = mapFile->decodeChunk(chunkCoord, decoded.tileItems);
+
+            std::scoped_lock lock(queue->mutex);
+            queue->chunks.push_back(std::move(decoded));
+        };
+
+        auto& threadPool = getThreadPool();
+        if (threadPool.getThreadCount() == 0) {
+            // nobody to hand it over to, it is picked up next frame all the same.
+            decode();
+            return;
+        }
+        threadPool.schedule(decode);
+    }
+} // game
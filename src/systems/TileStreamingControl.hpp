@@ -0,0 +1,25 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TILESTREAMINGCONTROL_HPP
+#define TILESTREAMINGCONTROL_HPP
+
+#include "SFML/System/Vector2.hpp"
+
+namespace game {
+    struct CTileMapStreamComponent;
+    struct CTiledRenderComponent;
+    struct CGlobalTransform;
+
+    class STileStreamingSystem {
+    public:
+        static void update();
+    private:
+        static sf::Vector2i getCenterChunk(const CTileMapStreamComponent& stream, const CGlobalTransform& globalTransform,
+                                           sf::Vector2f viewCenter);
+        static void requestChunk(CTileMapStreamComponent& stream, sf::Vector2i chunkCoord);
+    };
+} // game
+
+#endif //TILESTREAMINGCONTROL_HPP
@@ -5,11 +5,8 @@
 #include "TweeningControl.hpp"
 
 #include "Common.hpp"
-#include "components/Tweening.hpp"
+#include "utils/TweenEngine.hpp"
 
 void game::STweenSystem::update(sf::Time deltaTime) {
-    auto& registry = game::getRegistry();
-    for (auto [entity, tweening] : registry.view<game::CTweenComponent>().each()) {
-        tweening.update(entity, deltaTime);
-    }
+    getTweenEngine().update(deltaTime);
 }
@@ -0,0 +1,83 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef ARCHETYPE_HPP
+#define ARCHETYPE_HPP
+
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Common.hpp"
+#include "components/SceneTree.hpp"
+#include "systems/SceneControl.hpp"
+
+namespace game {
+    /**
+     * The component set of a prefab, together with the default value of every component.
+     * All the components must be copyable. The ones which are not (CShapeRenderComponent, ...)
+     * and the per-entity values are left to the init function of spawnBatch().
+     *
+     * Remember that an entity in the scene tree needs CNode, CParent and CChild, spawnBatch() marks it as dirty,
+     * and one with a layout CHasLayout, CLayout, CLocalTransform and CGlobalTransform.
+     */
+    template <typename... Components>
+    class Archetype {
+    public:
+        explicit Archetype(Components... defaults) : m_defaults(std::move(defaults)...) {}
+
+        [[nodiscard]] const std::tuple<Components...>& getDefaults() const { return m_defaults; }
+
+        template <typename Component>
+        [[nodiscard]] const Component& getDefault() const { return std::get<Component>(m_defaults); }
+
+        template <typename Component>
+        void setDefault(Component component) { std::get<Component>(m_defaults) = std::move(component); }
+
+    private:
+        std::tuple<Components...> m_defaults;
+    };
+
+    /**
+     * Creates count entities of the archetype.
+     * Every storage grows once for the whole batch and is filled with a single range insert.
+     * @param init called with (entity, index) for every entity afterwards, in creation order
+     * @return the entities, in creation order
+     */
+    template <typename... Components, typename InitFn>
+    std::vector<entt::entity> spawnBatch(const Archetype<Components...>& archetype, const size_t count, InitFn&& init) {
+        auto& registry = getRegistry();
+
+        std::vector<entt::entity> entities(count);
+        if (count == 0) {
+            return entities;
+        }
+        registry.create(entities.begin(), entities.end());
+
+        std::apply([&registry, &entities, count](const Components&... defaults) {
+            (registry.storage<Components>().reserve(registry.storage<Components>().size() + count), ...);
+            (registry.insert<Components>(entities.begin(), entities.end(), defaults), ...);
+        }, archetype.getDefaults());
+
+        if constexpr ((std::is_same_v<Components, CNode> || ...)) {
+            // fresh entities, nothing below them yet.
+            auto& dirtySet = SceneTreeUtils::getDirtySet();
+            for (const auto entity : entities) {
+                dirtySet.insert(entity);
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            init(entities[i], i);
+        }
+        return entities;
+    }
+
+    template <typename... Components>
+    std::vector<entt::entity> spawnBatch(const Archetype<Components...>& archetype, const size_t count) {
+        return spawnBatch(archetype, count, [](entt::entity, size_t) {});
+    }
+} // game
+
+#endif //ARCHETYPE_HPP
@@ -0,0 +1,115 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef DIRTYSET_HPP
+#define DIRTYSET_HPP
+
+#include <cstdint>
+#include <vector>
+#include <entt/entity/entity.hpp>
+
+namespace game {
+    /**
+     * The entities whose global transform has to be recomputed.
+     * A dense array indexed by the entity index tells in O(1) whether an entity is dirty,
+     * and a list of the dirty entities is kept next to it, so the whole set is walked without a scan.
+     *
+     * The array holds the full identifier instead of a single bit,
+     * so that a recycled index is not taken for its dirty predecessor.
+     */
+    class DirtySet {
+    public:
+        DirtySet() = default;
+
+        /**
+         * @return false if the entity was already dirty
+         */
+        bool insert(const entt::entity entity) {
+            const auto index = static_cast<size_t>(entt::to_entity(entity));
+            if (index >= m_slots.size()) {
+                m_slots.resize(index + 1);
+            }
+
+            auto& slot = m_slots[index];
+            if (slot.entity == entity) {
+                return false;
+            }
+            if (slot.entity != entt::null) {
+                // a destroyed predecessor which was still dirty, it takes its place in the list.
+                m_entities[slot.position] = entity;
+                slot.entity = entity;
+                return true;
+            }
+
+            slot.entity = entity;
+            slot.position = static_cast<uint32_t>(m_entities.size());
+            m_entities.push_back(entity);
+            return true;
+        }
+
+        /**
+         * @return false if the entity was not dirty
+         */
+        bool erase(const entt::entity entity) {
+            if (!contains(entity)) {
+                return false;
+            }
+
+            auto& slot = m_slots[static_cast<size_t>(entt::to_entity(entity))];
+            const auto last = m_entities.back();
+            m_entities[slot.position] = last;
+            m_slots[static_cast<size_t>(entt::to_entity(last))].position = slot.position;
+            m_entities.pop_back();
+
+            slot.entity = entt::null;
+            return true;
+        }
+
+        [[nodiscard]] bool contains(const entt::entity entity) const {
+            const auto index = static_cast<size_t>(entt::to_entity(entity));
+            return index < m_slots.size() && m_slots[index].entity == entity;
+        }
+
+        /**
+         * Drops the entities fn returns false for, e.g. the ones destroyed while they were dirty.
+         */
+        template <typename Fn>
+        void retain(Fn&& fn) {
+            size_t kept = 0;
+            for (const auto entity : m_entities) {
+                auto& slot = m_slots[static_cast<size_t>(entt::to_entity(entity))];
+                if (fn(entity)) {
+                    slot.position = static_cast<uint32_t>(kept);
+                    m_entities[kept++] = entity;
+                } else {
+                    slot.entity = entt::null;
+                }
+            }
+            m_entities.resize(kept);
+        }
+
+        [[nodiscard]] const std::vector<entt::entity>& getEntities() const { return m_entities; }
+        [[nodiscard]] size_t size() const { return m_entities.size(); }
+        [[nodiscard]] bool empty() const { return m_entities.empty(); }
+
+        void clear() {
+            for (const auto entity : m_entities) {
+                m_slots[static_cast<size_t>(entt::to_entity(entity))].entity = entt::null;
+            }
+            m_entities.clear();
+        }
+
+    private:
+        struct Slot {
+            entt::entity entity { entt::null };
+            // in m_entities.
+            uint32_t position { 0 };
+        };
+
+        std::vector<Slot> m_slots;
+        std::vector<entt::entity> m_entities;
+    };
+} // game
+
+#endif //DIRTYSET_HPP
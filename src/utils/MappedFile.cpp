@@ -0,0 +1,83 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace game {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::string& path) {
+        m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_fileHandle == INVALID_HANDLE_VALUE) {
+            m_fileHandle = nullptr;
+            throw std::runtime_error("MappedFile: failed to open " + path);
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(m_fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(m_fileHandle);
+            throw std::runtime_error("MappedFile: empty or unreadable file " + path);
+        }
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+
+        m_mappingHandle = CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mappingHandle == nullptr) {
+            CloseHandle(m_fileHandle);
+            throw std::runtime_error("MappedFile: failed to create mapping for " + path);
+        }
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr) {
+            CloseHandle(m_mappingHandle);
+            CloseHandle(m_fileHandle);
+            throw std::runtime_error("MappedFile: failed to map " + path);
+        }
+    }
+
+    MappedFile::~MappedFile() {
+        UnmapViewOfFile(m_data);
+        CloseHandle(m_mappingHandle);
+        CloseHandle(m_fileHandle);
+    }
+#else
+    MappedFile::MappedFile(const std::string& path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("MappedFile: failed to open " + path);
+        }
+
+        struct stat fileStat {};
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("MappedFile: empty or unreadable file " + path);
+        }
+        m_size = static_cast<size_t>(fileStat.st_size);
+
+        void* mapping = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // the mapping keeps its own reference to the file.
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("MappedFile: failed to map " + path);
+        }
+        m_data = static_cast<const uint8_t*>(mapping);
+    }
+
+    MappedFile::~MappedFile() {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+} // game
@@ -0,0 +1,38 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace game {
+    /**
+     * Read-only memory mapping of a whole file.
+     * The pages are only read in from disk when they are touched, and the os may drop them again at any time,
+     * so a large file costs address space, not memory.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const uint8_t* data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+    private:
+        const uint8_t* m_data { nullptr };
+        size_t m_size { 0 };
+#ifdef _WIN32
+        void* m_fileHandle { nullptr };
+        void* m_mappingHandle { nullptr };
+#endif
+    };
+} // game
+
+#endif //MAPPEDFILE_HPP
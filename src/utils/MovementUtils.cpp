@@ -23,6 +23,27 @@ namespace game {
         registry.get<CGlobalTransform>(entity).setPosition(m_globalPos);
     }
 
+    CLayout MovementUtils::Builder::buildLayout() const {
+        CLayout layout;
+        layout.setAnchor(m_anchor);
+        layout.setLayoutType(m_layoutType);
+        return layout;
+    }
+
+    CLocalTransform MovementUtils::Builder::buildLocalTransform() const {
+        CLocalTransform localTransform;
+        localTransform.setSize(m_size);
+        localTransform.setPosition(m_localPos);
+        localTransform.setScale(m_scale);
+        return localTransform;
+    }
+
+    CGlobalTransform MovementUtils::Builder::buildGlobalTransform() const {
+        CGlobalTransform globalTransform;
+        globalTransform.setPosition(m_globalPos);
+        return globalTransform;
+    }
+
     entt::entity game::MovementUtils::attachLayoutComponents(entt::entity entity) {
         auto& registry = game::getRegistry();
 
@@ -54,6 +54,14 @@ namespace game {
 
             void build(const entt::entity& entity) const;
 
+            /**
+             * The components build() would set up, used as defaults of prefab archetypes.
+             * @see Archetype
+             */
+            [[nodiscard]] CLayout buildLayout() const;
+            [[nodiscard]] CLocalTransform buildLocalTransform() const;
+            [[nodiscard]] CGlobalTransform buildGlobalTransform() const;
+
         private:
             sf::Vector2f m_size, m_localPos, m_globalPos, m_scale;
             CLayout::Anchor m_anchor{CLayout::Anchor::TopLeft()};
@@ -0,0 +1,111 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "PassProfiler.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "SFML/OpenGL.hpp"
+
+namespace game {
+    void PassProfiler::beginFrame() {
+        if (!m_enabled) {
+            return;
+        }
+        glFinish();
+        m_frameClock.restart();
+    }
+
+    void PassProfiler::endFrame() {
+        if (!m_enabled) {
+            return;
+        }
+        const auto submit = m_frameClock.getElapsedTime();
+        glFinish();
+        m_samples.push_back({ m_frame, "frame", submit, m_frameClock.getElapsedTime() });
+        m_frame++;
+    }
+
+    void PassProfiler::beginPass(const char* name) {
+        if (!m_enabled) {
+            return;
+        }
+        if (m_currentPass != nullptr) {
+            getLogger().logWarn("PassProfiler: pass " + std::string(m_currentPass) + " was not ended.");
+        }
+        // whatever was queued before does not belong to this pass.
+        glFinish();
+        m_currentPass = name;
+        m_passClock.restart();
+    }
+
+    void PassProfiler::endPass() {
+        if (!m_enabled || m_currentPass == nullptr) {
+            return;
+        }
+        const auto submit = m_passClock.getElapsedTime();
+        glFinish();
+        m_samples.push_back({ m_frame, m_currentPass, submit, m_passClock.getElapsedTime() });
+        m_currentPass = nullptr;
+    }
+
+    bool PassProfiler::writeCsv(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << "frame,pass,submit_us,complete_us\n";
+        for (const auto& sample : m_samples) {
+            file << sample.frame << ',' << sample.pass << ','
+                 << sample.submit.asMicroseconds() << ',' << sample.complete.asMicroseconds() << '\n';
+        }
+        return file.good();
+    }
+
+    void PassProfiler::logSummary() const {
+        struct Total {
+            const char* pass;
+            int64_t submit;
+            int64_t complete;
+            uint32_t count;
+        };
+
+        // passes come in the same order every frame, a linear search is all it needs.
+        std::vector<Total> totals;
+        for (const auto& sample : m_samples) {
+            auto it = totals.begin();
+            for (; it != totals.end(); ++it) {
+                if (std::strcmp(it->pass, sample.pass) == 0) {
+                    break;
+                }
+            }
+            if (it == totals.end()) {
+                totals.push_back({ sample.pass, 0, 0, 0 });
+                it = totals.end() - 1;
+            }
+            it->submit += sample.submit.asMicroseconds();
+            it->complete += sample.complete.asMicroseconds();
+            it->count++;
+        }
+
+        for (const auto& total : totals) {
+            std::stringstream ss;
+            ss << "Pass " << total.pass << ": "
+               << total.submit / total.count << " us submit, "
+               << total.complete / total.count << " us complete, over " << total.count << " frames";
+            getLogger().logInfo(ss.str());
+        }
+    }
+
+    void PassProfiler::clear() {
+        m_samples.clear();
+        m_currentPass = nullptr;
+        m_frame = 0;
+    }
+} // game
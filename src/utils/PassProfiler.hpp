@@ -0,0 +1,69 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef PASSPROFILER_HPP
+#define PASSPROFILER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SFML/System/Clock.hpp"
+#include "SFML/System/Time.hpp"
+
+namespace game {
+    /**
+     * Records how long each pass of the render pipeline takes.
+     * Two times are taken per pass: submit, when the draw calls have been issued,
+     * and complete, after glFinish() has returned, which includes the gpu work of the pass.
+     * Waiting for the gpu stalls the pipeline, so this is only meant for captures, it does nothing when disabled.
+     */
+    class PassProfiler {
+    public:
+        PassProfiler() = default;
+        explicit PassProfiler(bool enabled) : m_enabled(enabled) {}
+
+        void setEnabled(bool enabled) { m_enabled = enabled; }
+        [[nodiscard]] bool isEnabled() const { return m_enabled; }
+
+        void beginFrame();
+        void endFrame();
+
+        /**
+         * @param name should be a string literal, only the pointer is kept
+         */
+        void beginPass(const char* name);
+        void endPass();
+
+        /**
+         * Writes one row per pass and frame: frame,pass,submit_us,complete_us.
+         * @return false if the file could not be written
+         */
+        [[nodiscard]] bool writeCsv(const std::string& path) const;
+
+        /**
+         * Logs the average times of every pass.
+         */
+        void logSummary() const;
+
+        void clear();
+
+    private:
+        struct Sample {
+            uint32_t frame;
+            const char* pass;
+            sf::Time submit;
+            sf::Time complete;
+        };
+
+        bool m_enabled { false };
+        uint32_t m_frame { 0 };
+        const char* m_currentPass { nullptr };
+        sf::Clock m_passClock;
+        sf::Clock m_frameClock;
+        std::vector<Sample> m_samples;
+    };
+} // game
+
+#endif //PASSPROFILER_HPP
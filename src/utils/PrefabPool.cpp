@@ -0,0 +1,121 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "PrefabPool.hpp"
+
+#include <algorithm>
+
+#include "Common.hpp"
+#include "components/Pool.hpp"
+#include "components/Scripts.hpp"
+#include "components/SceneTree.hpp"
+#include "systems/SceneControl.hpp"
+
+namespace game {
+    void PrefabPool::warmUp() {
+        m_warmedUp = true;
+        m_free.reserve(m_highWaterMark);
+
+        const auto target = std::min(m_warmUpSize, m_highWaterMark);
+        if (m_free.size() >= target) {
+            return;
+        }
+
+        // built in one batch, so that the storages only grow once.
+        for (const auto root : m_factory(target - m_free.size())) {
+            adopt(root);
+            deactivate(root);
+            m_free.push_back(root);
+        }
+    }
+
+    entt::entity PrefabPool::acquire() {
+        if (!m_warmedUp) {
+            warmUp();
+        }
+
+        if (m_free.empty()) {
+            const auto root = m_factory(1).front();
+            adopt(root);
+            return root;
+        }
+
+        const auto root = m_free.back();
+        m_free.pop_back();
+        activate(root);
+        return root;
+    }
+
+    void PrefabPool::release(const entt::entity root) {
+        auto& registry = getRegistry();
+        if (!registry.valid(root) || registry.any_of<CPooled>(root)) {
+            return;
+        }
+
+        if (m_free.size() >= m_highWaterMark) {
+            // unmount() would hand it back here again.
+            registry.remove<CPoolable>(root);
+            SceneTreeUtils::unmount(root);
+            return;
+        }
+
+        const auto parent = registry.get<CParent>(root).getParent();
+        if (parent != entt::null) {
+            SceneTreeUtils::detachChild(parent, root);
+        }
+        deactivate(root);
+        m_free.push_back(root);
+    }
+
+    void PrefabPool::clear() {
+        auto& registry = getRegistry();
+        for (const auto root : m_free) {
+            if (registry.valid(root)) {
+                registry.remove<CPoolable>(root);
+                SceneTreeUtils::unmount(root);
+            }
+        }
+        m_free.clear();
+    }
+
+    void PrefabPool::setHighWaterMark(const size_t highWaterMark) {
+        m_highWaterMark = highWaterMark;
+
+        auto& registry = getRegistry();
+        while (m_free.size() > m_highWaterMark) {
+            const auto root = m_free.back();
+            m_free.pop_back();
+            registry.remove<CPoolable>(root);
+            SceneTreeUtils::unmount(root);
+        }
+    }
+
+    void PrefabPool::adopt(const entt::entity root) {
+        getRegistry().emplace_or_replace<CPoolable>(root, this);
+    }
+
+    void PrefabPool::deactivate(const entt::entity entity) {
+        auto& registry = getRegistry();
+        registry.emplace_or_replace<CPooled>(entity);
+        // a queued unmount would otherwise release it again next frame.
+        registry.remove<CUnmount>(entity);
+
+        SceneTreeUtils::forEachChild(entity, [](const entt::entity child) {
+            deactivate(child);
+        });
+    }
+
+    void PrefabPool::activate(const entt::entity entity) {
+        auto& registry = getRegistry();
+        registry.remove<CPooled>(entity);
+        // the scheduling of the previous life must not leak into this one.
+        if (auto* scripts = registry.try_get<CScriptsComponent>(entity)) {
+            scripts->resetSchedule();
+        }
+
+        SceneTreeUtils::forEachChild(entity, [](const entt::entity child) {
+            activate(child);
+        });
+    }
+} // game
@@ -0,0 +1,78 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef PREFABPOOL_HPP
+#define PREFABPOOL_HPP
+
+#include <functional>
+#include <vector>
+#include <entt/entity/entity.hpp>
+
+namespace game {
+    /**
+     * Keeps built subtrees of a prefab around, so that spawning one does not have to
+     * create the entities, emplace every component and allocate the shapes again.
+     *
+     * Parked subtrees are detached from the scene tree and tagged with CPooled, which the systems skip.
+     * The script scheduling is reset on acquire(), only the mutable state of the prefab itself
+     * (position, velocity, ...) needs to be reset by the caller.
+     * Entities keep their identifier while parked, so do not hold on to them after they have been unmounted.
+     */
+    class PrefabPool {
+    public:
+        /**
+         * builds count complete subtrees and returns their roots, which are not attached to anything.
+         */
+        using Factory = std::function<std::vector<entt::entity>(size_t count)>;
+
+        PrefabPool(Factory factory, size_t warmUpSize, size_t highWaterMark)
+            : m_factory(std::move(factory)), m_warmUpSize(warmUpSize), m_highWaterMark(highWaterMark) {}
+
+        PrefabPool(const PrefabPool&) = delete;
+        PrefabPool& operator=(const PrefabPool&) = delete;
+
+        /**
+         * Builds subtrees until the warm-up size is parked. Happens on the first acquire() otherwise.
+         */
+        void warmUp();
+
+        /**
+         * @return the root of an active subtree, detached from the scene tree
+         */
+        [[nodiscard]] entt::entity acquire();
+
+        /**
+         * Parks the subtree, or destroys it if the pool already holds the high-water mark.
+         * SceneTreeUtils::unmount() calls this for roots with CPoolable.
+         */
+        void release(entt::entity root);
+
+        /**
+         * Destroys every parked subtree.
+         */
+        void clear();
+
+        void setWarmUpSize(size_t warmUpSize) { m_warmUpSize = warmUpSize; }
+        [[nodiscard]] size_t getWarmUpSize() const { return m_warmUpSize; }
+
+        void setHighWaterMark(size_t highWaterMark);
+        [[nodiscard]] size_t getHighWaterMark() const { return m_highWaterMark; }
+
+        [[nodiscard]] size_t getFreeCount() const { return m_free.size(); }
+
+    private:
+        Factory m_factory;
+        size_t m_warmUpSize;
+        size_t m_highWaterMark;
+        bool m_warmedUp { false };
+        std::vector<entt::entity> m_free;
+
+        void adopt(entt::entity root);
+
+        static void deactivate(entt::entity entity);
+        static void activate(entt::entity entity);
+    };
+} // game
+
+#endif //PREFABPOOL_HPP
@@ -0,0 +1,20 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TextUtils.hpp"
+
+namespace game {
+    void TextUtils::prebakeGlyphs(const sf::Font& font, const sf::String& characters, unsigned int characterSize, bool isBold) {
+        // sf::Font caches every glyph it has rendered, so looking them up once is enough.
+        for (size_t i = 0; i < characters.getSize(); i++) {
+            (void) font.getGlyph(characters[i], characterSize, isBold);
+        }
+    }
+
+    void TextUtils::prebakeAscii(const sf::Font& font, unsigned int characterSize, bool isBold) {
+        for (char32_t character = U' '; character <= U'~'; character++) {
+            (void) font.getGlyph(character, characterSize, isBold);
+        }
+    }
+} // game
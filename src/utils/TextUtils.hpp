@@ -0,0 +1,32 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TEXTUTILS_HPP
+#define TEXTUTILS_HPP
+
+#include "SFML/Graphics/Font.hpp"
+#include "SFML/System/String.hpp"
+
+namespace game {
+    class TextUtils {
+    public:
+        /**
+         * Rasterizes the glyphs of the given characters into the font's glyph atlas ahead of time.
+         * Otherwise this happens the first time a character shows up, e.g. in the middle of a dialog line,
+         * and the atlas page may need to grow right then.
+         * @param font the font whose atlas is filled
+         * @param characters characters to rasterize, duplicates are fine
+         * @param characterSize the atlas is per character size
+         * @param isBold bold glyphs are rasterized separately
+         */
+        static void prebakeGlyphs(const sf::Font& font, const sf::String& characters, unsigned int characterSize, bool isBold = false);
+
+        /**
+         * Printable ASCII, for the texts that are not known ahead of time, like the numbers on the overlays.
+         */
+        static void prebakeAscii(const sf::Font& font, unsigned int characterSize, bool isBold = false);
+    };
+} // game
+
+#endif //TEXTUTILS_HPP
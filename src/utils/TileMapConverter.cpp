@@ -0,0 +1,76 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#include "TileMapConverter.hpp"
+
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "TileMapFile.hpp"
+
+namespace game {
+    size_t TileMapConverter::convert(const sf::Image& image, const std::string& texturePath, const sf::Vector2u tileSize,
+                                     const std::string& outputPath) {
+        const auto imageSize = image.getSize();
+        if (tileSize.x == 0 || tileSize.y == 0 || imageSize.x % tileSize.x != 0 || imageSize.y % tileSize.y != 0) {
+            throw std::runtime_error("TileMapConverter: the image size is not a multiple of the tile size: " + texturePath);
+        }
+
+        const sf::Vector2i tiles { static_cast<int32_t>(imageSize.x / tileSize.x), static_cast<int32_t>(imageSize.y / tileSize.y) };
+        const auto* pixels = image.getPixelsPtr();
+        const size_t rowBytes = static_cast<size_t>(tileSize.x) * 4;
+
+        std::vector<TileMapFile::PaletteEntry> palette;
+        // the pixels of a tile, as bytes, to its id.
+        std::unordered_map<std::string, TileIdType> tileIdsByPixels;
+        std::vector<TileIdType> tileIds(static_cast<size_t>(tiles.x) * tiles.y, TileMapFile::EMPTY_TILE);
+
+        std::string tilePixels;
+        tilePixels.resize(rowBytes * tileSize.y);
+        for (int32_t tileY = 0; tileY < tiles.y; tileY++) {
+            for (int32_t tileX = 0; tileX < tiles.x; tileX++) {
+                bool isTransparent = true;
+                for (uint32_t y = 0; y < tileSize.y; y++) {
+                    const size_t pixelY = static_cast<size_t>(tileY) * tileSize.y + y;
+                    const auto* row = pixels + (pixelY * imageSize.x + static_cast<size_t>(tileX) * tileSize.x) * 4;
+                    tilePixels.replace(y * rowBytes, rowBytes, reinterpret_cast<const char*>(row), rowBytes);
+                    for (size_t x = 3; x < rowBytes && isTransparent; x += 4) {
+                        isTransparent = row[x] == 0;
+                    }
+                }
+                if (isTransparent) {
+                    continue;
+                }
+
+                auto [it, isNew] = tileIdsByPixels.try_emplace(tilePixels, static_cast<TileIdType>(palette.size() + 1));
+                if (isNew) {
+                    TileMapFile::Frame frame;
+                    frame.texturePath = texturePath;
+                    frame.textureRect = sf::IntRect {
+                        { tileX * static_cast<int32_t>(tileSize.x), tileY * static_cast<int32_t>(tileSize.y) },
+                        sf::Vector2i(tileSize)
+                    };
+                    palette.push_back({ it->second, { frame } });
+                }
+                tileIds[static_cast<size_t>(tileY) * tiles.x + tileX] = it->second;
+            }
+        }
+
+        const sf::IntRect tileRange { -tiles / 2, tiles };
+        TileMapFile::write(outputPath, tileSize, palette, tileRange, [&tileIds, &tileRange](const sf::Vector2i tilePlacement) {
+            const auto local = tilePlacement - tileRange.position;
+            return tileIds[static_cast<size_t>(local.y) * tileRange.size.x + local.x];
+        });
+        return palette.size();
+    }
+
+    size_t TileMapConverter::convert(const std::string& imagePath, const sf::Vector2u tileSize, const std::string& outputPath) {
+        sf::Image image;
+        if (!image.loadFromFile(imagePath)) {
+            throw std::runtime_error("TileMapConverter: failed to load " + imagePath);
+        }
+        return convert(image, imagePath, tileSize, outputPath);
+    }
+} // game
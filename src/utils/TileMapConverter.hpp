@@ -0,0 +1,34 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TILEMAPCONVERTER_HPP
+#define TILEMAPCONVERTER_HPP
+
+#include <string>
+
+#include "SFML/Graphics/Image.hpp"
+#include "SFML/System/Vector2.hpp"
+
+namespace game {
+    /**
+     * Turns a map painted as one large image (like the SimpleMapLayer layers) into a TileMapFile.
+     *
+     * The image is cut into tiles of the given size, identical tiles share a single palette entry
+     * and fully transparent ones are left empty. The palette entries point into the source image,
+     * so it is still needed at runtime, but only the tiles around the view are ever built.
+     * The map is centered on the origin, the same as SimpleMapLayer.
+     */
+    class TileMapConverter {
+    public:
+        /**
+         * @param texturePath stored in the palette, the path the game loads the image from
+         * @return the number of distinct tiles
+         */
+        static size_t convert(const sf::Image& image, const std::string& texturePath, sf::Vector2u tileSize,
+                              const std::string& outputPath);
+        static size_t convert(const std::string& imagePath, sf::Vector2u tileSize, const std::string& outputPath);
+    };
+} // game
+
+#endif //TILEMAPCONVERTER_HPP
@@ -0,0 +1,289 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TileMapFile.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr char c_magic[4] = { 'G', 'T', 'M', 'P' };
+    constexpr size_t c_chunkTiles = static_cast<size_t>(game::CTiledRenderComponent::CHUNK_SIZE) * game::CTiledRenderComponent::CHUNK_SIZE;
+    // tile id, frame count and a single frame with an empty path.
+    constexpr size_t c_minPaletteEntrySize = 2 * sizeof(uint32_t) + sizeof(uint16_t) + 4 * sizeof(int32_t) + sizeof(uint32_t);
+
+    // the format is little-endian, as are all the platforms the game runs on,
+    // so the values are copied as they are.
+    class Reader {
+    public:
+        Reader(const uint8_t* data, size_t size) : m_data(data), m_size(size) {}
+
+        template <typename T>
+        T read() {
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        std::string readString(size_t length) {
+            const auto* bytes = take(length);
+            return { reinterpret_cast<const char*>(bytes), length };
+        }
+
+        [[nodiscard]] size_t remaining() const { return m_size - m_offset; }
+
+        const uint8_t* take(size_t length) {
+            if (length > m_size - m_offset) {
+                throw std::runtime_error("TileMapFile: unexpected end of file");
+            }
+            const auto* bytes = m_data + m_offset;
+            m_offset += length;
+            return bytes;
+        }
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset { 0 };
+    };
+
+    class Writer {
+    public:
+        explicit Writer(std::ofstream& stream) : m_stream(stream) {}
+
+        template <typename T>
+        void write(T value) {
+            m_stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        void writeBytes(const void* data, size_t size) {
+            m_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        }
+    private:
+        std::ofstream& m_stream;
+    };
+
+    int32_t floorDiv(int32_t value, int32_t divisor) {
+        return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+    }
+}
+
+namespace game {
+    TileMapFile::TileMapFile(const std::string& path) : m_file(path) {
+        Reader reader(m_file.data(), m_file.size());
+
+        if (std::memcmp(reader.take(sizeof(c_magic)), c_magic, sizeof(c_magic)) != 0) {
+            throw std::runtime_error("TileMapFile: not a tile map: " + path);
+        }
+        if (reader.read<uint32_t>() != VERSION) {
+            throw std::runtime_error("TileMapFile: unsupported version: " + path);
+        }
+        if (reader.read<uint32_t>() != static_cast<uint32_t>(CTiledRenderComponent::CHUNK_SIZE)) {
+            throw std::runtime_error("TileMapFile: chunk size mismatch: " + path);
+        }
+
+        m_tileSize.x = reader.read<uint32_t>();
+        m_tileSize.y = reader.read<uint32_t>();
+        m_chunkRange.position.x = reader.read<int32_t>();
+        m_chunkRange.position.y = reader.read<int32_t>();
+        const auto chunksX = reader.read<uint32_t>();
+        const auto chunksY = reader.read<uint32_t>();
+        if (chunksX > MAX_CHUNKS_PER_AXIS || chunksY > MAX_CHUNKS_PER_AXIS) {
+            throw std::runtime_error("TileMapFile: too many chunks: " + path);
+        }
+        // the last chunk's first tile has to be representable as well.
+        constexpr int64_t maxTile = std::numeric_limits<int32_t>::max();
+        constexpr int64_t minTile = std::numeric_limits<int32_t>::min();
+        const int64_t firstTileX = static_cast<int64_t>(m_chunkRange.position.x) * CTiledRenderComponent::CHUNK_SIZE;
+        const int64_t firstTileY = static_cast<int64_t>(m_chunkRange.position.y) * CTiledRenderComponent::CHUNK_SIZE;
+        const int64_t lastTileX = (static_cast<int64_t>(m_chunkRange.position.x) + chunksX) * CTiledRenderComponent::CHUNK_SIZE;
+        const int64_t lastTileY = (static_cast<int64_t>(m_chunkRange.position.y) + chunksY) * CTiledRenderComponent::CHUNK_SIZE;
+        if (firstTileX < minTile || firstTileY < minTile || lastTileX > maxTile || lastTileY > maxTile) {
+            throw std::runtime_error("TileMapFile: chunk range out of bounds: " + path);
+        }
+        m_chunkRange.size.x = static_cast<int32_t>(chunksX);
+        m_chunkRange.size.y = static_cast<int32_t>(chunksY);
+
+        const auto paletteSize = reader.read<uint32_t>();
+        // checked before reserving, a corrupt count would otherwise allocate whatever it says.
+        if (paletteSize > reader.remaining() / c_minPaletteEntrySize) {
+            throw std::runtime_error("TileMapFile: palette out of bounds: " + path);
+        }
+        m_palette.reserve(paletteSize);
+        for (uint32_t i = 0; i < paletteSize; i++) {
+            PaletteEntry entry;
+            entry.tileId = reader.read<uint32_t>();
+            if (entry.tileId == EMPTY_TILE) {
+                throw std::runtime_error("TileMapFile: palette entry for the empty tile: " + path);
+            }
+            const auto frameCount = reader.read<uint32_t>();
+            if (frameCount == 0) {
+                throw std::runtime_error("TileMapFile: palette entry without frames: " + path);
+            }
+            for (uint32_t j = 0; j < frameCount; j++) {
+                Frame frame;
+                frame.texturePath = reader.readString(reader.read<uint16_t>());
+                frame.textureRect.position.x = reader.read<int32_t>();
+                frame.textureRect.position.y = reader.read<int32_t>();
+                frame.textureRect.size.x = reader.read<int32_t>();
+                frame.textureRect.size.y = reader.read<int32_t>();
+                frame.duration = sf::milliseconds(static_cast<int32_t>(reader.read<uint32_t>()));
+                entry.frames.push_back(std::move(frame));
+            }
+            m_tileIds.push_back(entry.tileId);
+            m_palette.push_back(std::move(entry));
+        }
+        std::sort(m_tileIds.begin(), m_tileIds.end());
+        if (std::adjacent_find(m_tileIds.begin(), m_tileIds.end()) != m_tileIds.end()) {
+            throw std::runtime_error("TileMapFile: duplicate palette entry: " + path);
+        }
+
+        // bounded by MAX_CHUNKS_PER_AXIS, so neither product can overflow, even with a 32-bit size_t.
+        const uint64_t chunkCount = static_cast<uint64_t>(chunksX) * chunksY;
+        const uint64_t chunkTableSize = chunkCount * sizeof(uint64_t);
+        if (chunkTableSize > m_file.size()) {
+            throw std::runtime_error("TileMapFile: chunk table out of bounds: " + path);
+        }
+        m_chunkTable = reader.take(static_cast<size_t>(chunkTableSize));
+
+        // checked once here, so that decoding on the workers can't run off the mapping.
+        for (size_t i = 0; i < chunkCount; i++) {
+            uint64_t offset;
+            std::memcpy(&offset, m_chunkTable + i * sizeof(uint64_t), sizeof(uint64_t));
+            if (offset != 0 && (offset > m_file.size() || m_file.size() - offset < c_chunkTiles * sizeof(uint32_t))) {
+                throw std::runtime_error("TileMapFile: chunk out of bounds: " + path);
+            }
+        }
+    }
+
+    bool TileMapFile::decodeChunk(sf::Vector2i chunkCoord, std::vector<SingleTileItem>& tileItems) const {
+        const auto local = chunkCoord - m_chunkRange.position;
+        if (local.x < 0 || local.y < 0 || local.x >= m_chunkRange.size.x || local.y >= m_chunkRange.size.y) {
+            return true;
+        }
+
+        uint64_t offset;
+        const size_t index = static_cast<size_t>(local.y) * m_chunkRange.size.x + local.x;
+        std::memcpy(&offset, m_chunkTable + index * sizeof(uint64_t), sizeof(uint64_t));
+        if (offset == 0) {
+            return true;
+        }
+
+        constexpr auto chunkSize = CTiledRenderComponent::CHUNK_SIZE;
+        const uint8_t* tileIds = m_file.data() + offset;
+        const sf::Vector2i firstTile = chunkCoord * chunkSize;
+        const size_t firstItem = tileItems.size();
+        for (int32_t y = 0; y < chunkSize; y++) {
+            for (int32_t x = 0; x < chunkSize; x++) {
+                TileIdType tileId;
+                std::memcpy(&tileId, tileIds + (static_cast<size_t>(y) * chunkSize + x) * sizeof(uint32_t), sizeof(uint32_t));
+                if (tileId == EMPTY_TILE) {
+                    continue;
+                }
+                // the renderer looks the ids up without a check, an unknown one must not get that far.
+                if (!std::binary_search(m_tileIds.begin(), m_tileIds.end(), tileId)) {
+                    tileItems.erase(tileItems.begin() + static_cast<std::ptrdiff_t>(firstItem), tileItems.end());
+                    return false;
+                }
+                tileItems.emplace_back(tileId, firstTile + sf::Vector2i { x, y }, sf::Vector2i { 1, 1 });
+            }
+        }
+        return true;
+    }
+
+    void TileMapFile::write(const std::string& path, sf::Vector2u tileSize, const std::vector<PaletteEntry>& palette,
+                            sf::IntRect tileRange, const std::function<TileIdType(sf::Vector2i tilePlacement)>& tileAt) {
+        constexpr auto chunkSize = CTiledRenderComponent::CHUNK_SIZE;
+
+        const sf::Vector2i firstChunk { floorDiv(tileRange.position.x, chunkSize), floorDiv(tileRange.position.y, chunkSize) };
+        const sf::Vector2i lastChunk {
+            floorDiv(tileRange.position.x + tileRange.size.x - 1, chunkSize),
+            floorDiv(tileRange.position.y + tileRange.size.y - 1, chunkSize)
+        };
+        const sf::Vector2i chunks = lastChunk - firstChunk + sf::Vector2i { 1, 1 };
+        if (chunks.x > static_cast<int32_t>(MAX_CHUNKS_PER_AXIS) || chunks.y > static_cast<int32_t>(MAX_CHUNKS_PER_AXIS)) {
+            throw std::runtime_error("TileMapFile: too many chunks for " + path);
+        }
+        std::vector<TileIdType> paletteIds;
+        paletteIds.reserve(palette.size());
+        for (const auto& entry : palette) {
+            if (entry.tileId == EMPTY_TILE || entry.frames.empty()) {
+                throw std::runtime_error("TileMapFile: invalid palette entry for " + path);
+            }
+            paletteIds.push_back(entry.tileId);
+        }
+        std::sort(paletteIds.begin(), paletteIds.end());
+        if (std::adjacent_find(paletteIds.begin(), paletteIds.end()) != paletteIds.end()) {
+            throw std::runtime_error("TileMapFile: duplicate palette entry for " + path);
+        }
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream) {
+            throw std::runtime_error("TileMapFile: failed to open " + path + " for writing");
+        }
+        Writer writer(stream);
+
+        writer.writeBytes(c_magic, sizeof(c_magic));
+        writer.write<uint32_t>(VERSION);
+        writer.write<uint32_t>(static_cast<uint32_t>(chunkSize));
+        writer.write<uint32_t>(tileSize.x);
+        writer.write<uint32_t>(tileSize.y);
+        writer.write<int32_t>(firstChunk.x);
+        writer.write<int32_t>(firstChunk.y);
+        writer.write<uint32_t>(static_cast<uint32_t>(chunks.x));
+        writer.write<uint32_t>(static_cast<uint32_t>(chunks.y));
+
+        writer.write<uint32_t>(static_cast<uint32_t>(palette.size()));
+        for (const auto& entry : palette) {
+            writer.write<uint32_t>(entry.tileId);
+            writer.write<uint32_t>(static_cast<uint32_t>(entry.frames.size()));
+            for (const auto& frame : entry.frames) {
+                writer.write<uint16_t>(static_cast<uint16_t>(frame.texturePath.size()));
+                writer.writeBytes(frame.texturePath.data(), frame.texturePath.size());
+                writer.write<int32_t>(frame.textureRect.position.x);
+                writer.write<int32_t>(frame.textureRect.position.y);
+                writer.write<int32_t>(frame.textureRect.size.x);
+                writer.write<int32_t>(frame.textureRect.size.y);
+                writer.write<uint32_t>(static_cast<uint32_t>(frame.duration.asMilliseconds()));
+            }
+        }
+
+        // the table is written as a placeholder first, the offsets are only known once the chunks are written.
+        const auto tablePosition = stream.tellp();
+        const size_t chunkCount = static_cast<size_t>(chunks.x) * chunks.y;
+        std::vector<uint64_t> offsets(chunkCount, 0);
+        writer.writeBytes(offsets.data(), offsets.size() * sizeof(uint64_t));
+
+        std::vector<uint32_t> tileIds(c_chunkTiles);
+        for (int32_t chunkY = 0; chunkY < chunks.y; chunkY++) {
+            for (int32_t chunkX = 0; chunkX < chunks.x; chunkX++) {
+                const sf::Vector2i firstTile = (firstChunk + sf::Vector2i { chunkX, chunkY }) * chunkSize;
+                bool isEmpty = true;
+                for (int32_t y = 0; y < chunkSize; y++) {
+                    for (int32_t x = 0; x < chunkSize; x++) {
+                        const sf::Vector2i tile = firstTile + sf::Vector2i { x, y };
+                        const bool isInside = tileRange.contains(tile);
+                        const TileIdType tileId = isInside ? tileAt(tile) : EMPTY_TILE;
+                        tileIds[static_cast<size_t>(y) * chunkSize + x] = tileId;
+                        isEmpty = isEmpty && tileId == EMPTY_TILE;
+                    }
+                }
+                if (isEmpty) {
+                    continue;
+                }
+                offsets[static_cast<size_t>(chunkY) * chunks.x + chunkX] = static_cast<uint64_t>(stream.tellp());
+                writer.writeBytes(tileIds.data(), tileIds.size() * sizeof(uint32_t));
+            }
+        }
+
+        stream.seekp(tablePosition);
+        writer.writeBytes(offsets.data(), offsets.size() * sizeof(uint64_t));
+        if (!stream) {
+            throw std::runtime_error("TileMapFile: failed to write " + path);
+        }
+    }
+} // game
@@ -0,0 +1,87 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TILEMAPFILE_HPP
+#define TILEMAPFILE_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "components/Render.hpp"
+#include "SFML/Graphics/Rect.hpp"
+#include "SFML/System/Time.hpp"
+#include "SFML/System/Vector2.hpp"
+
+namespace game {
+    /**
+     * Binary tile map, streamed chunk by chunk from a memory mapping.
+     *
+     * Layout, all values little-endian:
+     *  - header: "GTMP", u32 version, u32 chunk size, u32 tile width, u32 tile height,
+     *            i32 first chunk x, i32 first chunk y, u32 chunks x, u32 chunks y, u32 palette size
+     *  - palette: for every entry: u32 tile id, u32 frame count,
+     *             then for every frame: u16 path length, path, i32 x, i32 y, i32 width, i32 height, u32 duration in ms
+     *  - chunk table: chunks x * chunks y u64 offsets into the file, row-major, 0 for an empty chunk
+     *  - chunk data: chunk size * chunk size u32 tile ids per non-empty chunk, row-major, 0 for no tile
+     *
+     * The chunk size must match CTiledRenderComponent::CHUNK_SIZE.
+     */
+    class TileMapFile {
+    public:
+        struct Frame {
+            std::string texturePath;
+            sf::IntRect textureRect;
+            sf::Time duration;
+        };
+
+        struct PaletteEntry {
+            TileIdType tileId;
+            std::vector<Frame> frames;
+        };
+
+        static constexpr uint32_t VERSION = 1;
+        static constexpr TileIdType EMPTY_TILE = 0;
+        /**
+         * upper bound for the chunk count along either axis,
+         * keeps the chunk table size and the chunk coordinates in range whatever the header says.
+         */
+        static constexpr uint32_t MAX_CHUNKS_PER_AXIS = 4096;
+
+        explicit TileMapFile(const std::string& path);
+
+        [[nodiscard]] sf::Vector2u getTileSize() const { return m_tileSize; }
+        /**
+         * @return the chunks covered by the file, in chunk coordinates.
+         */
+        [[nodiscard]] sf::IntRect getChunkRange() const { return m_chunkRange; }
+        [[nodiscard]] const std::vector<PaletteEntry>& getPalette() const { return m_palette; }
+
+        /**
+         * Decodes the tiles of a single chunk. Only reads from the mapping, so it is safe to call from any thread.
+         * An empty chunk, or one outside of the map, decodes to no tiles.
+         * @param chunkCoord chunk coordinates
+         * @param tileItems receives the tiles, in tile coordinates of the whole map
+         * @return false when the chunk refers to a tile id missing from the palette, tileItems is left as it was then
+         */
+        bool decodeChunk(sf::Vector2i chunkCoord, std::vector<SingleTileItem>& tileItems) const;
+
+        /**
+         * Writes a map covering tileRange, tileAt is asked for the tile id at every tile coordinate.
+         */
+        static void write(const std::string& path, sf::Vector2u tileSize, const std::vector<PaletteEntry>& palette,
+                          sf::IntRect tileRange, const std::function<TileIdType(sf::Vector2i tilePlacement)>& tileAt);
+    private:
+        MappedFile m_file;
+        sf::Vector2u m_tileSize;
+        sf::IntRect m_chunkRange;
+        std::vector<PaletteEntry> m_palette;
+        // sorted, for the lookups while decoding.
+        std::vector<TileIdType> m_tileIds;
+        const uint8_t* m_chunkTable { nullptr };
+    };
+} // game
+
+#endif //TILEMAPFILE_HPP
@@ -0,0 +1,201 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+namespace game {
+    TimerWheel::TimerWheel() {
+        for (auto& level : m_slots) {
+            level.fill(TimerHandle::INVALID_INDEX);
+        }
+    }
+
+    TimerHandle TimerWheel::schedule(const sf::Time delay, Callback callback, const entt::entity entity) {
+        return add(delay, 0, std::move(callback), entity);
+    }
+
+    TimerHandle TimerWheel::scheduleRepeating(const sf::Time interval, Callback callback, const entt::entity entity) {
+        return add(interval, std::max<uint64_t>(toTicks(interval), 1), std::move(callback), entity);
+    }
+
+    bool TimerWheel::cancel(TimerHandle& handle) {
+        if (find(handle) == nullptr) {
+            handle = {};
+            return false;
+        }
+
+        // the node stays linked in its slot until that slot comes up.
+        m_nodes[handle.index].active = false;
+        m_pendingCount--;
+        handle = {};
+        return true;
+    }
+
+    bool TimerWheel::isPending(const TimerHandle handle) const {
+        return find(handle) != nullptr;
+    }
+
+    sf::Time TimerWheel::getRemaining(const TimerHandle handle) const {
+        const auto* node = find(handle);
+        if (node == nullptr) {
+            return sf::Time::Zero;
+        }
+        return std::max(TICK * static_cast<int64_t>(node->expires - m_now) - m_remainder, sf::Time::Zero);
+    }
+
+    void TimerWheel::advance(const sf::Time deltaTime) {
+        m_remainder += deltaTime;
+        while (m_remainder >= TICK) {
+            m_remainder -= TICK;
+            tick();
+        }
+    }
+
+    void TimerWheel::clear() {
+        // the nodes are kept and released, the generation bump invalidates every handle given out so far.
+        // dropping them would start the generations over, and a stale handle could match a new timer.
+        m_freeNodes.clear();
+        for (uint32_t index = 0; index < m_nodes.size(); index++) {
+            m_nodes[index].active = false;
+            release(index);
+        }
+        for (auto& level : m_slots) {
+            level.fill(TimerHandle::INVALID_INDEX);
+        }
+        m_pendingCount = 0;
+    }
+
+    TimerHandle TimerWheel::add(const sf::Time delay, const uint64_t interval, Callback callback, const entt::entity entity) {
+        uint32_t index;
+        if (m_freeNodes.empty()) {
+            index = static_cast<uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        } else {
+            index = m_freeNodes.back();
+            m_freeNodes.pop_back();
+        }
+
+        auto& node = m_nodes[index];
+        // the current tick has been handled already.
+        node.expires = m_now + std::max<uint64_t>(toTicks(delay), 1);
+        node.interval = interval;
+        node.entity = entity;
+        node.callback = std::move(callback);
+        node.active = true;
+
+        insert(index);
+        m_pendingCount++;
+        return { index, node.generation };
+    }
+
+    const TimerWheel::Node* TimerWheel::find(const TimerHandle handle) const {
+        if (handle.index >= m_nodes.size()) {
+            return nullptr;
+        }
+        const auto& node = m_nodes[handle.index];
+        if (!node.active || node.generation != handle.generation) {
+            return nullptr;
+        }
+        return &node;
+    }
+
+    void TimerWheel::insert(const uint32_t index) {
+        auto& node = m_nodes[index];
+        const auto delta = node.expires - m_now;
+        // out of range, parked in the last level and moved down once it gets closer.
+        const auto target = delta < RANGE ? node.expires : m_now + RANGE - 1;
+
+        size_t level = 0;
+        while (level + 1 < LEVELS && target - m_now >= uint64_t { 1 } << (SLOT_BITS * (level + 1))) {
+            level++;
+        }
+
+        const auto slot = (target >> (SLOT_BITS * level)) & SLOT_MASK;
+        node.next = m_slots[level][slot];
+        m_slots[level][slot] = index;
+    }
+
+    void TimerWheel::cascade(const size_t level) {
+        const auto slot = (m_now >> (SLOT_BITS * level)) & SLOT_MASK;
+        auto index = m_slots[level][slot];
+        m_slots[level][slot] = TimerHandle::INVALID_INDEX;
+
+        while (index != TimerHandle::INVALID_INDEX) {
+            const auto next = m_nodes[index].next;
+            if (m_nodes[index].active) {
+                insert(index);
+            } else {
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    void TimerWheel::tick() {
+        m_now++;
+
+        // the levels above only move down when the level below wraps around.
+        for (size_t level = 1; level < LEVELS; level++) {
+            if ((m_now & ((uint64_t { 1 } << (SLOT_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+
+        const auto slot = m_now & SLOT_MASK;
+        auto index = m_slots[0][slot];
+        m_slots[0][slot] = TimerHandle::INVALID_INDEX;
+
+        auto& registry = getRegistry();
+        while (index != TimerHandle::INVALID_INDEX) {
+            auto& node = m_nodes[index];
+            const auto next = node.next;
+
+            if (node.active && node.entity != entt::null && !registry.valid(node.entity)) {
+                node.active = false;
+                m_pendingCount--;
+            }
+            if (!node.active) {
+                release(index);
+                index = next;
+                continue;
+            }
+
+            if (node.interval > 0) {
+                node.expires += node.interval;
+                insert(index);
+            } else {
+                node.active = false;
+                m_pendingCount--;
+            }
+
+            if (node.callback) {
+                node.callback(node.entity);
+            }
+
+            // a repeating timer cancelled by its own callback is released when its slot comes up again.
+            if (node.interval == 0) {
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    void TimerWheel::release(const uint32_t index) {
+        auto& node = m_nodes[index];
+        node.callback = nullptr;
+        node.next = TimerHandle::INVALID_INDEX;
+        node.generation++;
+        m_freeNodes.push_back(index);
+    }
+
+    uint64_t TimerWheel::toTicks(const sf::Time time) {
+        if (time <= sf::Time::Zero) {
+            return 0;
+        }
+        return static_cast<uint64_t>(time.asMicroseconds() / TICK.asMicroseconds());
+    }
+} // game
@@ -0,0 +1,129 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <entt/entity/entity.hpp>
+#include <entt/signal/dispatcher.hpp>
+
+#include "Common.hpp"
+#include "SFML/System/Time.hpp"
+
+namespace game {
+    struct TimerHandle {
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        uint32_t index { INVALID_INDEX };
+        uint32_t generation { 0 };
+    };
+
+    /**
+     * Hierarchical timer wheel, driven by the scaled game time.
+     * Timers sit in the slot of the tick they expire on, so only the expiring ones are touched every frame,
+     * the far away ones are moved down a level once every 64 ticks of the level below.
+     * Being advanced by the scaled delta time, the timers follow slow motion and stop while the game is paused.
+     *
+     * Callbacks may schedule and cancel timers. A timer bound to an entity is dropped once the entity is gone.
+     */
+    class TimerWheel {
+    public:
+        using Callback = std::function<void(entt::entity)>;
+
+        static constexpr sf::Time TICK = sf::milliseconds(1);
+
+        TimerWheel();
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+
+        /**
+         * @param callback may be empty, e.g. for cooldowns which are only polled with isPending()
+         */
+        TimerHandle schedule(sf::Time delay, Callback callback, entt::entity entity = entt::null);
+        TimerHandle scheduleRepeating(sf::Time interval, Callback callback, entt::entity entity = entt::null);
+
+        /**
+         * Triggers the event through the event dispatcher once the delay has passed.
+         */
+        template <typename Event>
+        TimerHandle scheduleEvent(sf::Time delay, Event event);
+
+        /**
+         * Cancels the timer and resets the handle.
+         * @return false if the timer already fired or was cancelled before
+         */
+        bool cancel(TimerHandle& handle);
+
+        [[nodiscard]] bool isPending(TimerHandle handle) const;
+
+        /**
+         * @return zero if the timer is not pending
+         */
+        [[nodiscard]] sf::Time getRemaining(TimerHandle handle) const;
+
+        void advance(sf::Time deltaTime);
+
+        /**
+         * Cancels every timer, the handles given out so far stay invalid.
+         * Must not be called from a timer callback.
+         */
+        void clear();
+
+        [[nodiscard]] size_t getPendingCount() const { return m_pendingCount; }
+        [[nodiscard]] sf::Time getTime() const { return TICK * static_cast<int64_t>(m_now) + m_remainder; }
+
+    private:
+        static constexpr size_t LEVELS = 4;
+        static constexpr size_t SLOT_BITS = 6;
+        static constexpr size_t SLOTS = 1 << SLOT_BITS;
+        static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+        // beyond this, timers wait in the last level until they come into range.
+        static constexpr uint64_t RANGE = uint64_t { 1 } << (SLOT_BITS * LEVELS);
+
+        struct Node {
+            uint64_t expires { 0 };
+            // in ticks, zero for one-shot timers.
+            uint64_t interval { 0 };
+            entt::entity entity { entt::null };
+            Callback callback;
+            uint32_t next { TimerHandle::INVALID_INDEX };
+            uint32_t generation { 0 };
+            bool active { false };
+        };
+
+        // a deque, so that a node stays put while its callback schedules new timers.
+        std::deque<Node> m_nodes;
+        std::vector<uint32_t> m_freeNodes;
+        std::array<std::array<uint32_t, SLOTS>, LEVELS> m_slots {};
+
+        uint64_t m_now { 0 };
+        sf::Time m_remainder;
+        size_t m_pendingCount { 0 };
+
+        TimerHandle add(sf::Time delay, uint64_t interval, Callback callback, entt::entity entity);
+        [[nodiscard]] const Node* find(TimerHandle handle) const;
+
+        void insert(uint32_t index);
+        void cascade(size_t level);
+        void tick();
+        void release(uint32_t index);
+
+        static uint64_t toTicks(sf::Time time);
+    };
+
+    template <typename Event>
+    TimerHandle TimerWheel::scheduleEvent(const sf::Time delay, Event event) {
+        return schedule(delay, [event = std::move(event)](entt::entity) {
+            getEventDispatcher().trigger(event);
+        });
+    }
+} // game
+
+#endif //TIMERWHEEL_HPP
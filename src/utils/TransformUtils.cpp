@@ -0,0 +1,88 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TransformUtils.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAME_TRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace game {
+    void TransformUtils::compose(TransformBatch& batch) {
+#ifdef GAME_TRANSFORM_SSE2
+        const __m128 parentX = _mm_load_ps(batch.parentX);
+        const __m128 parentY = _mm_load_ps(batch.parentY);
+        const __m128 parentCos = _mm_load_ps(batch.parentCos);
+        const __m128 parentSin = _mm_load_ps(batch.parentSin);
+        const __m128 localX = _mm_load_ps(batch.localX);
+        const __m128 localY = _mm_load_ps(batch.localY);
+
+        const __m128 x = _mm_add_ps(parentX, _mm_sub_ps(_mm_mul_ps(parentCos, localX), _mm_mul_ps(parentSin, localY)));
+        const __m128 y = _mm_add_ps(parentY, _mm_add_ps(_mm_mul_ps(parentSin, localX), _mm_mul_ps(parentCos, localY)));
+
+        const __m128 scaleX = _mm_mul_ps(_mm_load_ps(batch.parentScaleX), _mm_load_ps(batch.localScaleX));
+        const __m128 scaleY = _mm_mul_ps(_mm_load_ps(batch.parentScaleY), _mm_load_ps(batch.localScaleY));
+
+        const __m128 originX = _mm_mul_ps(_mm_load_ps(batch.anchorX), _mm_load_ps(batch.width));
+        const __m128 originY = _mm_mul_ps(_mm_load_ps(batch.anchorY), _mm_load_ps(batch.height));
+
+        const __m128 cos = _mm_load_ps(batch.cos);
+        const __m128 sin = _mm_load_ps(batch.sin);
+        const __m128 a = _mm_mul_ps(cos, scaleX);
+        const __m128 b = _mm_mul_ps(sin, scaleX);
+        const __m128 c = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sin, scaleY));
+        const __m128 d = _mm_mul_ps(cos, scaleY);
+
+        const __m128 tx = _mm_sub_ps(x, _mm_add_ps(_mm_mul_ps(a, originX), _mm_mul_ps(c, originY)));
+        const __m128 ty = _mm_sub_ps(y, _mm_add_ps(_mm_mul_ps(b, originX), _mm_mul_ps(d, originY)));
+
+        _mm_store_ps(batch.x, x);
+        _mm_store_ps(batch.y, y);
+        _mm_store_ps(batch.scaleX, scaleX);
+        _mm_store_ps(batch.scaleY, scaleY);
+        _mm_store_ps(batch.originX, originX);
+        _mm_store_ps(batch.originY, originY);
+        _mm_store_ps(batch.a, a);
+        _mm_store_ps(batch.b, b);
+        _mm_store_ps(batch.c, c);
+        _mm_store_ps(batch.d, d);
+        _mm_store_ps(batch.tx, tx);
+        _mm_store_ps(batch.ty, ty);
+#else
+        composeScalar(batch);
+#endif
+    }
+
+    void TransformUtils::composeScalar(TransformBatch& batch) {
+        for (size_t i = 0; i < TransformBatch::LANES; i++) {
+            const float x = batch.parentX[i] + batch.parentCos[i] * batch.localX[i] - batch.parentSin[i] * batch.localY[i];
+            const float y = batch.parentY[i] + batch.parentSin[i] * batch.localX[i] + batch.parentCos[i] * batch.localY[i];
+
+            const float scaleX = batch.parentScaleX[i] * batch.localScaleX[i];
+            const float scaleY = batch.parentScaleY[i] * batch.localScaleY[i];
+
+            const float originX = batch.anchorX[i] * batch.width[i];
+            const float originY = batch.anchorY[i] * batch.height[i];
+
+            const float a = batch.cos[i] * scaleX;
+            const float b = batch.sin[i] * scaleX;
+            const float c = -(batch.sin[i] * scaleY);
+            const float d = batch.cos[i] * scaleY;
+
+            batch.x[i] = x;
+            batch.y[i] = y;
+            batch.scaleX[i] = scaleX;
+            batch.scaleY[i] = scaleY;
+            batch.originX[i] = originX;
+            batch.originY[i] = originY;
+            batch.a[i] = a;
+            batch.b[i] = b;
+            batch.c[i] = c;
+            batch.d[i] = d;
+            batch.tx[i] = x - (a * originX + c * originY);
+            batch.ty[i] = y - (b * originX + d * originY);
+        }
+    }
+} // game
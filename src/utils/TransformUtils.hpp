@@ -0,0 +1,70 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TRANSFORMUTILS_HPP
+#define TRANSFORMUTILS_HPP
+
+#include <cstddef>
+
+namespace game {
+    /**
+     * A few transforms laid out lane by lane, so that they can be composed with one simd instruction per step.
+     * Fill the inputs, call TransformUtils::compose(), read the outputs.
+     * Unused lanes should be left zeroed.
+     */
+    struct TransformBatch {
+        static constexpr size_t LANES = 4;
+
+        // inputs: the parent's frame, i.e. its global position, rotation and scale.
+        // an entity without a (relative) parent uses the identity.
+        alignas(16) float parentX[LANES];
+        alignas(16) float parentY[LANES];
+        alignas(16) float parentCos[LANES];
+        alignas(16) float parentSin[LANES];
+        alignas(16) float parentScaleX[LANES];
+        alignas(16) float parentScaleY[LANES];
+
+        // inputs: the entity itself. cos and sin are of its global rotation.
+        alignas(16) float localX[LANES];
+        alignas(16) float localY[LANES];
+        alignas(16) float localScaleX[LANES];
+        alignas(16) float localScaleY[LANES];
+        alignas(16) float anchorX[LANES];
+        alignas(16) float anchorY[LANES];
+        alignas(16) float width[LANES];
+        alignas(16) float height[LANES];
+        alignas(16) float cos[LANES];
+        alignas(16) float sin[LANES];
+
+        // outputs
+        alignas(16) float x[LANES];
+        alignas(16) float y[LANES];
+        alignas(16) float scaleX[LANES];
+        alignas(16) float scaleY[LANES];
+        alignas(16) float originX[LANES];
+        alignas(16) float originY[LANES];
+        alignas(16) float a[LANES];
+        alignas(16) float b[LANES];
+        alignas(16) float c[LANES];
+        alignas(16) float d[LANES];
+        alignas(16) float tx[LANES];
+        alignas(16) float ty[LANES];
+    };
+
+    class TransformUtils {
+    public:
+        /**
+         * position = parent position + parent rotation * local position
+         * scale = parent scale * local scale, origin = anchor * size,
+         * and the affine matrix of translate(position) * rotate * scale * translate(-origin).
+         * Uses sse2 where available.
+         */
+        static void compose(TransformBatch& batch);
+
+    private:
+        static void composeScalar(TransformBatch& batch);
+    };
+} // game
+
+#endif //TRANSFORMUTILS_HPP
@@ -0,0 +1,499 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#include "TweenEngine.hpp"
+
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GAME_TWEEN_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "Common.hpp"
+#include "components/Render.hpp"
+#include "utils/MovementUtils.hpp"
+
+namespace {
+#ifdef GAME_TWEEN_SSE2
+    __m128 select(const __m128 mask, const __m128 ifTrue, const __m128 ifFalse) {
+        return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+    }
+
+    // the in-out polynomials: p < 0.5 ? 2^(n-1) * p^n : 1 - (2 - 2p)^n / 2
+    template <int N>
+    __m128 easePolynomial(const __m128 p) {
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 two = _mm_set1_ps(2.f);
+
+        const __m128 q = _mm_sub_ps(two, _mm_mul_ps(two, p));
+        __m128 pn = p;
+        __m128 qn = q;
+        for (int i = 1; i < N; i++) {
+            pn = _mm_mul_ps(pn, p);
+            qn = _mm_mul_ps(qn, q);
+        }
+
+        const __m128 in = _mm_mul_ps(_mm_set1_ps(static_cast<float>(1 << (N - 1))), pn);
+        const __m128 out = _mm_sub_ps(one, _mm_mul_ps(half, qn));
+        return select(_mm_cmplt_ps(p, half), in, out);
+    }
+
+    // p < 0.5 ? (1 - sqrt(1 - (2p)^2)) / 2 : (sqrt(1 - (2 - 2p)^2) + 1) / 2
+    __m128 easeCircular(const __m128 p) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 two = _mm_set1_ps(2.f);
+
+        const __m128 a = _mm_mul_ps(two, p);
+        const __m128 q = _mm_sub_ps(two, a);
+        const __m128 in = _mm_mul_ps(half,
+            _mm_sub_ps(one, _mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(a, a))))));
+        const __m128 out = _mm_mul_ps(half,
+            _mm_add_ps(_mm_sqrt_ps(_mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(q, q)))), one));
+        return select(_mm_cmplt_ps(p, half), in, out);
+    }
+#endif
+
+    template <typename Simd, typename Scalar>
+    void easeBatch(float* values, const size_t count, [[maybe_unused]] Simd simd, Scalar scalar) {
+        size_t i = 0;
+#ifdef GAME_TWEEN_SSE2
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_ps(values + i, simd(_mm_loadu_ps(values + i)));
+        }
+#endif
+        for (; i < count; i++) {
+            values[i] = scalar(values[i]);
+        }
+    }
+
+    template <typename Scalar>
+    void easeScalar(float* values, const size_t count, Scalar scalar) {
+        for (size_t i = 0; i < count; i++) {
+            values[i] = scalar(values[i]);
+        }
+    }
+
+#ifdef GAME_TWEEN_SSE2
+#define GAME_TWEEN_SIMD(fn) fn
+#else
+#define GAME_TWEEN_SIMD(fn) nullptr
+#endif
+}
+
+namespace game {
+    TweenHandle TweenEngine::start(const entt::entity entity, const TweenSpec& spec) {
+        uint32_t index;
+        if (m_freeTweens.empty()) {
+            index = static_cast<uint32_t>(m_tweens.size());
+            m_tweens.emplace_back();
+        } else {
+            index = m_freeTweens.back();
+            m_freeTweens.pop_back();
+        }
+
+        auto& pool = m_pools[static_cast<size_t>(spec.getEasing())];
+
+        auto& tween = m_tweens[index];
+        tween.entity = entity;
+        tween.target = spec.getTarget();
+        tween.easing = spec.getEasing();
+        tween.from = spec.getFrom();
+        tween.to = spec.getTo();
+        tween.writer = spec.getWriter();
+        tween.onComplete = spec.getCompletionCallback();
+        tween.slot = static_cast<uint32_t>(pool.tweens.size());
+        tween.active = true;
+
+        const auto duration = spec.getDuration().asSeconds();
+        pool.elapsed.push_back(0.f);
+        pool.delay.push_back(spec.getDelay().asSeconds());
+        // a zero duration finishes on the first update.
+        pool.inverseDuration.push_back(duration > 0.f ? 1.f / duration : FLT_MAX);
+        pool.value.push_back(0.f);
+        pool.tweens.push_back(index);
+
+        m_runningCount++;
+        return { index, tween.generation };
+    }
+
+    bool TweenEngine::stop(TweenHandle& handle) {
+        const bool running = isRunning(handle);
+        if (running) {
+            remove(handle.index);
+        }
+        handle = {};
+        return running;
+    }
+
+    bool TweenEngine::isRunning(const TweenHandle handle) const {
+        return handle.index < m_tweens.size()
+            && m_tweens[handle.index].active
+            && m_tweens[handle.index].generation == handle.generation;
+    }
+
+    TimelineHandle TweenEngine::play(const Timeline& timeline) {
+        uint32_t index;
+        if (m_freeTimelines.empty()) {
+            index = static_cast<uint32_t>(m_timelines.size());
+            m_timelines.emplace_back();
+        } else {
+            index = m_freeTimelines.back();
+            m_freeTimelines.pop_back();
+        }
+
+        auto& playback = m_timelines[index];
+        playback.owner = timeline.getOwner();
+        // keeps the capacity of a recycled playback.
+        playback.segments.assign(timeline.getSegments().begin(), timeline.getSegments().end());
+        playback.duration = timeline.getDuration();
+        playback.elapsed = 0.f;
+        playback.repeat = timeline.getRepeat();
+        playback.yoyo = timeline.isYoyo();
+        playback.reversed = false;
+        playback.onComplete = timeline.getCompletionCallback();
+        playback.active = true;
+
+        m_playingCount++;
+        return { index, playback.generation };
+    }
+
+    bool TweenEngine::stop(TimelineHandle& handle) {
+        const bool playing = isPlaying(handle);
+        if (playing) {
+            removeTimeline(handle.index);
+        }
+        handle = {};
+        return playing;
+    }
+
+    bool TweenEngine::isPlaying(const TimelineHandle handle) const {
+        return handle.index < m_timelines.size()
+            && m_timelines[handle.index].active
+            && m_timelines[handle.index].generation == handle.generation;
+    }
+
+    void TweenEngine::update(const sf::Time deltaTime) {
+        if (m_runningCount == 0 && m_playingCount == 0) {
+            return;
+        }
+
+        auto& registry = getRegistry();
+        m_finished.clear();
+        m_finishedTimelines.clear();
+
+        updateTweens(registry, deltaTime.asSeconds());
+        updateTimelines(registry, deltaTime.asSeconds());
+
+        // the pools are left alone while they are iterated, the callbacks often start the next tween.
+        for (const auto handle : m_finished) {
+            if (!isRunning(handle)) {
+                // stopped by an earlier callback.
+                continue;
+            }
+
+            const auto entity = m_tweens[handle.index].entity;
+            const auto onComplete = m_tweens[handle.index].onComplete;
+            remove(handle.index);
+
+            if (onComplete && registry.valid(entity)) {
+                onComplete(entity);
+            }
+        }
+
+        for (const auto handle : m_finishedTimelines) {
+            if (!isPlaying(handle)) {
+                continue;
+            }
+
+            const auto owner = m_timelines[handle.index].owner;
+            const auto onComplete = m_timelines[handle.index].onComplete;
+            removeTimeline(handle.index);
+
+            if (onComplete && registry.valid(owner)) {
+                onComplete(owner);
+            }
+        }
+    }
+
+    void TweenEngine::clear() {
+        for (auto& pool : m_pools) {
+            pool = {};
+        }
+        // the tweens are kept, stopping them bumps the generations and the handles given out so far stay stale.
+        m_freeTweens.clear();
+        for (uint32_t index = 0; index < m_tweens.size(); index++) {
+            auto& tween = m_tweens[index];
+            if (tween.active) {
+                tween.active = false;
+                tween.generation++;
+                tween.onComplete.reset();
+            }
+            m_freeTweens.push_back(index);
+        }
+        m_finished.clear();
+        m_runningCount = 0;
+
+        m_freeTimelines.clear();
+        for (uint32_t index = 0; index < m_timelines.size(); index++) {
+            auto& playback = m_timelines[index];
+            if (playback.active) {
+                playback.active = false;
+                playback.generation++;
+                playback.segments.clear();
+                playback.onComplete.reset();
+            }
+            m_freeTimelines.push_back(index);
+        }
+        m_finishedTimelines.clear();
+        m_playingCount = 0;
+    }
+
+    void TweenEngine::remove(const uint32_t index) {
+        auto& tween = m_tweens[index];
+        auto& pool = m_pools[static_cast<size_t>(tween.easing)];
+
+        const auto slot = tween.slot;
+        const auto last = pool.tweens.size() - 1;
+        if (slot != last) {
+            pool.elapsed[slot] = pool.elapsed[last];
+            pool.delay[slot] = pool.delay[last];
+            pool.inverseDuration[slot] = pool.inverseDuration[last];
+            pool.value[slot] = pool.value[last];
+            pool.tweens[slot] = pool.tweens[last];
+            m_tweens[pool.tweens[slot]].slot = slot;
+        }
+        pool.elapsed.pop_back();
+        pool.delay.pop_back();
+        pool.inverseDuration.pop_back();
+        pool.value.pop_back();
+        pool.tweens.pop_back();
+
+        tween.active = false;
+        tween.generation++;
+        tween.onComplete.reset();
+        m_freeTweens.push_back(index);
+        m_runningCount--;
+    }
+
+    void TweenEngine::removeTimeline(const uint32_t index) {
+        auto& playback = m_timelines[index];
+        playback.active = false;
+        playback.generation++;
+        playback.segments.clear();
+        playback.onComplete.reset();
+        m_freeTimelines.push_back(index);
+        m_playingCount--;
+    }
+
+    void TweenEngine::apply(entt::registry& registry, const entt::entity entity, const TweenTarget target,
+                            const TweenWriter writer, const sf::Vector2f value) {
+        switch (target) {
+            case TweenTarget::Position:
+                MovementUtils::setPosition(entity, value);
+                break;
+            case TweenTarget::Size:
+                MovementUtils::setSize(entity, value);
+                break;
+            case TweenTarget::Scale:
+                MovementUtils::setScale(entity, value);
+                break;
+            case TweenTarget::Alpha: {
+                const auto alpha = static_cast<uint8_t>(std::clamp(value.x, 0.f, 1.f) * 255.f);
+                if (auto* spriteRenderComponent = registry.try_get<CSpriteRenderComponent>(entity)) {
+                    if (auto sprite = spriteRenderComponent->getSprite(); sprite.has_value()) {
+                        auto color = sprite.value()->getColor();
+                        color.a = alpha;
+                        sprite.value()->setColor(color);
+                    }
+                }
+                if (auto* textRenderComponent = registry.try_get<CTextRenderComponent>(entity)) {
+                    auto color = textRenderComponent->getColor();
+                    color.a = alpha;
+                    textRenderComponent->setColor(color);
+                }
+                if (auto* shapeRenderComponent = registry.try_get<CShapeRenderComponent>(entity)) {
+                    if (auto* shape = shapeRenderComponent->getShape()) {
+                        auto color = shape->getFillColor();
+                        color.a = alpha;
+                        shape->setFillColor(color);
+                    }
+                }
+                break;
+            }
+            case TweenTarget::Binding:
+                if (writer != nullptr) {
+                    writer(registry, entity, value);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void TweenEngine::updateTweens(entt::registry& registry, const float deltaTime) {
+        for (size_t easing = 0; easing < EASING_COUNT; easing++) {
+            auto& pool = m_pools[easing];
+            const auto count = pool.tweens.size();
+            if (count == 0) {
+                continue;
+            }
+
+            advance(pool, deltaTime);
+            ease(static_cast<Easing>(easing), pool.value.data(), count);
+
+            for (size_t i = 0; i < count; i++) {
+                const auto index = pool.tweens[i];
+                const auto& tween = m_tweens[index];
+
+                if (!registry.valid(tween.entity)) {
+                    m_finished.push_back({ index, tween.generation });
+                    continue;
+                }
+                if (pool.elapsed[i] < pool.delay[i]) {
+                    continue;
+                }
+
+                apply(registry, tween.entity, tween.target, tween.writer, tween.from + (tween.to - tween.from) * pool.value[i]);
+                if ((pool.elapsed[i] - pool.delay[i]) * pool.inverseDuration[i] >= 1.f) {
+                    m_finished.push_back({ index, tween.generation });
+                }
+            }
+        }
+    }
+
+    void TweenEngine::updateTimelines(entt::registry& registry, const float deltaTime) {
+        for (uint32_t index = 0; index < m_timelines.size(); index++) {
+            auto& playback = m_timelines[index];
+            if (!playback.active) {
+                continue;
+            }
+
+            if (!registry.valid(playback.owner) || advanceTimeline(registry, playback, deltaTime)) {
+                m_finishedTimelines.push_back({ index, playback.generation });
+            }
+        }
+    }
+
+    bool TweenEngine::advanceTimeline(entt::registry& registry, Playback& playback, const float deltaTime) {
+        float previous = playback.elapsed;
+        float elapsed = playback.elapsed + deltaTime;
+
+        while (elapsed >= playback.duration) {
+            // land every segment on its end before wrapping around.
+            evaluate(registry, playback, previous, playback.duration);
+            if (playback.repeat == 0 || playback.duration <= 0.f) {
+                playback.elapsed = playback.duration;
+                return true;
+            }
+
+            if (playback.repeat > 0) {
+                playback.repeat--;
+            }
+            if (playback.yoyo) {
+                playback.reversed = !playback.reversed;
+            }
+            elapsed -= playback.duration;
+            previous = 0.f;
+        }
+
+        evaluate(registry, playback, previous, elapsed);
+        playback.elapsed = elapsed;
+        return false;
+    }
+
+    void TweenEngine::evaluate(entt::registry& registry, const Playback& playback, float previous, float current) {
+        if (playback.reversed) {
+            previous = playback.duration - previous;
+            current = playback.duration - current;
+        }
+        const auto low = std::min(previous, current);
+        const auto high = std::max(previous, current);
+
+        auto evaluateSegment = [&](const TimelineSegment& segment) {
+            // only the segments this frame has passed through, so that the ones on the same target don't fight.
+            if (high < segment.start || low > segment.end || !registry.valid(segment.entity)) {
+                return;
+            }
+
+            float progress;
+            if (segment.end > segment.start) {
+                progress = std::clamp((current - segment.start) / (segment.end - segment.start), 0.f, 1.f);
+            } else {
+                progress = current >= segment.start ? 1.f : 0.f;
+            }
+
+            const auto value = EasingFunction::evaluate(segment.easing, progress);
+            apply(registry, segment.entity, segment.target, segment.writer, segment.from + (segment.to - segment.from) * value);
+        };
+
+        // the later segment wins, in the direction of playback.
+        if (playback.reversed) {
+            for (auto it = playback.segments.rbegin(); it != playback.segments.rend(); ++it) {
+                evaluateSegment(*it);
+            }
+        } else {
+            for (const auto& segment : playback.segments) {
+                evaluateSegment(segment);
+            }
+        }
+    }
+
+    void TweenEngine::advance(Pool& pool, const float deltaTime) {
+        const auto count = pool.tweens.size();
+        float* elapsed = pool.elapsed.data();
+        const float* delay = pool.delay.data();
+        const float* inverseDuration = pool.inverseDuration.data();
+        float* value = pool.value.data();
+
+        size_t i = 0;
+#ifdef GAME_TWEEN_SSE2
+        const __m128 step = _mm_set1_ps(deltaTime);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.f);
+        for (; i + 4 <= count; i += 4) {
+            const __m128 e = _mm_add_ps(_mm_loadu_ps(elapsed + i), step);
+            _mm_storeu_ps(elapsed + i, e);
+
+            const __m128 progress = _mm_mul_ps(_mm_sub_ps(e, _mm_loadu_ps(delay + i)), _mm_loadu_ps(inverseDuration + i));
+            _mm_storeu_ps(value + i, _mm_min_ps(_mm_max_ps(progress, zero), one));
+        }
+#endif
+        for (; i < count; i++) {
+            elapsed[i] += deltaTime;
+            value[i] = std::clamp((elapsed[i] - delay[i]) * inverseDuration[i], 0.f, 1.f);
+        }
+    }
+
+    void TweenEngine::ease(const Easing easing, float* values, const size_t count) {
+        switch (easing) {
+            case Easing::Quadratic:
+                easeBatch(values, count, GAME_TWEEN_SIMD(easePolynomial<2>), &EasingFunction::quadratic);
+                break;
+            case Easing::Cubic:
+                easeBatch(values, count, GAME_TWEEN_SIMD(easePolynomial<3>), &EasingFunction::cubic);
+                break;
+            case Easing::Quartic:
+                easeBatch(values, count, GAME_TWEEN_SIMD(easePolynomial<4>), &EasingFunction::quartic);
+                break;
+            case Easing::Circular:
+                easeBatch(values, count, GAME_TWEEN_SIMD(easeCircular), &EasingFunction::circular);
+                break;
+            // cos and pow have no sse2 counterpart, these stay scalar.
+            case Easing::Sine:
+                easeScalar(values, count, &EasingFunction::sine);
+                break;
+            case Easing::Exponential:
+                easeScalar(values, count, &EasingFunction::exponential);
+                break;
+            default:
+                // linear, the progress already is the value.
+                break;
+        }
+    }
+} // game
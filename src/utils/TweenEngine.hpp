@@ -0,0 +1,134 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TWEENENGINE_HPP
+#define TWEENENGINE_HPP
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "components/Tweening.hpp"
+
+namespace game {
+    /**
+     * Runs every tween of the game. Tweens are kept in one pool per easing, laid out field by field,
+     * so that the progress and the easing are computed for a whole pool in one batched (sse2 where available) loop.
+     * The values are then written straight to the typed target of each tween, the only user code called is
+     * the completion callback.
+     *
+     * Timelines are played in the same pass, segment by segment.
+     *
+     * A tween is dropped silently once its entity is gone, a timeline once its owner is gone.
+     * Driven by STweenSystem with the scaled delta time.
+     */
+    class TweenEngine {
+    public:
+        TweenEngine() = default;
+
+        TweenEngine(const TweenEngine&) = delete;
+        TweenEngine& operator=(const TweenEngine&) = delete;
+
+        TweenHandle start(entt::entity entity, const TweenSpec& spec);
+
+        /**
+         * Stops the tween where it is, without calling the completion callback, and resets the handle.
+         * @return false if the tween was not running
+         */
+        bool stop(TweenHandle& handle);
+
+        [[nodiscard]] bool isRunning(TweenHandle handle) const;
+
+        TimelineHandle play(const Timeline& timeline);
+
+        /**
+         * Stops the timeline where it is, without calling the completion callback, and resets the handle.
+         * @return false if the timeline was not playing
+         */
+        bool stop(TimelineHandle& handle);
+
+        [[nodiscard]] bool isPlaying(TimelineHandle handle) const;
+
+        void update(sf::Time deltaTime);
+
+        /**
+         * Stops every tween and timeline without calling the completion callbacks,
+         * the handles given out so far stay invalid.
+         */
+        void clear();
+
+        [[nodiscard]] size_t getRunningCount() const { return m_runningCount; }
+        [[nodiscard]] size_t getPlayingCount() const { return m_playingCount; }
+
+    private:
+        static constexpr size_t EASING_COUNT = static_cast<size_t>(Easing::Count);
+
+        struct Pool {
+            // in seconds.
+            std::vector<float> elapsed;
+            std::vector<float> delay;
+            std::vector<float> inverseDuration;
+            // the progress, eased in place.
+            std::vector<float> value;
+            std::vector<uint32_t> tweens;
+        };
+
+        struct Tween {
+            entt::entity entity { entt::null };
+            TweenTarget target { TweenTarget::None };
+            Easing easing { Easing::Linear };
+            sf::Vector2f from;
+            sf::Vector2f to;
+            TweenWriter writer { nullptr };
+            TweenCompletionDelegate onComplete;
+            // position in the pool of its easing.
+            uint32_t slot { 0 };
+            uint32_t generation { 0 };
+            bool active { false };
+        };
+
+        struct Playback {
+            entt::entity owner { entt::null };
+            std::vector<TimelineSegment> segments;
+            float duration { 0.f };
+            // within the current repeat.
+            float elapsed { 0.f };
+            int32_t repeat { 0 };
+            bool yoyo { false };
+            bool reversed { false };
+            TweenCompletionDelegate onComplete;
+            uint32_t generation { 0 };
+            bool active { false };
+        };
+
+        std::array<Pool, EASING_COUNT> m_pools;
+        std::vector<Tween> m_tweens;
+        std::vector<uint32_t> m_freeTweens;
+        // handles, a callback may stop or restart a tween that is still queued.
+        std::vector<TweenHandle> m_finished;
+        size_t m_runningCount { 0 };
+
+        std::vector<Playback> m_timelines;
+        std::vector<uint32_t> m_freeTimelines;
+        std::vector<TimelineHandle> m_finishedTimelines;
+        size_t m_playingCount { 0 };
+
+        void remove(uint32_t index);
+        void removeTimeline(uint32_t index);
+        static void apply(entt::registry& registry, entt::entity entity, TweenTarget target, TweenWriter writer, sf::Vector2f value);
+
+        void updateTweens(entt::registry& registry, float deltaTime);
+        void updateTimelines(entt::registry& registry, float deltaTime);
+        /**
+         * @return true once the last repeat has ended
+         */
+        static bool advanceTimeline(entt::registry& registry, Playback& playback, float deltaTime);
+        static void evaluate(entt::registry& registry, const Playback& playback, float previous, float current);
+
+        static void advance(Pool& pool, float deltaTime);
+        static void ease(Easing easing, float* values, size_t count);
+    };
+} // game
+
+#endif //TWEENENGINE_HPP
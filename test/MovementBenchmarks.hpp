@@ -0,0 +1,64 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef MOVEMENTBENCHMARKS_HPP
+#define MOVEMENTBENCHMARKS_HPP
+
+#include <sstream>
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "components/Layout.hpp"
+#include "components/Velocity.hpp"
+#include "systems/MovementControl.hpp"
+#include "systems/SceneControl.hpp"
+#include "utils/MovementUtils.hpp"
+
+/**
+ * Measures SMovementSystem::update() over 10k accelerating nodes under a root, the shape of a bullet storm.
+ * The transform propagation runs between the frames, untimed, so every frame starts with a clean dirty set.
+ */
+inline void benchmarkMovement() {
+    auto& registry = game::getRegistry();
+
+    constexpr size_t nodeCount = 10000;
+    constexpr size_t warmupFrames = 5;
+    constexpr size_t measuredFrames = 120;
+    const sf::Time deltaTime = sf::seconds(1.f / 60.f);
+
+    const auto root = registry.create();
+    game::MovementUtils::attachLayoutComponents(root);
+    game::SceneTreeUtils::attachSceneTreeComponents(root);
+
+    for (size_t i = 0; i < nodeCount; i++) {
+        const auto node = registry.create();
+        game::MovementUtils::attachLayoutComponents(node);
+        game::SceneTreeUtils::attachSceneTreeComponents(node);
+        registry.get<game::CLocalTransform>(node).setPosition(game::random({ -1024.f, -1024.f }, { 1024.f, 1024.f }));
+        registry.emplace<game::CVelocity>(node,
+            game::random({ -256.f, -256.f }, { 256.f, 256.f }),
+            game::random({ -16.f, -16.f }, { 16.f, 16.f }));
+        game::SceneTreeUtils::attachChild(root, node);
+    }
+    game::SScenePositionUpdateSystem::update();
+
+    sf::Time elapsed;
+    for (size_t frame = 0; frame < warmupFrames + measuredFrames; frame++) {
+        sf::Clock clock;
+        game::SMovementSystem::update(deltaTime);
+        if (frame >= warmupFrames) {
+            elapsed += clock.getElapsedTime();
+        }
+        game::SScenePositionUpdateSystem::update();
+    }
+
+    std::stringstream ss;
+    ss << "Movement: " << nodeCount << " moving nodes: "
+       << elapsed.asMicroseconds() / static_cast<int64_t>(measuredFrames) << " us per update";
+    game::getLogger().logInfo(ss.str());
+
+    game::SceneTreeUtils::unmount(root);
+}
+
+#endif //MOVEMENTBENCHMARKS_HPP
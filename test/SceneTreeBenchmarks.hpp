@@ -0,0 +1,80 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef SCENETREEBENCHMARKS_HPP
+#define SCENETREEBENCHMARKS_HPP
+
+#include <sstream>
+#include <vector>
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "components/Layout.hpp"
+#include "systems/SceneControl.hpp"
+#include "utils/MovementUtils.hpp"
+
+/**
+ * Moves every node under a root each frame, like mobs and bullets do,
+ * and measures SScenePositionUpdateSystem::update() with and without the thread pool.
+ * Every moving node has a child, the same as the small map indicators.
+ */
+inline void benchmarkSceneTree() {
+    auto& registry = game::getRegistry();
+
+    constexpr size_t warmupFrames = 5;
+    constexpr size_t measuredFrames = 60;
+
+    for (const size_t nodeCount : { 10000u, 25000u, 50000u, 100000u }) {
+        for (const bool parallel : { false, true }) {
+            const auto root = registry.create();
+            game::MovementUtils::attachLayoutComponents(root);
+            game::SceneTreeUtils::attachSceneTreeComponents(root);
+
+            std::vector<entt::entity> nodes;
+            nodes.reserve(nodeCount);
+            for (size_t i = 0; i < nodeCount; i++) {
+                const auto node = registry.create();
+                game::MovementUtils::attachLayoutComponents(node);
+                game::SceneTreeUtils::attachSceneTreeComponents(node);
+                registry.get<game::CLocalTransform>(node).setPosition(game::random({ -2048.f, -2048.f }, { 2048.f, 2048.f }));
+                game::SceneTreeUtils::attachChild(root, node);
+
+                const auto indicator = registry.create();
+                game::MovementUtils::attachLayoutComponents(indicator);
+                game::SceneTreeUtils::attachSceneTreeComponents(indicator);
+                game::SceneTreeUtils::attachChild(node, indicator);
+
+                nodes.push_back(node);
+            }
+
+            game::SScenePositionUpdateSystem::setParallelPropagation(parallel);
+            game::SScenePositionUpdateSystem::update();
+
+            sf::Time elapsed;
+            for (size_t frame = 0; frame < warmupFrames + measuredFrames; frame++) {
+                for (const auto node : nodes) {
+                    registry.get<game::CLocalTransform>(node).move({ 1.f, -1.f });
+                    game::SceneTreeUtils::markAsDirty(node);
+                }
+
+                sf::Clock clock;
+                game::SScenePositionUpdateSystem::update();
+                if (frame >= warmupFrames) {
+                    elapsed += clock.getElapsedTime();
+                }
+            }
+
+            std::stringstream ss;
+            ss << "Scene tree: " << nodeCount << " moving nodes, " << (parallel ? "parallel" : "serial") << ": "
+               << elapsed.asMicroseconds() / static_cast<int64_t>(measuredFrames) << " us per update";
+            game::getLogger().logInfo(ss.str());
+
+            game::SceneTreeUtils::unmount(root);
+        }
+    }
+
+    game::SScenePositionUpdateSystem::setParallelPropagation(true);
+}
+
+#endif //SCENETREEBENCHMARKS_HPP
@@ -5,10 +5,266 @@
 #ifndef SCENETREETESTS_HPP
 #define SCENETREETESTS_HPP
 
+#include <iterator>
+#include <vector>
+
+#include "Common.hpp"
+#include "TestUtils.hpp"
 #include "components/Layout.hpp"
 #include "systems/SceneControl.hpp"
+#include "utils/DirtySet.hpp"
+#include "utils/MovementUtils.hpp"
+
+namespace game::test {
+    inline entt::entity createSceneNode() {
+        const auto entity = getRegistry().create();
+        MovementUtils::attachLayoutComponents(entity);
+        SceneTreeUtils::attachSceneTreeComponents(entity);
+        return entity;
+    }
+
+    /**
+     * Detaching or reparenting the middle one of three children has to relink its siblings.
+     */
+    inline void testSceneTreeReparent() {
+        auto& registry = getRegistry();
+
+        const auto root = createSceneNode();
+        const auto a = createSceneNode();
+        const auto b = createSceneNode();
+        const auto c = createSceneNode();
+        const auto grandchild = createSceneNode();
+        SceneTreeUtils::attachChild(root, a);
+        SceneTreeUtils::attachChild(root, b);
+        SceneTreeUtils::attachChild(root, c);
+        SceneTreeUtils::attachChild(b, grandchild);
+
+        // children are prepended: c, b, a.
+        GAME_EXPECT(registry.get<CChild>(root).getFirstChild() == c);
+        GAME_EXPECT(registry.get<CParent>(b).getPreviousSibling() == c);
+        GAME_EXPECT(registry.get<CParent>(b).getNextSibling() == a);
+
+        SceneTreeUtils::attachParent(b, a);
+        GAME_EXPECT(SceneTreeUtils::isChildOf(b, a));
+        GAME_EXPECT(!SceneTreeUtils::isChildOf(b, root));
+        GAME_EXPECT(SceneTreeUtils::isChildOf(grandchild, b));
+        GAME_EXPECT(registry.get<CChild>(root).getChildCount() == 2);
+        GAME_EXPECT(registry.get<CChild>(a).getChildCount() == 1);
+        GAME_EXPECT(registry.get<CChild>(a).getFirstChild() == b);
+        GAME_EXPECT(registry.get<CParent>(c).getNextSibling() == a);
+        GAME_EXPECT(registry.get<CParent>(a).getPreviousSibling() == c);
+        GAME_EXPECT(registry.get<CParent>(b).getPreviousSibling() == entt::null);
+        GAME_EXPECT(registry.get<CParent>(b).getNextSibling() == entt::null);
+        GAME_EXPECT(SceneTreeUtils::isDirty(b) && SceneTreeUtils::isDirty(grandchild));
+
+        // back under the root: b, c, a.
+        SceneTreeUtils::attachChild(root, b);
+        GAME_EXPECT(!registry.get<CChild>(a).hasChildren());
+        GAME_EXPECT(registry.get<CChild>(root).getFirstChild() == b);
+        GAME_EXPECT(registry.get<CParent>(c).getPreviousSibling() == b);
+        GAME_EXPECT(registry.get<CParent>(c).getNextSibling() == a);
+
+        SceneTreeUtils::detachChild(root, c);
+        GAME_EXPECT(registry.get<CParent>(c).getParent() == entt::null);
+        GAME_EXPECT(registry.get<CParent>(b).getNextSibling() == a);
+        GAME_EXPECT(registry.get<CParent>(a).getPreviousSibling() == b);
+        GAME_EXPECT(registry.get<CChild>(root).getChildCount() == 2);
+
+        std::vector<entt::entity> children;
+        SceneTreeUtils::forEachChild(root, [&children](const entt::entity child) {
+            children.push_back(child);
+        });
+        GAME_EXPECT((children == std::vector { b, a }));
+
+        SScenePositionUpdateSystem::update();
+        SceneTreeUtils::unmount(root);
+        GAME_EXPECT(registry.valid(c));
+        SceneTreeUtils::unmount(c);
+        GAME_EXPECT(!registry.valid(a) && !registry.valid(b) && !registry.valid(c) && !registry.valid(grandchild));
+    }
+
+    /**
+     * A batch may hold a root together with entities of its own subtree.
+     */
+    inline void testSceneTreeBatchUnmount() {
+        auto& registry = getRegistry();
+
+        const auto root = createSceneNode();
+        const auto kept = createSceneNode();
+        const auto parent = createSceneNode();
+        const auto child = createSceneNode();
+        const auto grandchild = createSceneNode();
+        const auto sibling = createSceneNode();
+        SceneTreeUtils::attachChild(root, kept);
+        SceneTreeUtils::attachChild(root, parent);
+        SceneTreeUtils::attachChild(root, sibling);
+        SceneTreeUtils::attachChild(parent, child);
+        SceneTreeUtils::attachChild(child, grandchild);
+
+        const entt::entity roots[] { grandchild, parent, sibling, child, parent };
+        SceneTreeUtils::unmount(roots, std::size(roots));
+
+        GAME_EXPECT(!registry.valid(parent));
+        GAME_EXPECT(!registry.valid(child));
+        GAME_EXPECT(!registry.valid(grandchild));
+        GAME_EXPECT(!registry.valid(sibling));
+        GAME_EXPECT(registry.valid(root) && registry.valid(kept));
+        GAME_EXPECT(registry.get<CChild>(root).getChildCount() == 1);
+        GAME_EXPECT(registry.get<CChild>(root).getFirstChild() == kept);
+        GAME_EXPECT(registry.get<CParent>(kept).getPreviousSibling() == entt::null);
+        GAME_EXPECT(registry.get<CParent>(kept).getNextSibling() == entt::null);
+
+        // the destroyed entities are still in the dirty set until the next update.
+        SScenePositionUpdateSystem::update();
+        GAME_EXPECT(SceneTreeUtils::getDirtySet().empty());
+
+        SceneTreeUtils::unmount(root);
+        GAME_EXPECT(!registry.valid(root) && !registry.valid(kept));
+    }
+
+    inline void testDirtySetRecycledIndex() {
+        auto& registry = getRegistry();
+        DirtySet dirtySet;
+
+        const auto old = registry.create();
+        const auto other = registry.create();
+        GAME_EXPECT(dirtySet.insert(old));
+        GAME_EXPECT(!dirtySet.insert(old));
+        GAME_EXPECT(dirtySet.insert(other));
+
+        registry.destroy(old);
+        const auto recycled = registry.create();
+        GAME_EXPECT(entt::to_entity(recycled) == entt::to_entity(old));
+        GAME_EXPECT(recycled != old);
+
+        GAME_EXPECT(dirtySet.contains(old));
+        GAME_EXPECT(!dirtySet.contains(recycled));
+        GAME_EXPECT(!dirtySet.erase(recycled));
+
+        // takes the place of its predecessor.
+        GAME_EXPECT(dirtySet.insert(recycled));
+        GAME_EXPECT(dirtySet.size() == 2);
+        GAME_EXPECT(!dirtySet.contains(old));
+        GAME_EXPECT(dirtySet.contains(recycled));
+
+        registry.destroy(other);
+        dirtySet.retain([&registry](const entt::entity entity) {
+            return registry.valid(entity);
+        });
+        GAME_EXPECT(dirtySet.size() == 1);
+        GAME_EXPECT(dirtySet.getEntities().front() == recycled);
+        GAME_EXPECT(!dirtySet.contains(other));
+
+        GAME_EXPECT(dirtySet.erase(recycled));
+        GAME_EXPECT(dirtySet.empty());
+        GAME_EXPECT(!dirtySet.contains(recycled));
+
+        registry.destroy(recycled);
+    }
+
+    /**
+     * Builds the same deep tree twice, computes one serially and the other on the thread pool,
+     * and compares the global transforms node by node.
+     */
+    inline void testSceneTreeParallelPropagation() {
+        auto& registry = getRegistry();
+
+        constexpr size_t groupCount = 8;
+        // well above PARALLEL_MIN_SUBTREES, and several batches of PARALLEL_BATCH_SIZE.
+        constexpr size_t subtreesPerGroup = 64;
+        constexpr size_t chainLength = 3;
+        constexpr size_t leavesPerChain = 2;
+
+        struct NodeParams {
+            sf::Vector2f position;
+            sf::Vector2f scale;
+            sf::Angle rotation;
+        };
+
+        std::vector<NodeParams> params;
+        const auto nextParams = [&params](const size_t index) {
+            if (index == params.size()) {
+                params.push_back({
+                    random({ -256.f, -256.f }, { 256.f, 256.f }),
+                    random({ 0.5f, 0.5f }, { 1.5f, 1.5f }),
+                    sf::degrees(random(-180.f, 180.f))
+                });
+            }
+            return params[index];
+        };
+
+        const auto buildTree = [&registry, &nextParams](std::vector<entt::entity>& nodes) {
+            nodes.clear();
+            const auto createNode = [&](const entt::entity parent) {
+                const auto node = createSceneNode();
+                const auto [position, scale, rotation] = nextParams(nodes.size());
+                auto& localTransform = registry.get<CLocalTransform>(node);
+                localTransform.setPosition(position);
+                localTransform.setScale(scale);
+                localTransform.setRotation(rotation);
+                if (parent != entt::null) {
+                    SceneTreeUtils::attachChild(parent, node);
+                }
+                nodes.push_back(node);
+                return node;
+            };
+
+            const auto root = createNode(entt::null);
+            for (size_t group = 0; group < groupCount; group++) {
+                const auto groupNode = createNode(root);
+                for (size_t subtree = 0; subtree < subtreesPerGroup; subtree++) {
+                    auto node = createNode(groupNode);
+                    for (size_t depth = 0; depth < chainLength; depth++) {
+                        node = createNode(node);
+                    }
+                    for (size_t leaf = 0; leaf < leavesPerChain; leaf++) {
+                        createNode(node);
+                    }
+                }
+            }
+            return root;
+        };
+
+        // whatever an earlier test left behind.
+        SScenePositionUpdateSystem::update();
+
+        std::vector<entt::entity> serialNodes;
+        const auto serialRoot = buildTree(serialNodes);
+        SScenePositionUpdateSystem::setParallelPropagation(false);
+        SScenePositionUpdateSystem::update();
+
+        std::vector<entt::entity> parallelNodes;
+        const auto parallelRoot = buildTree(parallelNodes);
+        SScenePositionUpdateSystem::setParallelPropagation(true);
+        SScenePositionUpdateSystem::update();
+        GAME_EXPECT(SceneTreeUtils::getDirtySet().empty());
+
+        GAME_EXPECT(serialNodes.size() == parallelNodes.size());
+        for (size_t i = 0; i < serialNodes.size(); i++) {
+            const auto& serial = registry.get<CGlobalTransform>(serialNodes[i]);
+            const auto& parallel = registry.get<CGlobalTransform>(parallelNodes[i]);
+            GAME_EXPECT(serial.getPosition() == parallel.getPosition());
+            GAME_EXPECT(serial.getScale() == parallel.getScale());
+            GAME_EXPECT(serial.getRotation() == parallel.getRotation());
+            GAME_EXPECT(serial.getOrigin() == parallel.getOrigin());
+            GAME_EXPECT(serial.getAffine() == parallel.getAffine());
+        }
+
+        // a deep node really composes its ancestors.
+        GAME_EXPECT(registry.get<CGlobalTransform>(serialNodes.back()).getRotation() !=
+                    registry.get<CLocalTransform>(serialNodes.back()).getRotation());
+
+        SceneTreeUtils::unmount(serialRoot);
+        SceneTreeUtils::unmount(parallelRoot);
+        SScenePositionUpdateSystem::update();
+    }
+} // game::test
 
 inline void testSceneTree() {
+    game::test::testSceneTreeReparent();
+    game::test::testSceneTreeBatchUnmount();
+    game::test::testDirtySetRecycledIndex();
+    game::test::testSceneTreeParallelPropagation();
 }
 
 #endif //SCENETREETESTS_HPP
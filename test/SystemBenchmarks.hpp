@@ -0,0 +1,118 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/29
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef SYSTEMBENCHMARKS_HPP
+#define SYSTEMBENCHMARKS_HPP
+
+#include <sstream>
+#include <vector>
+
+#include "Common.hpp"
+#include "Logger.hpp"
+#include "components/Render.hpp"
+#include "prefabs/Bullet.hpp"
+#include "prefabs/Mob.hpp"
+#include "SFML/Graphics/RenderTexture.hpp"
+#include "SFML/Graphics/View.hpp"
+#include "SFML/System/Angle.hpp"
+#include "systems/CollisionControl.hpp"
+#include "systems/MovementControl.hpp"
+#include "systems/RenderControl.hpp"
+#include "systems/SceneControl.hpp"
+#include "utils/MovementUtils.hpp"
+
+/**
+ * Spawns bullets and mobs the way a stage does, and measures the systems running over their groups:
+ * SMovementSystem::update(), SCollisionSystem::update() and SRenderSystem::update() into an offscreen target.
+ * The transform propagation runs between them, untimed.
+ */
+inline void benchmarkSystems() {
+    auto& registry = game::getRegistry();
+
+    constexpr size_t warmupFrames = 5;
+    constexpr size_t measuredFrames = 60;
+    const sf::Time deltaTime = sf::seconds(1.f / 60.f);
+
+    sf::RenderTexture target({ 1280u, 720u });
+    target.setView(sf::View({ 0.f, 0.f }, { 2048.f, 2048.f }));
+
+    struct Scale {
+        size_t bulletCount;
+        size_t mobCount;
+    };
+
+    for (const auto [bulletCount, mobCount] : { Scale { 1000, 50 }, Scale { 5000, 250 } }) {
+        const auto root = registry.create();
+        game::MovementUtils::attachLayoutComponents(root);
+        game::SceneTreeUtils::attachSceneTreeComponents(root);
+
+        std::vector<entt::entity> spawned;
+        spawned.reserve(bulletCount + mobCount);
+        for (size_t i = 0; i < bulletCount; i++) {
+            const auto position = game::random({ -1024.f, -1024.f }, { 1024.f, 1024.f });
+            const sf::Vector2f direction(1.f, sf::degrees(game::random(0.f, 360.f)));
+            const auto bullet = game::prefab::Bullet::create(position, direction, game::random(100.f, 200.f)).getEntity();
+            game::SceneTreeUtils::attachChild(root, bullet);
+            spawned.push_back(bullet);
+        }
+
+        std::vector<sf::Vector2f> positions(mobCount);
+        for (auto& position : positions) {
+            position = game::random({ -1024.f, -1024.f }, { 1024.f, 1024.f });
+        }
+        for (const auto mob : game::prefab::Mob::createBatch(positions)) {
+            game::SceneTreeUtils::attachChild(root, mob);
+            spawned.push_back(mob);
+        }
+        game::SScenePositionUpdateSystem::update();
+
+        sf::Time movement;
+        sf::Time collision;
+        sf::Time render;
+        for (size_t frame = 0; frame < warmupFrames + measuredFrames; frame++) {
+            const bool measured = frame >= warmupFrames;
+
+            sf::Clock clock;
+            game::SMovementSystem::update(deltaTime);
+            if (measured) {
+                movement += clock.getElapsedTime();
+            }
+
+            game::SScenePositionUpdateSystem::update();
+
+            clock.restart();
+            game::SCollisionSystem::update(deltaTime);
+            if (measured) {
+                collision += clock.getElapsedTime();
+            }
+
+            target.clear();
+            clock.restart();
+            game::SRenderSystem::update(target, game::CRenderTargetComponent::GameComponent, deltaTime);
+            target.display();
+            if (measured) {
+                render += clock.getElapsedTime();
+            }
+        }
+
+        const auto perFrame = [](const sf::Time time) {
+            return time.asMicroseconds() / static_cast<int64_t>(measuredFrames);
+        };
+        std::stringstream ss;
+        ss << "Systems: " << bulletCount << " bullets, " << mobCount << " mobs: "
+           << "movement " << perFrame(movement) << " us, "
+           << "collision " << perFrame(collision) << " us, "
+           << "render " << perFrame(render) << " us per update";
+        game::getLogger().logInfo(ss.str());
+
+        // the bullets go back to their pool, like at the end of a stage.
+        for (const auto entity : spawned) {
+            game::UnmountUtils::queueUnmount(entity);
+        }
+        game::SSceneUnmountSystem::update();
+        game::SceneTreeUtils::unmount(root);
+    }
+}
+
+#endif //SYSTEMBENCHMARKS_HPP
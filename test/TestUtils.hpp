@@ -0,0 +1,42 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TESTUTILS_HPP
+#define TESTUTILS_HPP
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Fails the running test with the location and the text of the condition.
+ */
+#define GAME_EXPECT(condition) game::test::expect((condition), #condition, __FILE__, __LINE__)
+
+/**
+ * Fails the running test unless the statement throws the given exception type.
+ */
+#define GAME_EXPECT_THROWS(statement, exception) \
+    do { \
+        bool thrown = false; \
+        try { statement; } catch (const exception&) { thrown = true; } \
+        game::test::expect(thrown, #statement " throws " #exception, __FILE__, __LINE__); \
+    } while (false)
+
+/**
+ * Fails the running test unless the two floats are at most tolerance apart.
+ */
+#define GAME_EXPECT_NEAR(actual, expected, tolerance) \
+    game::test::expect(std::abs((actual) - (expected)) <= (tolerance), \
+        #actual " near " #expected, __FILE__, __LINE__)
+
+namespace game::test {
+    inline void expect(const bool condition, const char* text, const char* file, const int line) {
+        if (!condition) {
+            throw std::runtime_error(std::string(file) + ":" + std::to_string(line) + ": expected " + text);
+        }
+    }
+} // game::test
+
+#endif //TESTUTILS_HPP
@@ -0,0 +1,199 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TILEMAPTESTS_HPP
+#define TILEMAPTESTS_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "TestUtils.hpp"
+#include "SFML/Graphics/Image.hpp"
+#include "utils/TileMapConverter.hpp"
+#include "utils/TileMapFile.hpp"
+
+namespace game::test {
+    inline std::vector<char> readTileMapBytes(const std::string& path) {
+        std::ifstream stream(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    inline void writeTileMapBytes(const std::string& path, const std::vector<char>& bytes) {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    inline void patchTileMapHeader(std::vector<char>& bytes, const size_t offset, const uint32_t value) {
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    /**
+     * @return every tile of the map, decoded chunk by chunk
+     */
+    inline std::vector<SingleTileItem> decodeTileMap(const TileMapFile& mapFile) {
+        std::vector<SingleTileItem> tileItems;
+        const auto chunkRange = mapFile.getChunkRange();
+        for (int32_t y = chunkRange.position.y; y < chunkRange.position.y + chunkRange.size.y; y++) {
+            for (int32_t x = chunkRange.position.x; x < chunkRange.position.x + chunkRange.size.x; x++) {
+                GAME_EXPECT(mapFile.decodeChunk({ x, y }, tileItems));
+            }
+        }
+        return tileItems;
+    }
+}
+
+/**
+ * TileMapFile::write() -> TileMapFile -> decodeChunk(), the converter, and the checks against corrupt files.
+ */
+inline void testTileMap() {
+    using game::TileMapFile;
+    using game::TileIdType;
+
+    const auto path = (std::filesystem::temp_directory_path() / "game25sp-test.gtmp").string();
+    const auto corruptPath = (std::filesystem::temp_directory_path() / "game25sp-test-corrupt.gtmp").string();
+
+    const std::string texturePath = "assets/image/tiles.png";
+    const std::vector<TileMapFile::PaletteEntry> palette {
+        { 1, { { texturePath, sf::IntRect { { 0, 0 }, { 16, 16 } }, sf::Time::Zero } } },
+        { 7, {
+            { texturePath, sf::IntRect { { 16, 0 }, { 16, 16 } }, sf::milliseconds(100) },
+            { texturePath, sf::IntRect { { 32, 0 }, { 16, 16 } }, sf::milliseconds(150) }
+        } },
+    };
+    // crosses the chunk borders on both axes, on both sides of the origin.
+    const sf::IntRect tileRange { { -40, -8 }, { 64, 48 } };
+    const auto tileAt = [](const sf::Vector2i tile) -> TileIdType {
+        if ((tile.x + tile.y) % 3 == 0) {
+            return TileMapFile::EMPTY_TILE;
+        }
+        return (tile.x & 1) != 0 ? 1 : 7;
+    };
+
+    // round trip.
+    TileMapFile::write(path, { 16, 16 }, palette, tileRange, tileAt);
+    {
+        const TileMapFile mapFile(path);
+        GAME_EXPECT(mapFile.getTileSize() == sf::Vector2u(16, 16));
+        GAME_EXPECT(mapFile.getChunkRange() == sf::IntRect({ -2, -1 }, { 3, 3 }));
+
+        const auto& readPalette = mapFile.getPalette();
+        GAME_EXPECT(readPalette.size() == palette.size());
+        for (size_t i = 0; i < palette.size(); i++) {
+            GAME_EXPECT(readPalette[i].tileId == palette[i].tileId);
+            GAME_EXPECT(readPalette[i].frames.size() == palette[i].frames.size());
+            for (size_t j = 0; j < palette[i].frames.size(); j++) {
+                GAME_EXPECT(readPalette[i].frames[j].texturePath == palette[i].frames[j].texturePath);
+                GAME_EXPECT(readPalette[i].frames[j].textureRect == palette[i].frames[j].textureRect);
+                GAME_EXPECT(readPalette[i].frames[j].duration == palette[i].frames[j].duration);
+            }
+        }
+
+        size_t expectedCount = 0;
+        for (int32_t y = tileRange.position.y; y < tileRange.position.y + tileRange.size.y; y++) {
+            for (int32_t x = tileRange.position.x; x < tileRange.position.x + tileRange.size.x; x++) {
+                expectedCount += tileAt({ x, y }) != TileMapFile::EMPTY_TILE;
+            }
+        }
+        const auto tileItems = game::test::decodeTileMap(mapFile);
+        GAME_EXPECT(tileItems.size() == expectedCount);
+        for (const auto& tileItem : tileItems) {
+            GAME_EXPECT(tileRange.contains(tileItem.tilePlacement));
+            GAME_EXPECT(tileItem.tileId == tileAt(tileItem.tilePlacement));
+            GAME_EXPECT(tileItem.tileSize == sf::Vector2i(1, 1));
+        }
+
+        // outside of the map, nothing to decode.
+        std::vector<game::SingleTileItem> outside;
+        GAME_EXPECT(mapFile.decodeChunk({ 5, 5 }, outside));
+        GAME_EXPECT(outside.empty());
+    }
+
+    // corrupt headers, every one of them has to be refused with a runtime_error, nothing else.
+    const auto bytes = game::test::readTileMapBytes(path);
+    const auto expectCorrupt = [&corruptPath](const std::vector<char>& corrupt) {
+        game::test::writeTileMapBytes(corruptPath, corrupt);
+        GAME_EXPECT_THROWS(TileMapFile { corruptPath }, std::runtime_error);
+    };
+    {
+        auto corrupt = bytes;
+        corrupt[0] = 'X';
+        expectCorrupt(corrupt);
+    }
+    {
+        // chunks x.
+        auto corrupt = bytes;
+        game::test::patchTileMapHeader(corrupt, 28, UINT32_MAX);
+        expectCorrupt(corrupt);
+    }
+    {
+        // both chunk counts within the limit, but the table runs past the end of the file.
+        auto corrupt = bytes;
+        game::test::patchTileMapHeader(corrupt, 28, TileMapFile::MAX_CHUNKS_PER_AXIS);
+        game::test::patchTileMapHeader(corrupt, 32, TileMapFile::MAX_CHUNKS_PER_AXIS);
+        expectCorrupt(corrupt);
+    }
+    {
+        // palette size, must not be reserved as it is.
+        auto corrupt = bytes;
+        game::test::patchTileMapHeader(corrupt, 36, UINT32_MAX);
+        expectCorrupt(corrupt);
+    }
+    {
+        // the last chunk is cut short.
+        auto corrupt = bytes;
+        corrupt.pop_back();
+        expectCorrupt(corrupt);
+    }
+    {
+        auto corrupt = bytes;
+        corrupt.resize(20);
+        expectCorrupt(corrupt);
+    }
+
+    // a tile id the palette does not know: the file opens, the chunk is refused and the output left alone.
+    TileMapFile::write(corruptPath, { 16, 16 }, { palette.front() }, sf::IntRect { { 0, 0 }, { 4, 4 } },
+        [](const sf::Vector2i tile) -> TileIdType { return tile == sf::Vector2i(2, 3) ? 2 : 1; });
+    {
+        const TileMapFile mapFile(corruptPath);
+        std::vector<game::SingleTileItem> tileItems { { 1, { 0, 0 }, { 1, 1 } } };
+        GAME_EXPECT(!mapFile.decodeChunk({ 0, 0 }, tileItems));
+        GAME_EXPECT(tileItems.size() == 1);
+    }
+
+    // the converter: equal tiles share an entry, transparent ones stay empty.
+    sf::Image image({ 64, 32 }, sf::Color::Transparent);
+    for (uint32_t y = 0; y < 16; y++) {
+        for (uint32_t x = 0; x < 48; x++) {
+            image.setPixel({ x, y }, x < 32 ? sf::Color::Red : sf::Color::Blue);
+        }
+    }
+    GAME_EXPECT(game::TileMapConverter::convert(image, texturePath, { 16, 16 }, path) == 2);
+    {
+        const TileMapFile mapFile(path);
+        GAME_EXPECT(mapFile.getTileSize() == sf::Vector2u(16, 16));
+        GAME_EXPECT(mapFile.getPalette().size() == 2);
+        GAME_EXPECT(mapFile.getPalette()[1].frames.front().textureRect == sf::IntRect({ 32, 0 }, { 16, 16 }));
+
+        auto tileItems = game::test::decodeTileMap(mapFile);
+        GAME_EXPECT(tileItems.size() == 3);
+        std::sort(tileItems.begin(), tileItems.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.tilePlacement.x < rhs.tilePlacement.x;
+        });
+        // 4x2 tiles, centered on the origin.
+        GAME_EXPECT(tileItems[0].tilePlacement == sf::Vector2i(-2, -1));
+        GAME_EXPECT(tileItems[1].tilePlacement == sf::Vector2i(-1, -1));
+        GAME_EXPECT(tileItems[2].tilePlacement == sf::Vector2i(0, -1));
+        GAME_EXPECT(tileItems[0].tileId == tileItems[1].tileId);
+        GAME_EXPECT(tileItems[0].tileId != tileItems[2].tileId);
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(corruptPath);
+}
+
+#endif //TILEMAPTESTS_HPP
@@ -0,0 +1,172 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TIMELINETESTS_HPP
+#define TIMELINETESTS_HPP
+
+#include "Common.hpp"
+#include "TestUtils.hpp"
+#include "components/Tweening.hpp"
+#include "utils/TweenEngine.hpp"
+
+namespace game::test {
+    struct CTweenProbe {
+        float value { 0.f };
+    };
+
+    inline size_t completedTimelineCount = 0;
+
+    inline void countCompletedTimeline(entt::entity) {
+        completedTimelineCount++;
+    }
+
+    inline entt::entity createTweenProbe() {
+        auto& registry = getRegistry();
+        const auto entity = registry.create();
+        registry.emplace<CTweenProbe>(entity);
+        return entity;
+    }
+
+    inline float getProbeValue(const entt::entity entity) {
+        return getRegistry().get<CTweenProbe>(entity).value;
+    }
+
+    inline void testTimelineYoyo() {
+        auto& registry = getRegistry();
+        TweenEngine engine;
+        completedTimelineCount = 0;
+
+        const auto owner = createTweenProbe();
+        const auto spec = TweenSpec()
+            .bind<&CTweenProbe::value>()
+            .setRange(0.f, 8.f)
+            .setDuration(sf::seconds(1.f));
+
+        // forwards, backwards, then forwards again.
+        const auto handle = engine.play(Timeline(owner)
+            .then(spec)
+            .setRepeat(2)
+            .setYoyo(true)
+            .setCompletionCallback<&countCompletedTimeline>());
+
+        engine.update(sf::seconds(0.5f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 4.f, 1e-5f);
+        engine.update(sf::seconds(0.75f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 6.f, 1e-5f);
+        engine.update(sf::seconds(1.f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 2.f, 1e-5f);
+        GAME_EXPECT(engine.isPlaying(handle));
+        GAME_EXPECT(completedTimelineCount == 0);
+
+        engine.update(sf::seconds(1.f));
+        GAME_EXPECT(getProbeValue(owner) == 8.f);
+        GAME_EXPECT(!engine.isPlaying(handle));
+        GAME_EXPECT(completedTimelineCount == 1);
+
+        registry.destroy(owner);
+    }
+
+    /**
+     * Steps in parallel and a trailing wait, played twice from the start.
+     */
+    inline void testTimelineRepeat() {
+        auto& registry = getRegistry();
+        TweenEngine engine;
+        completedTimelineCount = 0;
+
+        const auto owner = createTweenProbe();
+        const auto other = createTweenProbe();
+        const auto handle = engine.play(Timeline(owner)
+            .then(TweenSpec().bind<&CTweenProbe::value>().setRange(0.f, 8.f).setDuration(sf::seconds(1.f)))
+            .with(other, TweenSpec().bind<&CTweenProbe::value>().setRange(10.f, 20.f).setDuration(sf::seconds(0.5f)))
+            .wait(sf::seconds(0.5f))
+            .setRepeat(1)
+            .setCompletionCallback<&countCompletedTimeline>());
+
+        engine.update(sf::seconds(0.25f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 2.f, 1e-5f);
+        GAME_EXPECT_NEAR(getProbeValue(other), 15.f, 1e-5f);
+
+        // the shorter step lands on its end, even when the frame passes over it.
+        engine.update(sf::seconds(0.5f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 6.f, 1e-5f);
+        GAME_EXPECT(getProbeValue(other) == 20.f);
+
+        // in the wait.
+        engine.update(sf::seconds(0.5f));
+        GAME_EXPECT(getProbeValue(owner) == 8.f);
+
+        // the second play starts over.
+        engine.update(sf::seconds(0.5f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 2.f, 1e-5f);
+        GAME_EXPECT_NEAR(getProbeValue(other), 15.f, 1e-5f);
+        GAME_EXPECT(engine.isPlaying(handle));
+
+        engine.update(sf::seconds(1.5f));
+        GAME_EXPECT(getProbeValue(owner) == 8.f);
+        GAME_EXPECT(getProbeValue(other) == 20.f);
+        GAME_EXPECT(!engine.isPlaying(handle));
+        GAME_EXPECT(completedTimelineCount == 1);
+
+        // played for ever, until it is stopped or its owner is gone.
+        auto endless = engine.play(Timeline(owner)
+            .then(TweenSpec().bind<&CTweenProbe::value>().setRange(0.f, 8.f).setDuration(sf::seconds(1.f)))
+            .setRepeat(-1)
+            .setCompletionCallback<&countCompletedTimeline>());
+        for (size_t frame = 0; frame < 600; frame++) {
+            engine.update(sf::seconds(1.f / 60.f));
+        }
+        GAME_EXPECT(engine.isPlaying(endless));
+        GAME_EXPECT(engine.stop(endless));
+        GAME_EXPECT(endless.index == TimelineHandle::INVALID_INDEX);
+
+        const auto orphaned = engine.play(Timeline(owner)
+            .then(TweenSpec().bind<&CTweenProbe::value>().setRange(0.f, 8.f).setDuration(sf::seconds(1.f)))
+            .setRepeat(-1)
+            .setCompletionCallback<&countCompletedTimeline>());
+        registry.destroy(owner);
+        engine.update(sf::seconds(0.1f));
+        GAME_EXPECT(!engine.isPlaying(orphaned));
+        GAME_EXPECT(completedTimelineCount == 1);
+
+        registry.destroy(other);
+    }
+
+    /**
+     * The handles given out before clear() must not match the timelines played after it.
+     */
+    inline void testTimelineClear() {
+        auto& registry = getRegistry();
+        TweenEngine engine;
+
+        const auto owner = createTweenProbe();
+        const auto timeline = Timeline(owner)
+            .then(TweenSpec().bind<&CTweenProbe::value>().setRange(0.f, 8.f).setDuration(sf::seconds(1.f)));
+
+        const auto stale = engine.play(timeline);
+        engine.clear();
+        GAME_EXPECT(!engine.isPlaying(stale));
+        GAME_EXPECT(engine.getPlayingCount() == 0);
+
+        const auto fresh = engine.play(timeline);
+        GAME_EXPECT(fresh.index == stale.index);
+        GAME_EXPECT(fresh.generation != stale.generation);
+        auto staleCopy = stale;
+        GAME_EXPECT(!engine.stop(staleCopy));
+        GAME_EXPECT(engine.isPlaying(fresh));
+
+        engine.update(sf::seconds(0.5f));
+        GAME_EXPECT_NEAR(getProbeValue(owner), 4.f, 1e-5f);
+
+        registry.destroy(owner);
+    }
+} // game::test
+
+inline void testTimelines() {
+    game::test::testTimelineYoyo();
+    game::test::testTimelineRepeat();
+    game::test::testTimelineClear();
+}
+
+#endif //TIMELINETESTS_HPP
@@ -0,0 +1,159 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TIMERWHEELTESTS_HPP
+#define TIMERWHEELTESTS_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Common.hpp"
+#include "TestUtils.hpp"
+#include "utils/TimerWheel.hpp"
+
+namespace game::test {
+    /**
+     * Timers on both sides of every level boundary, and beyond the range of the wheel,
+     * fire on their exact tick, whatever tick the wheel is at when they are scheduled.
+     */
+    inline void testTimerWheelCascade(const int64_t startTick) {
+        TimerWheel wheel;
+        wheel.advance(sf::milliseconds(startTick));
+
+        // in ticks, ascending.
+        const std::vector<int64_t> delays {
+            1, 2, 63, 64, 65,
+            4095, 4096, 4097,
+            262143, 262144, 262145,
+            16777215, 16777216, 16777217, 16777216 + 4096 + 3
+        };
+
+        std::vector<size_t> fired(delays.size(), 0);
+        std::vector<TimerHandle> handles;
+        for (size_t i = 0; i < delays.size(); i++) {
+            handles.push_back(wheel.schedule(sf::milliseconds(delays[i]), [&fired, i](entt::entity) {
+                fired[i]++;
+            }));
+        }
+        GAME_EXPECT(wheel.getPendingCount() == delays.size());
+
+        int64_t elapsed = 0;
+        for (size_t i = 0; i < delays.size(); i++) {
+            wheel.advance(sf::milliseconds(delays[i] - 1 - elapsed));
+            GAME_EXPECT(fired[i] == 0);
+            GAME_EXPECT(wheel.isPending(handles[i]));
+            GAME_EXPECT(wheel.getRemaining(handles[i]) == TimerWheel::TICK);
+            if (i > 0) {
+                GAME_EXPECT(fired[i - 1] == 1);
+            }
+
+            wheel.advance(TimerWheel::TICK);
+            elapsed = delays[i];
+            GAME_EXPECT(fired[i] == 1);
+            GAME_EXPECT(!wheel.isPending(handles[i]));
+        }
+        GAME_EXPECT(wheel.getPendingCount() == 0);
+        GAME_EXPECT(wheel.getTime() == sf::milliseconds(startTick + delays.back()));
+    }
+
+    inline void testTimerWheelCancel() {
+        auto& registry = getRegistry();
+        TimerWheel wheel;
+
+        size_t firstFired = 0;
+        size_t secondFired = 0;
+        auto first = wheel.schedule(sf::milliseconds(10), [&firstFired](entt::entity) { firstFired++; });
+        auto second = wheel.schedule(sf::milliseconds(10), [&secondFired](entt::entity) { secondFired++; });
+        // far away, cancelled while it sits in an upper level.
+        auto far = wheel.schedule(sf::seconds(100.f), [&firstFired](entt::entity) { firstFired++; });
+
+        GAME_EXPECT(wheel.cancel(first));
+        GAME_EXPECT(first.index == TimerHandle::INVALID_INDEX);
+        GAME_EXPECT(!wheel.cancel(first));
+        GAME_EXPECT(wheel.cancel(far));
+        GAME_EXPECT(wheel.isPending(second));
+        GAME_EXPECT(wheel.getPendingCount() == 1);
+
+        wheel.advance(sf::milliseconds(10));
+        GAME_EXPECT(firstFired == 0);
+        GAME_EXPECT(secondFired == 1);
+        GAME_EXPECT(!wheel.cancel(second));
+
+        // a callback schedules the next timer, which fires on the following tick.
+        size_t chained = 0;
+        wheel.schedule(sf::milliseconds(5), [&wheel, &chained](entt::entity) {
+            chained++;
+            wheel.schedule(TimerWheel::TICK, [&chained](entt::entity) { chained++; });
+        });
+        wheel.advance(sf::milliseconds(5));
+        GAME_EXPECT(chained == 1);
+        wheel.advance(TimerWheel::TICK);
+        GAME_EXPECT(chained == 2);
+
+        // a repeating timer cancels itself from its callback.
+        size_t repeated = 0;
+        TimerHandle repeating;
+        repeating = wheel.scheduleRepeating(sf::milliseconds(10), [&wheel, &repeated, &repeating](entt::entity) {
+            if (++repeated == 5) {
+                wheel.cancel(repeating);
+            }
+        });
+        wheel.advance(sf::milliseconds(35));
+        GAME_EXPECT(repeated == 3);
+        wheel.advance(sf::seconds(1.f));
+        GAME_EXPECT(repeated == 5);
+        GAME_EXPECT(!wheel.isPending(repeating));
+
+        // dropped once its entity is gone.
+        size_t boundFired = 0;
+        const auto entity = registry.create();
+        const auto bound = wheel.schedule(sf::milliseconds(5), [&boundFired](entt::entity) { boundFired++; }, entity);
+        registry.destroy(entity);
+        wheel.advance(sf::milliseconds(5));
+        GAME_EXPECT(boundFired == 0);
+        GAME_EXPECT(!wheel.isPending(bound));
+        GAME_EXPECT(wheel.getPendingCount() == 0);
+    }
+
+    /**
+     * The handles given out before clear() must not match the timers scheduled after it.
+     */
+    inline void testTimerWheelClear() {
+        TimerWheel wheel;
+
+        size_t staleFired = 0;
+        size_t freshFired = 0;
+        wheel.scheduleRepeating(sf::seconds(5.f), [&staleFired](entt::entity) { staleFired++; });
+        // the last one scheduled is the first one reused.
+        auto stale = wheel.schedule(sf::milliseconds(5), [&staleFired](entt::entity) { staleFired++; });
+
+        wheel.clear();
+        GAME_EXPECT(!wheel.isPending(stale));
+        GAME_EXPECT(wheel.getPendingCount() == 0);
+
+        const auto fresh = wheel.schedule(sf::milliseconds(5), [&freshFired](entt::entity) { freshFired++; });
+        GAME_EXPECT(fresh.index == stale.index);
+        GAME_EXPECT(fresh.generation != stale.generation);
+        GAME_EXPECT(!wheel.isPending(stale));
+        GAME_EXPECT(wheel.getRemaining(stale) == sf::Time::Zero);
+
+        auto staleCopy = stale;
+        GAME_EXPECT(!wheel.cancel(staleCopy));
+        GAME_EXPECT(wheel.isPending(fresh));
+
+        wheel.advance(sf::seconds(10.f));
+        GAME_EXPECT(freshFired == 1);
+        GAME_EXPECT(staleFired == 0);
+    }
+} // game::test
+
+inline void testTimerWheel() {
+    game::test::testTimerWheelCascade(0);
+    // the slots are not aligned with the delays any more.
+    game::test::testTimerWheelCascade(12345);
+    game::test::testTimerWheelCancel();
+    game::test::testTimerWheelClear();
+}
+
+#endif //TIMERWHEELTESTS_HPP
@@ -0,0 +1,152 @@
+// Game - NWPU C++ sp25
+// Created on 2025/5/30
+// by konakona418 (https://github.com/konakona418)
+
+#ifndef TWEENTESTS_HPP
+#define TWEENTESTS_HPP
+
+#include <algorithm>
+#include <vector>
+
+#include "Common.hpp"
+#include "TestUtils.hpp"
+#include "components/Layout.hpp"
+#include "components/Tweening.hpp"
+#include "systems/SceneControl.hpp"
+#include "utils/MovementUtils.hpp"
+#include "utils/TweenEngine.hpp"
+
+namespace game::test {
+    inline size_t completedTweenCount = 0;
+
+    inline void countCompletedTween(entt::entity) {
+        completedTweenCount++;
+    }
+
+    inline entt::entity createTweenTarget() {
+        const auto entity = getRegistry().create();
+        MovementUtils::attachLayoutComponents(entity);
+        SceneTreeUtils::attachSceneTreeComponents(entity);
+        return entity;
+    }
+
+    /**
+     * Every pool eased in one batch has to give the same values as EasingFunction,
+     * for the lanes of the sse2 loop as well as for the tail that does not fill a register.
+     */
+    inline void testTweenEasing() {
+        auto& registry = getRegistry();
+        TweenEngine engine;
+
+        // two registers and a tail of three per pool.
+        constexpr size_t tweensPerEasing = 11;
+
+        struct Expected {
+            entt::entity entity;
+            Easing easing;
+            float delay;
+            float inverseDuration;
+        };
+        std::vector<Expected> expected;
+
+        for (size_t easing = 0; easing < static_cast<size_t>(Easing::Count); easing++) {
+            for (size_t i = 0; i < tweensPerEasing; i++) {
+                const auto entity = createTweenTarget();
+                const auto duration = sf::seconds(0.25f + 0.1f * static_cast<float>(i));
+                const auto delay = sf::seconds(0.05f * static_cast<float>(i % 3));
+
+                engine.start(entity, TweenSpec()
+                    .setTarget(TweenTarget::Position)
+                    .setEasing(static_cast<Easing>(easing))
+                    .setRange({ 0.f, 0.f }, { 1.f, -1.f })
+                    .setDuration(duration)
+                    .setDelay(delay)
+                    .setCompletionCallback<&countCompletedTween>());
+
+                expected.push_back({ entity, static_cast<Easing>(easing), delay.asSeconds(), 1.f / duration.asSeconds() });
+            }
+        }
+        GAME_EXPECT(engine.getRunningCount() == expected.size());
+
+        completedTweenCount = 0;
+        const auto step = sf::seconds(1.f / 60.f);
+        float elapsed = 0.f;
+        // the longest tween ends after 1.3s.
+        for (size_t frame = 0; frame < 90; frame++) {
+            engine.update(step);
+            elapsed += step.asSeconds();
+
+            for (const auto& tween : expected) {
+                const auto progress = std::clamp((elapsed - tween.delay) * tween.inverseDuration, 0.f, 1.f);
+                const auto value = EasingFunction::evaluate(tween.easing, progress);
+                const auto position = registry.get<CLocalTransform>(tween.entity).getPosition();
+                GAME_EXPECT_NEAR(position.x, value, 1e-5f);
+                GAME_EXPECT_NEAR(position.y, -value, 1e-5f);
+            }
+        }
+
+        GAME_EXPECT(engine.getRunningCount() == 0);
+        GAME_EXPECT(completedTweenCount == expected.size());
+
+        for (const auto& tween : expected) {
+            SceneTreeUtils::unmount(tween.entity);
+        }
+        SScenePositionUpdateSystem::update();
+    }
+
+    inline void testTweenStop() {
+        auto& registry = getRegistry();
+        TweenEngine engine;
+
+        const auto entity = createTweenTarget();
+        const auto spec = TweenSpec()
+            .setTarget(TweenTarget::Position)
+            .setRange({ 0.f, 0.f }, { 10.f, 0.f })
+            .setDuration(sf::seconds(0.1f))
+            .setCompletionCallback<&countCompletedTween>();
+        completedTweenCount = 0;
+
+        // stopped where it is, without the completion callback.
+        auto stopped = engine.start(entity, spec);
+        engine.update(sf::seconds(0.05f));
+        GAME_EXPECT(engine.stop(stopped));
+        GAME_EXPECT(stopped.index == TweenHandle::INVALID_INDEX);
+        GAME_EXPECT(!engine.stop(stopped));
+        engine.update(sf::seconds(0.1f));
+        GAME_EXPECT_NEAR(registry.get<CLocalTransform>(entity).getPosition().x, 5.f, 1e-4f);
+        GAME_EXPECT(completedTweenCount == 0);
+
+        // the handles given out before clear() must not match the tweens started after it.
+        const auto stale = engine.start(entity, spec);
+        engine.clear();
+        GAME_EXPECT(!engine.isRunning(stale));
+        GAME_EXPECT(engine.getRunningCount() == 0);
+
+        const auto fresh = engine.start(entity, spec);
+        GAME_EXPECT(fresh.index == stale.index);
+        GAME_EXPECT(fresh.generation != stale.generation);
+        auto staleCopy = stale;
+        GAME_EXPECT(!engine.stop(staleCopy));
+        GAME_EXPECT(engine.isRunning(fresh));
+
+        engine.update(sf::seconds(0.2f));
+        GAME_EXPECT(!engine.isRunning(fresh));
+        GAME_EXPECT(completedTweenCount == 1);
+        GAME_EXPECT(registry.get<CLocalTransform>(entity).getPosition().x == 10.f);
+
+        // dropped once its entity is gone, without the completion callback.
+        const auto orphan = engine.start(entity, spec);
+        SceneTreeUtils::unmount(entity);
+        engine.update(sf::seconds(0.2f));
+        GAME_EXPECT(!engine.isRunning(orphan));
+        GAME_EXPECT(completedTweenCount == 1);
+        SScenePositionUpdateSystem::update();
+    }
+} // game::test
+
+inline void testTweens() {
+    game::test::testTweenEasing();
+    game::test::testTweenStop();
+}
+
+#endif //TWEENTESTS_HPP